@@ -110,41 +110,45 @@ int mmdeploy_classifier_apply_async(mmdeploy_classifier_t classifier, mmdeploy_s
   return mmdeploy_pipeline_apply_async((mmdeploy_pipeline_t)classifier, input, output);
 }
 
-int mmdeploy_classifier_get_result(mmdeploy_value_t output, mmdeploy_classification_t** results,
-                                   int** result_count) {
+namespace {
+
+// the results are placed in `buffer` when it's not null, or else they own the memory
+int GetResult(mmdeploy_value_t output, mmdeploy_result_buffer_t buffer,
+              mmdeploy_classification_t** results, int** result_count) {
   if (!output || !results || !result_count) {
     return MMDEPLOY_E_INVALID_ARG;
   }
   try {
     Value& value = Cast(output)->front();
-
     auto classify_outputs = from_value<vector<mmcls::ClassifyOutput>>(value);
 
-    vector<int> _result_count;
-    _result_count.reserve(classify_outputs.size());
-
-    for (const auto& cls_output : classify_outputs) {
-      _result_count.push_back((int)cls_output.labels.size());
+    size_t total = 0;
+    for (const auto& output_item : classify_outputs) {
+      total += output_item.labels.size();
     }
 
-    auto total = std::accumulate(begin(_result_count), end(_result_count), 0);
-
-    std::unique_ptr<int[]> result_count_data(new int[_result_count.size()]{});
-    std::copy(_result_count.begin(), _result_count.end(), result_count_data.get());
-
-    std::unique_ptr<mmdeploy_classification_t[]> result_data(
-        new mmdeploy_classification_t[total]{});
-    auto result_ptr = result_data.get();
-    for (const auto& cls_output : classify_outputs) {
-      for (const auto& label : cls_output.labels) {
+    // the results come first, they are released by their address
+    ResultArena arena;
+    arena.Reserve<mmdeploy_classification_t>(total);
+    arena.Reserve<int>(classify_outputs.size());
+    arena.Allocate(buffer);
+    auto result_data = arena.Take<mmdeploy_classification_t>(total);
+    auto result_count_data = arena.Take<int>(classify_outputs.size());
+
+    auto result_ptr = result_data;
+    for (size_t i = 0; i < classify_outputs.size(); ++i) {
+      const auto& output_item = classify_outputs[i];
+      result_count_data[i] = static_cast<int>(output_item.labels.size());
+      for (const auto& label : output_item.labels) {
         result_ptr->label_id = label.label_id;
         result_ptr->score = label.score;
         ++result_ptr;
       }
     }
 
-    *result_count = result_count_data.release();
-    *results = result_data.release();
+    arena.Detach();
+    *result_count = result_count_data;
+    *results = result_data;
 
     return MMDEPLOY_SUCCESS;
   } catch (const std::exception& e) {
@@ -155,10 +159,41 @@ int mmdeploy_classifier_get_result(mmdeploy_value_t output, mmdeploy_classificat
   return MMDEPLOY_E_FAIL;
 }
 
-void mmdeploy_classifier_release_result(mmdeploy_classification_t* results, const int* result_count,
-                                        int count) {
-  delete[] results;
-  delete[] result_count;
+}  // namespace
+
+int mmdeploy_classifier_get_result(mmdeploy_value_t output, mmdeploy_classification_t** results,
+                                   int** result_count) {
+  return GetResult(output, nullptr, results, result_count);
+}
+
+int mmdeploy_classifier_get_result_with_buffer(mmdeploy_value_t output,
+                                               mmdeploy_result_buffer_t buffer,
+                                               mmdeploy_classification_t** results,
+                                               int** result_count) {
+  if (!buffer) {
+    return MMDEPLOY_E_INVALID_ARG;
+  }
+  return GetResult(output, buffer, results, result_count);
+}
+
+int mmdeploy_classifier_apply_with_buffer(mmdeploy_classifier_t classifier,
+                                          const mmdeploy_mat_t* mats, int mat_count,
+                                          mmdeploy_result_buffer_t buffer,
+                                          mmdeploy_classification_t** results, int** result_count) {
+  wrapped<mmdeploy_value_t> input;
+  if (auto ec = mmdeploy_classifier_create_input(mats, mat_count, input.ptr())) {
+    return ec;
+  }
+  wrapped<mmdeploy_value_t> output;
+  if (auto ec = mmdeploy_classifier_apply_v2(classifier, input, output.ptr())) {
+    return ec;
+  }
+  return mmdeploy_classifier_get_result_with_buffer(output, buffer, results, result_count);
+}
+
+void mmdeploy_classifier_release_result(mmdeploy_classification_t* results,
+                                        const int* /*result_count*/, int /*count*/) {
+  ResultArena::Release(results);
 }
 
 void mmdeploy_classifier_destroy(mmdeploy_classifier_t classifier) {
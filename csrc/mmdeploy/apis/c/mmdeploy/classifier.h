@@ -66,11 +66,30 @@ MMDEPLOY_API int mmdeploy_classifier_apply(mmdeploy_classifier_t classifier,
                                            const mmdeploy_mat_t* mats, int mat_count,
                                            mmdeploy_classification_t** results, int** result_count);
 
+/**
+ * @brief Same as \ref mmdeploy_classifier_apply, but the results are placed in \p buffer, which is
+ * reused across calls. The results must not be released, they are valid until \p buffer is used
+ * again or destroyed.
+ * @param[in] classifier classifier's handle created by \ref mmdeploy_classifier_create_by_path
+ * @param[in] mats a batch of images
+ * @param[in] mat_count number of images in the batch
+ * @param[in] buffer result buffer created by \ref mmdeploy_result_buffer_create
+ * @param[out] results a linear buffer to save classification results of each image
+ * @param[out] result_count a linear buffer with length being \p mat_count to save the number of
+ * classification results of each image
+ * @return status of inference
+ */
+MMDEPLOY_API int mmdeploy_classifier_apply_with_buffer(mmdeploy_classifier_t classifier,
+                                                       const mmdeploy_mat_t* mats, int mat_count,
+                                                       mmdeploy_result_buffer_t buffer,
+                                                       mmdeploy_classification_t** results,
+                                                       int** result_count);
+
 /**
  * @brief Release the inference result buffer created \ref mmdeploy_classifier_apply
  * @param[in] results classification results buffer
- * @param[in] result_count \p results size buffer
- * @param[in] count length of \p result_count
+ * @param[in] result_count \p results size buffer, ignored
+ * @param[in] count length of \p result_count, ignored since the buffer is released by \p results
  */
 MMDEPLOY_API void mmdeploy_classifier_release_result(mmdeploy_classification_t* results,
                                                      const int* result_count, int count);
@@ -133,6 +152,15 @@ MMDEPLOY_API int mmdeploy_classifier_get_result(mmdeploy_value_t output,
                                                 mmdeploy_classification_t** results,
                                                 int** result_count);
 
+/**
+ * @brief Same as \ref mmdeploy_classifier_get_result, but the results are placed in \p buffer,
+ * see \ref mmdeploy_classifier_apply_with_buffer
+ */
+MMDEPLOY_API int mmdeploy_classifier_get_result_with_buffer(mmdeploy_value_t output,
+                                                            mmdeploy_result_buffer_t buffer,
+                                                            mmdeploy_classification_t** results,
+                                                            int** result_count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -16,6 +16,16 @@ int mmdeploy_value_destroy(mmdeploy_value_t value) {
   return 0;
 }
 
+int mmdeploy_result_buffer_create(mmdeploy_result_buffer_t* buffer) {
+  if (!buffer) {
+    return MMDEPLOY_E_INVALID_ARG;
+  }
+  *buffer = Guard([] { return Cast(new ResultBuffer()); });  // NOLINT
+  return *buffer ? MMDEPLOY_SUCCESS : MMDEPLOY_E_OUT_OF_MEMORY;
+}
+
+void mmdeploy_result_buffer_destroy(mmdeploy_result_buffer_t buffer) { delete Cast(buffer); }
+
 int mmdeploy_common_create_input(const mmdeploy_mat_t* mats, int mat_count,
                                  mmdeploy_value_t* value) {
   if (mat_count && mats == nullptr) {
@@ -36,3 +46,69 @@ int mmdeploy_common_create_input(const mmdeploy_mat_t* mats, int mat_count,
   }
   return MMDEPLOY_SUCCESS;
 }
+
+int mmdeploy_common_create_input_v2(const mmdeploy_mat_t* mats, int mat_count,
+                                    mmdeploy_mat_deleter_t deleter, void* user_data,
+                                    mmdeploy_value_t* value) {
+  if ((mat_count && mats == nullptr) || !deleter) {
+    return MMDEPLOY_E_INVALID_ARG;
+  }
+  // number of the buffers owned by shared pointers, which release them whatever happens
+  int taken = 0;
+  auto ec = MMDEPLOY_E_INVALID_ARG;
+  if (value) {
+    try {
+      auto input = std::make_unique<Value>(Value{Value::kArray});
+      for (int i = 0; i < mat_count; ++i) {
+        auto data = mats[i].data;
+        ++taken;
+        std::shared_ptr<void> buffer(data, [deleter, user_data](void* p) {
+          deleter(static_cast<uint8_t*>(p), user_data);
+        });
+        mmdeploy::Mat _mat{mats[i].height,         mats[i].width,     PixelFormat(mats[i].format),
+                           DataType(mats[i].type), std::move(buffer), Device{"cpu"}};
+        input->front().push_back({{"ori_img", _mat}});
+      }
+      *value = Cast(input.release());
+      return MMDEPLOY_SUCCESS;
+    } catch (const std::exception& e) {
+      MMDEPLOY_ERROR("unhandled exception: {}", e.what());
+    } catch (...) {
+      MMDEPLOY_ERROR("unknown exception caught");
+    }
+    ec = MMDEPLOY_E_FAIL;
+  }
+  for (int i = taken; i < mat_count; ++i) {
+    deleter(mats[i].data, user_data);
+  }
+  return ec;
+}
+
+int mmdeploy_default_allocator_get_stats(const char* device_name, int device_id,
+                                         mmdeploy_allocator_stats_t* stats) {
+  if (!device_name || !stats) {
+    return MMDEPLOY_E_INVALID_ARG;
+  }
+  try {
+    auto allocator = Allocator::GetDefault(Device(device_name, device_id));
+    if (!allocator) {
+      return MMDEPLOY_E_NOT_SUPPORTED;
+    }
+    auto r = allocator.GetStats();
+    if (!r) {
+      return r.error() == eNotSupported ? MMDEPLOY_E_NOT_SUPPORTED : MMDEPLOY_E_FAIL;
+    }
+    auto& v = r.value();
+    stats->allocation_count = v.allocation_count;
+    stats->upstream_allocation_count = v.upstream_allocation_count;
+    stats->in_use_bytes = v.in_use_bytes;
+    stats->cached_bytes = v.cached_bytes;
+    stats->peak_bytes = v.peak_bytes;
+    return MMDEPLOY_SUCCESS;
+  } catch (const std::exception& e) {
+    MMDEPLOY_ERROR("unhandled exception: {}", e.what());
+  } catch (...) {
+    MMDEPLOY_ERROR("unknown exception caught");
+  }
+  return MMDEPLOY_E_FAIL;
+}
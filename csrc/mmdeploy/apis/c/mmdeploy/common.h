@@ -75,8 +75,29 @@ typedef struct mmdeploy_point_t {
   float y;
 } mmdeploy_point_t;
 
+typedef struct mmdeploy_allocator_stats_t {
+  // allocations requested from the allocator
+  uint64_t allocation_count;
+  // allocations that missed the cache of the allocator
+  uint64_t upstream_allocation_count;
+  // size of the blocks in use
+  uint64_t in_use_bytes;
+  // size of the freed blocks kept for reuse
+  uint64_t cached_bytes;
+  // peak size of the memory held by the allocator
+  uint64_t peak_bytes;
+} mmdeploy_allocator_stats_t;
+
 typedef struct mmdeploy_value* mmdeploy_value_t;
 
+typedef struct mmdeploy_result_buffer* mmdeploy_result_buffer_t;
+
+/**
+ * @brief Releases the pixel buffer \p data of a \ref mmdeploy_mat_t whose ownership is transferred
+ * to the SDK
+ */
+typedef void (*mmdeploy_mat_deleter_t)(uint8_t* data, void* user_data);
+
 #if __cplusplus
 extern "C" {
 #endif
@@ -85,6 +106,52 @@ MMDEPLOY_API mmdeploy_value_t mmdeploy_value_copy(mmdeploy_value_t value);
 
 MMDEPLOY_API int mmdeploy_value_destroy(mmdeploy_value_t value);
 
+/**
+ * @brief Create a buffer to hold the results of `mmdeploy_xxx_apply_with_buffer`. All the results
+ * of an apply call are placed in a single block of memory, which is reused by the following calls
+ * with the buffer, so that no allocation is made once it's large enough.
+ * @param[out] buffer the created buffer, which must be destroyed by \ref
+ * mmdeploy_result_buffer_destroy
+ * @return status of the operation
+ */
+MMDEPLOY_API int mmdeploy_result_buffer_create(mmdeploy_result_buffer_t* buffer);
+
+/**
+ * @brief Destroy a result buffer, the results held by it are invalidated
+ * @param[in] buffer the buffer created by \ref mmdeploy_result_buffer_create
+ */
+MMDEPLOY_API void mmdeploy_result_buffer_destroy(mmdeploy_result_buffer_t buffer);
+
+/**
+ * @brief Pack a batch of images into a value as the input of `mmdeploy_xxx_apply_v2`, taking the
+ * ownership of their pixel buffers. Unlike `mmdeploy_xxx_create_input`, the buffers may be released
+ * or reused by the caller no more, they are kept alive by the SDK as long as they are referenced
+ * (e.g. by the value, or by the pipeline when no conversion is needed) and released by \p deleter
+ * afterwards.
+ * @param[in] mats a batch of images
+ * @param[in] mat_count number of images in the batch
+ * @param[in] deleter called with the pixel buffer of each image and \p user_data, it's called for
+ * all the buffers before returning when the operation fails
+ * @param[in] user_data passed to \p deleter
+ * @param[out] value the created value
+ * @return status of the operation
+ */
+MMDEPLOY_API int mmdeploy_common_create_input_v2(const mmdeploy_mat_t* mats, int mat_count,
+                                                 mmdeploy_mat_deleter_t deleter, void* user_data,
+                                                 mmdeploy_value_t* value);
+
+/**
+ * @brief Get the counters of the default allocator of a device, which serves the buffers of the
+ * pipelines without an allocator of their own
+ * @param[in] device_name name of the device, e.g. "cpu"
+ * @param[in] device_id id of the device
+ * @param[out] stats the counters since the allocator is created
+ * @return status of the operation, \ref MMDEPLOY_E_NOT_SUPPORTED if the allocator doesn't keep the
+ * counters
+ */
+MMDEPLOY_API int mmdeploy_default_allocator_get_stats(const char* device_name, int device_id,
+                                                      mmdeploy_allocator_stats_t* stats);
+
 #if __cplusplus
 }
 #endif
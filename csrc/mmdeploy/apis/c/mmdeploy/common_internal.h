@@ -3,6 +3,12 @@
 #ifndef MMDEPLOY_CSRC_APIS_C_COMMON_INTERNAL_H_
 #define MMDEPLOY_CSRC_APIS_C_COMMON_INTERNAL_H_
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <vector>
+
 #include "common.h"
 #include "handle.h"
 #include "mmdeploy/core/value.h"
@@ -13,6 +19,8 @@ using namespace mmdeploy;
 
 namespace {
 
+using ResultBuffer = std::vector<std::max_align_t>;
+
 inline mmdeploy_value_t Cast(Value* s) { return reinterpret_cast<mmdeploy_value_t>(s); }
 
 inline Value* Cast(mmdeploy_value_t s) { return reinterpret_cast<Value*>(s); }
@@ -37,6 +45,20 @@ mmdeploy_model_t Cast(Model* model) { return reinterpret_cast<mmdeploy_model_t>(
 
 Model* Cast(mmdeploy_model_t model) { return reinterpret_cast<Model*>(model); }
 
+inline mmdeploy_result_buffer_t Cast(ResultBuffer* buffer) {
+  return reinterpret_cast<mmdeploy_result_buffer_t>(buffer);
+}
+
+inline ResultBuffer* Cast(mmdeploy_result_buffer_t buffer) {
+  return reinterpret_cast<ResultBuffer*>(buffer);
+}
+
+// the error codes of the C API are a prefix of `ErrorCode`, the others are reported as failures
+inline int ToStatus(ErrorCode ec) {
+  auto status = static_cast<int>(ec);
+  return status >= MMDEPLOY_SUCCESS && status <= MMDEPLOY_E_FAIL ? status : MMDEPLOY_E_FAIL;
+}
+
 template <typename F>
 std::invoke_result_t<F> Guard(F f) {
   try {
@@ -90,6 +112,59 @@ class wrapped<T, std::void_t<decltype(Cast(T{}))> > {
   T v_;
 };
 
+// Lays out the result arrays of an apply call in a single zeroed block of memory. The sizes of the
+// arrays are reserved first, then the arrays are taken from the block in the same order. The block
+// is either owned by the results, i.e. released by `Release` with the address of the first array,
+// or by a result buffer which reuses it for the following calls.
+class ResultArena {
+ public:
+  template <typename T>
+  void Reserve(size_t count) {
+    size_ = Align(size_, alignof(T)) + count * sizeof(T);
+  }
+
+  // the block is taken from `buffer` when it's not null
+  void Allocate(mmdeploy_result_buffer_t buffer) {
+    auto count = std::max<size_t>((size_ + sizeof(Block) - 1) / sizeof(Block), 1);
+    if (buffer) {
+      auto& storage = *Cast(buffer);
+      if (storage.size() < count) {
+        storage = ResultBuffer(count);
+      }
+      base_ = storage.data();
+    } else {
+      owned_.reset(new Block[count]);
+      base_ = owned_.get();
+    }
+    std::memset(base_, 0, count * sizeof(Block));
+  }
+
+  template <typename T>
+  T* Take(size_t count) {
+    offset_ = Align(offset_, alignof(T));
+    auto p = reinterpret_cast<T*>(reinterpret_cast<char*>(base_) + offset_);
+    offset_ += count * sizeof(T);
+    return p;
+  }
+
+  // hands the block over to the results, it's released with the arena otherwise
+  void Detach() { owned_.release(); }
+
+  static void Release(void* results) { delete[] static_cast<Block*>(results); }
+
+ private:
+  using Block = std::max_align_t;
+
+  static size_t Align(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+
+  size_t size_{};
+  size_t offset_{};
+  Block* base_{};
+  std::unique_ptr<Block[]> owned_;
+};
+
 }  // namespace
 
 MMDEPLOY_API int mmdeploy_common_create_input(const mmdeploy_mat_t* mats, int mat_count,
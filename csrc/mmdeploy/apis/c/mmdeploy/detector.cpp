@@ -54,6 +54,81 @@ int mmdeploy_detector_create_impl(mmdeploy_model_t model, const char* device_nam
                                   (mmdeploy_pipeline_t*)detector);
 }
 
+// The masks are either copied or referenced, i.e. `data` points into the mask of `output`. The
+// results are placed in `buffer` when it's not null, or else they own the memory.
+int GetResult(mmdeploy_value_t output, mmdeploy_result_buffer_t buffer,
+              mmdeploy_detection_t** results, int** result_count, bool copy_masks) {
+  if (!output || !results || !result_count) {
+    return MMDEPLOY_E_INVALID_ARG;
+  }
+  try {
+    Value& value = Cast(output)->front();
+    auto detector_outputs = from_value<vector<mmdet::DetectorOutput>>(value);
+
+    size_t total = 0;
+    size_t mask_count = 0;
+    size_t mask_bytes = 0;
+    for (const auto& det_output : detector_outputs) {
+      total += det_output.detections.size();
+      for (const auto& detection : det_output.detections) {
+        if (auto size = detection.mask.byte_size()) {
+          ++mask_count;
+          mask_bytes += size;
+        }
+      }
+    }
+
+    // the detections come first, the results are released by their address
+    ResultArena arena;
+    arena.Reserve<mmdeploy_detection_t>(total);
+    arena.Reserve<int>(detector_outputs.size());
+    arena.Reserve<mmdeploy_instance_mask_t>(mask_count);
+    arena.Reserve<char>(copy_masks ? mask_bytes : 0);
+    arena.Allocate(buffer);
+    auto result_data = arena.Take<mmdeploy_detection_t>(total);
+    auto result_count_data = arena.Take<int>(detector_outputs.size());
+    auto mask_ptr = arena.Take<mmdeploy_instance_mask_t>(mask_count);
+    auto mask_data = arena.Take<char>(copy_masks ? mask_bytes : 0);
+
+    auto result_ptr = result_data;
+    for (size_t i = 0; i < detector_outputs.size(); ++i) {
+      const auto& detections = detector_outputs[i].detections;
+      result_count_data[i] = static_cast<int>(detections.size());
+      for (const auto& detection : detections) {
+        result_ptr->label_id = detection.label_id;
+        result_ptr->score = detection.score;
+        const auto& bbox = detection.bbox;
+        result_ptr->bbox = {bbox[0], bbox[1], bbox[2], bbox[3]};
+        auto mask_byte_size = detection.mask.byte_size();
+        if (mask_byte_size) {
+          auto& mask = detection.mask;
+          result_ptr->mask = mask_ptr++;
+          result_ptr->mask->width = mask.width();
+          result_ptr->mask->height = mask.height();
+          if (copy_masks) {
+            result_ptr->mask->data = mask_data;
+            mask_data = std::copy_n(mask.data<char>(), mask_byte_size, mask_data);
+          } else {
+            result_ptr->mask->data = mask.data<char>();
+          }
+        }
+        ++result_ptr;
+      }
+    }
+
+    arena.Detach();
+    *result_count = result_count_data;
+    *results = result_data;
+
+    return MMDEPLOY_SUCCESS;
+  } catch (const std::exception& e) {
+    MMDEPLOY_ERROR("unhandled exception: {}", e.what());
+  } catch (...) {
+    MMDEPLOY_ERROR("unknown exception caught");
+  }
+  return MMDEPLOY_E_FAIL;
+}
+
 }  // namespace
 
 int mmdeploy_detector_create(mmdeploy_model_t model, const char* device_name, int device_id,
@@ -99,6 +174,20 @@ int mmdeploy_detector_apply(mmdeploy_detector_t detector, const mmdeploy_mat_t*
   return MMDEPLOY_SUCCESS;
 }
 
+int mmdeploy_detector_apply_with_buffer(mmdeploy_detector_t detector, const mmdeploy_mat_t* mats,
+                                        int mat_count, mmdeploy_result_buffer_t buffer,
+                                        mmdeploy_detection_t** results, int** result_count) {
+  wrapped<mmdeploy_value_t> input;
+  if (auto ec = mmdeploy_detector_create_input(mats, mat_count, input.ptr())) {
+    return ec;
+  }
+  wrapped<mmdeploy_value_t> output;
+  if (auto ec = mmdeploy_detector_apply_v2(detector, input, output.ptr())) {
+    return ec;
+  }
+  return mmdeploy_detector_get_result_with_buffer(output, buffer, results, result_count);
+}
+
 int mmdeploy_detector_apply_v2(mmdeploy_detector_t detector, mmdeploy_value_t input,
                                mmdeploy_value_t* output) {
   return mmdeploy_pipeline_apply((mmdeploy_pipeline_t)detector, input, output);
@@ -111,78 +200,31 @@ int mmdeploy_detector_apply_async(mmdeploy_detector_t detector, mmdeploy_sender_
 
 int mmdeploy_detector_get_result(mmdeploy_value_t output, mmdeploy_detection_t** results,
                                  int** result_count) {
-  if (!output || !results || !result_count) {
-    return MMDEPLOY_E_INVALID_ARG;
-  }
-  try {
-    Value& value = Cast(output)->front();
-    auto detector_outputs = from_value<vector<mmdet::DetectorOutput>>(value);
-
-    vector<int> _result_count;
-    _result_count.reserve(detector_outputs.size());
-    for (const auto& det_output : detector_outputs) {
-      _result_count.push_back((int)det_output.detections.size());
-    }
-    auto total = std::accumulate(_result_count.begin(), _result_count.end(), 0);
-
-    std::unique_ptr<int[]> result_count_data(new int[_result_count.size()]{});
-    auto result_count_ptr = result_count_data.get();
-    std::copy(_result_count.begin(), _result_count.end(), result_count_data.get());
-
-    auto deleter = [&](mmdeploy_detection_t* p) {
-      mmdeploy_detector_release_result(p, result_count_ptr, (int)detector_outputs.size());
-    };
-    std::unique_ptr<mmdeploy_detection_t[], decltype(deleter)> result_data(
-        new mmdeploy_detection_t[total]{}, deleter);
-    // ownership transferred to result_data
-    result_count_data.release();
-
-    auto result_ptr = result_data.get();
-
-    for (const auto& det_output : detector_outputs) {
-      for (const auto& detection : det_output.detections) {
-        result_ptr->label_id = detection.label_id;
-        result_ptr->score = detection.score;
-        const auto& bbox = detection.bbox;
-        result_ptr->bbox = {bbox[0], bbox[1], bbox[2], bbox[3]};
-        auto mask_byte_size = detection.mask.byte_size();
-        if (mask_byte_size) {
-          auto& mask = detection.mask;
-          result_ptr->mask = new mmdeploy_instance_mask_t{};
-          result_ptr->mask->data = new char[mask_byte_size];
-          result_ptr->mask->width = mask.width();
-          result_ptr->mask->height = mask.height();
-          std::copy(mask.data<char>(), mask.data<char>() + mask_byte_size, result_ptr->mask->data);
-        }
-        ++result_ptr;
-      }
-    }
+  return GetResult(output, nullptr, results, result_count, true);
+}
 
-    *result_count = result_count_ptr;
-    *results = result_data.release();
+int mmdeploy_detector_get_result_view(mmdeploy_value_t output, mmdeploy_detection_t** results,
+                                      int** result_count) {
+  return GetResult(output, nullptr, results, result_count, false);
+}
 
-    return MMDEPLOY_SUCCESS;
-  } catch (const std::exception& e) {
-    MMDEPLOY_ERROR("unhandled exception: {}", e.what());
-  } catch (...) {
-    MMDEPLOY_ERROR("unknown exception caught");
+int mmdeploy_detector_get_result_with_buffer(mmdeploy_value_t output,
+                                             mmdeploy_result_buffer_t buffer,
+                                             mmdeploy_detection_t** results, int** result_count) {
+  if (!buffer) {
+    return MMDEPLOY_E_INVALID_ARG;
   }
-  return MMDEPLOY_E_FAIL;
+  return GetResult(output, buffer, results, result_count, true);
 }
 
-void mmdeploy_detector_release_result(mmdeploy_detection_t* results, const int* result_count,
-                                      int count) {
-  auto result_ptr = results;
-  for (int i = 0; i < count; ++i) {
-    for (int j = 0; j < result_count[i]; ++j, ++result_ptr) {
-      if (result_ptr->mask) {
-        delete[] result_ptr->mask->data;
-        delete result_ptr->mask;
-      }
-    }
-  }
-  delete[] results;
-  delete[] result_count;
+void mmdeploy_detector_release_result(mmdeploy_detection_t* results,
+                                      const int* /*result_count*/, int /*count*/) {
+  ResultArena::Release(results);
+}
+
+void mmdeploy_detector_release_result_view(mmdeploy_detection_t* results,
+                                           const int* /*result_count*/, int /*count*/) {
+  ResultArena::Release(results);
 }
 
 void mmdeploy_detector_destroy(mmdeploy_detector_t detector) {
@@ -72,12 +72,31 @@ MMDEPLOY_API int mmdeploy_detector_apply(mmdeploy_detector_t detector, const mmd
 
 /** @brief Release the inference result buffer created by \ref mmdeploy_detector_apply
  * @param[in] results detection results buffer
- * @param[in] result_count  \p results size buffer
- * @param[in] count length of \p result_count
+ * @param[in] result_count  \p results size buffer, ignored
+ * @param[in] count length of \p result_count, ignored since the buffer is released by \p results
  */
 MMDEPLOY_API void mmdeploy_detector_release_result(mmdeploy_detection_t* results,
                                                    const int* result_count, int count);
 
+/**
+ * @brief Same as \ref mmdeploy_detector_apply, but the results are placed in \p buffer, which is
+ * reused across calls. The results must not be released, they are valid until \p buffer is used
+ * again or destroyed.
+ * @param[in] detector detector's handle created by \ref mmdeploy_detector_create_by_path
+ * @param[in] mats a batch of images
+ * @param[in] mat_count number of images in the batch
+ * @param[in] buffer result buffer created by \ref mmdeploy_result_buffer_create
+ * @param[out] results a linear buffer to save detection results of each image
+ * @param[out] result_count a linear buffer with length being \p mat_count to save the number of
+ * detection results of each image
+ * @return status of inference
+ */
+MMDEPLOY_API int mmdeploy_detector_apply_with_buffer(mmdeploy_detector_t detector,
+                                                     const mmdeploy_mat_t* mats, int mat_count,
+                                                     mmdeploy_result_buffer_t buffer,
+                                                     mmdeploy_detection_t** results,
+                                                     int** result_count);
+
 /**
  * @brief Destroy detector's handle
  * @param[in] detector detector's handle created by \ref mmdeploy_detector_create_by_path
@@ -133,6 +152,38 @@ MMDEPLOY_API int mmdeploy_detector_apply_async(mmdeploy_detector_t detector,
 MMDEPLOY_API int mmdeploy_detector_get_result(mmdeploy_value_t output,
                                               mmdeploy_detection_t** results, int** result_count);
 
+/**
+ * @brief Same as \ref mmdeploy_detector_get_result, but the results are placed in \p buffer, see
+ * \ref mmdeploy_detector_apply_with_buffer
+ */
+MMDEPLOY_API int mmdeploy_detector_get_result_with_buffer(mmdeploy_value_t output,
+                                                          mmdeploy_result_buffer_t buffer,
+                                                          mmdeploy_detection_t** results,
+                                                          int** result_count);
+
+/**
+ * @brief Same as \ref mmdeploy_detector_get_result, but the masks are not copied. `mask->data` of
+ * the results points into \p output, which must not be destroyed before the results are released.
+ * @param[in] output output obtained by applying a detector
+ * @param[out] results a linear buffer to save detection results of each image. It must be released
+ * by \ref mmdeploy_detector_release_result_view
+ * @param[out] result_count a linear buffer with length number of input images to save the number of
+ * detection results of each image. Must be released by \ref
+ * mmdeploy_detector_release_result_view
+ * @return status of the operation
+ */
+MMDEPLOY_API int mmdeploy_detector_get_result_view(mmdeploy_value_t output,
+                                                   mmdeploy_detection_t** results,
+                                                   int** result_count);
+
+/** @brief Release the result buffer created by \ref mmdeploy_detector_get_result_view
+ * @param[in] results detection results buffer
+ * @param[in] result_count  \p results size buffer, ignored
+ * @param[in] count length of \p result_count, ignored since the buffer is released by \p results
+ */
+MMDEPLOY_API void mmdeploy_detector_release_result_view(mmdeploy_detection_t* results,
+                                                        const int* result_count, int count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,6 +5,7 @@
 #include "common.h"
 #include "common_internal.h"
 #include "executor_internal.h"
+#include "mmdeploy/core/graph.h"
 #include "mmdeploy/execution/when_all_value.h"
 
 using namespace mmdeploy;
@@ -53,6 +54,10 @@ mmdeploy_scheduler_t mmdeploy_executor_create_thread_pool(int num_threads) {
   return CreateScheduler("ThreadPool", {{"num_threads", num_threads}});
 }
 
+mmdeploy_scheduler_t mmdeploy_executor_create_work_stealing_thread_pool(int num_threads) {
+  return CreateScheduler("WorkStealingThreadPool", {{"num_threads", num_threads}});
+}
+
 mmdeploy_scheduler_t mmdeploy_executor_create_thread() { return CreateScheduler("SingleThread"); }
 
 mmdeploy_scheduler_t mmdeploy_executor_dynamic_batch(mmdeploy_scheduler_t scheduler,
@@ -65,6 +70,48 @@ mmdeploy_scheduler_t mmdeploy_executor_dynamic_batch(mmdeploy_scheduler_t schedu
       {{"scheduler", *Cast(scheduler)}, {"max_batch_size", max_batch_size}, {"timeout", timeout}});
 }
 
+mmdeploy_scheduler_t mmdeploy_executor_adaptive_dynamic_batch(mmdeploy_scheduler_t scheduler,
+                                                              int max_batch_size, int max_timeout,
+                                                              int latency_slo) {
+  if (!scheduler) {
+    return nullptr;
+  }
+  return CreateScheduler("DynamicBatch", {{"scheduler", *Cast(scheduler)},
+                                          {"max_batch_size", max_batch_size},
+                                          {"timeout", max_timeout},
+                                          {"latency_slo", latency_slo}});
+}
+
+int mmdeploy_executor_dynamic_batch_stats(mmdeploy_scheduler_t scheduler,
+                                          mmdeploy_value_t* stats) {
+  if (!scheduler || !stats) {
+    return MMDEPLOY_E_INVALID_ARG;
+  }
+  try {
+    auto s = GetDynamicBatchStats(*Cast(scheduler));
+    if (!s) {
+      MMDEPLOY_ERROR("not a dynamic batch scheduler");
+      return MMDEPLOY_E_NOT_SUPPORTED;
+    }
+    Value::Array histogram(s->batch_size_histogram.begin(), s->batch_size_histogram.end());
+    *stats = Take(Value{{"batch_count", s->batch_count},
+                        {"full_submits", s->full_submits},
+                        {"timeouts", s->timeouts},
+                        {"batch_size_histogram", std::move(histogram)},
+                        {"wait_time", s->wait_time},
+                        {"execution_time", s->execution_time},
+                        {"timeout", s->timeout},
+                        {"request_interval", s->request_interval},
+                        {"batch_execution_time", s->batch_execution_time}});
+    return MMDEPLOY_SUCCESS;
+  } catch (const std::exception& e) {
+    MMDEPLOY_ERROR("exception caught: {}", e.what());
+  } catch (...) {
+    MMDEPLOY_ERROR("unknown exception caught");
+  }
+  return MMDEPLOY_E_FAIL;
+}
+
 int mmdeploy_scheduler_destroy(mmdeploy_scheduler_t scheduler) {
   delete Cast(scheduler);
   return 0;
@@ -115,6 +162,10 @@ mmdeploy_sender_t mmdeploy_executor_then(mmdeploy_sender_t input, mmdeploy_then_
   }
   return Guard([&] {
     return Take(Then(Take(input), [fn, context](Value args) {
+      // `fn` is skipped by failures of the upstream nodes, which are passed to the consumer
+      if (graph::FindError(args)) {
+        return args;
+      }
       auto out = Cast(fn(Take(std::move(args)), context));
       Value ret(std::move(*out));
       delete out;
@@ -130,6 +181,9 @@ mmdeploy_sender_t mmdeploy_executor_let_value(mmdeploy_sender_t input, mmdeploy_
   }
   return Guard([&] {
     return Take(LetValue(Take(input), [fn, context](Value& args) {
+      if (graph::FindError(args)) {
+        return SenderType(Just(std::move(args)));
+      }
       auto out = Cast(fn(Cast(&args), context));
       SenderType ret(std::move(*out));
       delete out;
@@ -155,8 +209,15 @@ mmdeploy_sender_t mmdeploy_executor_when_all(mmdeploy_sender_t inputs[], int32_t
     for (int i = 0; i < n; ++i) {
       senders.emplace_back(Take(inputs[i]));
     }
-    return Take(
-        Then(WhenAll(std::move(senders)), [](Value::Array&& v) { return Value(std::move(v)); }));
+    return Take(Then(WhenAll(std::move(senders)), [](Value::Array&& v) {
+      // the first failure of the inputs fails the whole
+      for (const auto& x : v) {
+        if (auto error = graph::FindError(x)) {
+          return Value(*error);
+        }
+      }
+      return Value(std::move(v));
+    }));
   });
 }
 
@@ -172,7 +233,12 @@ int mmdeploy_executor_start_detached(mmdeploy_sender_t input) {
     return MMDEPLOY_E_INVALID_ARG;
   }
   try {
-    StartDetached(Take(input));
+    StartDetached(Then(Take(input), [](const Value& output) {
+      // there is no consumer to report to
+      if (auto error = graph::FindError(output)) {
+        MMDEPLOY_ERROR("detached work failed: {}", to_string(error->ec));
+      }
+    }));
     return 0;
   } catch (...) {
   }
@@ -183,23 +249,36 @@ mmdeploy_value_t mmdeploy_executor_sync_wait(mmdeploy_sender_t input) {
   if (!input) {
     return nullptr;
   }
-  return Guard([&] { return Take(std::get<Value>(SyncWait(Take(input)))); });
+  return Guard([&] {
+    auto output = std::get<Value>(SyncWait(Take(input)));
+    // failures of asynchronous nodes are raised here on the waiting thread
+    graph::ThrowIfError(output);
+    return Take(std::move(output));
+  });
 }
 
 int mmdeploy_executor_sync_wait_v2(mmdeploy_sender_t sender, mmdeploy_value_t* value) {
   if (!sender) {
     return MMDEPLOY_E_INVALID_ARG;
   }
-  auto result = mmdeploy_executor_sync_wait(sender);
-  if (!result) {
-    return MMDEPLOY_E_FAIL;
-  }
-  if (value) {
-    *value = result;
-  } else {
-    mmdeploy_value_destroy(result);
+  try {
+    auto output = std::get<Value>(SyncWait(Take(sender)));
+    if (auto error = graph::FindError(output)) {
+      return ToStatus(error->ec);
+    }
+    if (value) {
+      *value = Take(std::move(output));
+    }
+    return MMDEPLOY_SUCCESS;
+  } catch (const Exception& e) {
+    MMDEPLOY_ERROR("exception caught: {}", e.what());
+    return ToStatus(e.code().value().ec);
+  } catch (const std::exception& e) {
+    MMDEPLOY_ERROR("exception caught: {}", e.what());
+  } catch (...) {
+    MMDEPLOY_ERROR("unknown exception caught");
   }
-  return MMDEPLOY_SUCCESS;
+  return MMDEPLOY_E_FAIL;
 }
 
 void mmdeploy_executor_execute(mmdeploy_scheduler_t scheduler, void (*fn)(void*), void* context) {
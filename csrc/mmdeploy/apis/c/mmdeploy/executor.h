@@ -48,11 +48,46 @@ MMDEPLOY_API mmdeploy_scheduler_t mmdeploy_executor_system_pool();
  */
 MMDEPLOY_API mmdeploy_scheduler_t mmdeploy_executor_create_thread_pool(int num_threads);
 
+/**
+ * Create a work-stealing thread pool with the given number of worker threads. Each worker owns a
+ * lock-free deque, tasks scheduled from inside the pool (e.g. by Bulk) stay on the local worker
+ * unless stolen by idle ones
+ * @param[in] num_threads
+ * @return the handle to the created thread pool
+ */
+MMDEPLOY_API mmdeploy_scheduler_t
+mmdeploy_executor_create_work_stealing_thread_pool(int num_threads);
+
 MMDEPLOY_API mmdeploy_scheduler_t mmdeploy_executor_create_thread();
 
 MMDEPLOY_API mmdeploy_scheduler_t mmdeploy_executor_dynamic_batch(mmdeploy_scheduler_t scheduler,
                                                                   int max_batch_size, int timeout);
 
+/**
+ * Create a dynamic batch scheduler whose wait window adapts to the request rate and the measured
+ * batch execution time to meet a latency target
+ * @param[in] scheduler scheduler to execute the batches on
+ * @param[in] max_batch_size
+ * @param[in] max_timeout upper bound of the wait window, in microseconds
+ * @param[in] latency_slo latency target of a request, in microseconds
+ * @return the handle to the created scheduler
+ */
+MMDEPLOY_API mmdeploy_scheduler_t mmdeploy_executor_adaptive_dynamic_batch(
+    mmdeploy_scheduler_t scheduler, int max_batch_size, int max_timeout, int latency_slo);
+
+/**
+ * Get the counters of a dynamic batch scheduler
+ * @param[in] scheduler handle created by \ref mmdeploy_executor_dynamic_batch or
+ * \ref mmdeploy_executor_adaptive_dynamic_batch
+ * @param[out] stats an object of {"batch_count", "full_submits", "timeouts",
+ * "batch_size_histogram", "wait_time", "execution_time", "timeout", "request_interval",
+ * "batch_execution_time"}, times are in microseconds. It must be destroyed by
+ * \ref mmdeploy_value_destroy
+ * @return status code of the operation
+ */
+MMDEPLOY_API int mmdeploy_executor_dynamic_batch_stats(mmdeploy_scheduler_t scheduler,
+                                                       mmdeploy_value_t* stats);
+
 MMDEPLOY_API int mmdeploy_scheduler_destroy(mmdeploy_scheduler_t scheduler);
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -111,9 +146,25 @@ MMDEPLOY_API mmdeploy_sender_t mmdeploy_executor_transfer(mmdeploy_sender_t inpu
 MMDEPLOY_API mmdeploy_sender_t mmdeploy_executor_on(mmdeploy_scheduler_t scheduler,
                                                     mmdeploy_sender_t input);
 
+/**
+ * Transform the value sent by the input sender with `fn`. A failure of the pipelines upstream skips
+ * `fn` and is passed on to the consumer of the returned sender
+ * @param[in] input
+ * @param[in] fn
+ * @param[in] context
+ * @return the sender created
+ */
 MMDEPLOY_API mmdeploy_sender_t mmdeploy_executor_then(mmdeploy_sender_t input,
                                                       mmdeploy_then_fn_t fn, void* context);
 
+/**
+ * Continue with the sender returned by `fn`. Like \ref mmdeploy_executor_then, `fn` is skipped by a
+ * failure of the pipelines upstream
+ * @param[in] input
+ * @param[in] fn
+ * @param[in] context
+ * @return the sender created
+ */
 MMDEPLOY_API mmdeploy_sender_t mmdeploy_executor_let_value(mmdeploy_sender_t input,
                                                            mmdeploy_let_value_fn_t fn,
                                                            void* context);
@@ -133,10 +184,26 @@ MMDEPLOY_API mmdeploy_sender_t mmdeploy_executor_ensure_started(mmdeploy_sender_
 ///////////////////////////////////////////////////////////////////////////////
 // Sender consumers
 ///////////////////////////////////////////////////////////////////////////////
+/**
+ * Start the work of a sender without waiting for it, a failure of the work is only logged
+ * @param[in] input
+ * @return status code of the operation
+ */
 MMDEPLOY_API int mmdeploy_executor_start_detached(mmdeploy_sender_t input);
 
+/**
+ * Wait for the value sent by a sender
+ * @param[in] input
+ * @return the value sent, or nullptr if the work failed
+ */
 MMDEPLOY_API mmdeploy_value_t mmdeploy_executor_sync_wait(mmdeploy_sender_t input);
 
+/**
+ * Wait for the value sent by a sender
+ * @param[in] input
+ * @param[out] output the value sent, it's optional
+ * @return status code of the work, e.g. the error of the failing node of a pipeline
+ */
 MMDEPLOY_API int mmdeploy_executor_sync_wait_v2(mmdeploy_sender_t input, mmdeploy_value_t* output);
 
 MMDEPLOY_API void mmdeploy_executor_execute(mmdeploy_scheduler_t scheduler, void (*fn)(void*),
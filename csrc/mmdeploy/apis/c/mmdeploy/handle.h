@@ -3,10 +3,12 @@
 #ifndef MMDEPLOY_SRC_APIS_C_HANDLE_H_
 #define MMDEPLOY_SRC_APIS_C_HANDLE_H_
 
+#include <algorithm>
 #include <memory>
 
 #include "mmdeploy/core/device.h"
 #include "mmdeploy/core/graph.h"
+#include "mmdeploy/core/profiler.h"
 #include "mmdeploy/core/value.h"
 #include "mmdeploy/graph/pipeline.h"
 
@@ -20,6 +22,22 @@ class AsyncHandle {
     device_ = Device(device_name, device_id);
     stream_ = Stream(device_);
     config["context"].update({{"device", device_}, {"stream", stream_}});
+    // e.g. {"allocator": {"type": "arena", "max_cached_bytes": 67108864}}, shared by all the
+    // modules of the pipeline
+    if (auto& context = config["context"]; context.contains("allocator")) {
+      context["allocator"] = Allocator(device_, context["allocator"]);
+    }
+    // the profiler is created here instead of by the pipeline so that its statistics are reachable
+    // from the handle, e.g. by the streams of the pipeline
+    if (auto& context = config["context"]; !context.contains("profiler")) {
+      if (auto profiler = Profiler::FromConfig(config)) {
+        context["profiler"] = profiler;
+      }
+    }
+    profiler_ = config["context"].value("profiler", Profiler{});
+    // e.g. {"request_arena_size": 16384}, block size of the arena the type erased senders &
+    // operations of a synchronous request are allocated from, 0 to allocate them on the heap
+    request_arena_size_ = std::max(0, config["context"].value("request_arena_size", 0));
     auto creator = Registry<graph::Node>::Get().GetCreator("Pipeline");
     if (!creator) {
       MMDEPLOY_ERROR("Failed to find Pipeline creator. Available nodes: {}",
@@ -39,10 +57,15 @@ class AsyncHandle {
 
   Device& device() { return device_; }
   Stream& stream() { return stream_; }
+  const Profiler& profiler() const { return profiler_; }
+  graph::Node& node() { return *pipeline_; }
+  size_t request_arena_size() const { return request_arena_size_; }
 
  private:
   Device device_;
   Stream stream_;
+  Profiler profiler_;
+  size_t request_arena_size_{};
   std::unique_ptr<graph::Node> pipeline_;
 };
 
@@ -7,6 +7,7 @@
 
 #include "mmdeploy/core/logger.h"
 #include "mmdeploy/core/model.h"
+#include "mmdeploy/core/net_cache.h"
 // clang-format on
 
 using namespace mmdeploy;
@@ -38,3 +39,25 @@ int mmdeploy_model_create(const void* buffer, int size, mmdeploy_model_t* model)
 }
 
 void mmdeploy_model_destroy(mmdeploy_model_t model) { delete reinterpret_cast<Model*>(model); }
+
+int mmdeploy_model_warmup(mmdeploy_model_t model, const char* device_name, int device_id) {
+  if (!model || !device_name) {
+    return MMDEPLOY_E_INVALID_ARG;
+  }
+  try {
+    Device device(device_name, device_id);
+    NetCache::Get().Warmup(*reinterpret_cast<Model*>(model), device).value();
+    return MMDEPLOY_SUCCESS;
+  } catch (const std::exception& e) {
+    MMDEPLOY_ERROR("failed to warm up model: {}", e.what());
+  } catch (...) {
+    MMDEPLOY_ERROR("unknown exception caught");
+  }
+  return MMDEPLOY_E_FAIL;
+}
+
+void mmdeploy_model_evict(mmdeploy_model_t model) {
+  if (model) {
+    NetCache::Get().Evict(*reinterpret_cast<Model*>(model));
+  }
+}
@@ -40,6 +40,25 @@ MMDEPLOY_API int mmdeploy_model_create(const void* buffer, int size, mmdeploy_mo
  */
 MMDEPLOY_API void mmdeploy_model_destroy(mmdeploy_model_t model);
 
+/**
+ * @brief Load the nets of a model on a device ahead of time. The handles created later from the
+ * model, or from another model of the same path, on the device share the loaded nets instead of
+ * loading them again. The nets are kept until evicted by \ref mmdeploy_model_evict
+ * @param[in] model sdk model instance
+ * @param[in] device_name name of device, such as "cpu", "cuda", etc.
+ * @param[in] device_id id of device.
+ * @return status code of the operation
+ */
+MMDEPLOY_API int mmdeploy_model_warmup(mmdeploy_model_t model, const char* device_name,
+                                       int device_id);
+
+/**
+ * @brief Release the nets of a model kept by \ref mmdeploy_model_warmup, the nets are still shared
+ * by the existing handles until they are destroyed
+ * @param[in] model sdk model instance
+ */
+MMDEPLOY_API void mmdeploy_model_evict(mmdeploy_model_t model);
+
 #ifdef __cplusplus
 }
 #endif
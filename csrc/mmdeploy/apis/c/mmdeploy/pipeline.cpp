@@ -2,9 +2,22 @@
 
 #include "pipeline.h"
 
+#include <optional>
+
 #include "common_internal.h"
 #include "executor_internal.h"
 #include "handle.h"
+#include "mmdeploy/core/streaming.h"
+
+namespace {
+
+using mmdeploy::graph::StreamingPipeline;
+
+StreamingPipeline* Cast(mmdeploy_pipeline_stream_t stream) {
+  return reinterpret_cast<StreamingPipeline*>(stream);
+}
+
+}  // namespace
 
 int mmdeploy_pipeline_create(mmdeploy_value_t config, const char* device_name, int device_id,
                              mmdeploy_exec_info_t exec_info, mmdeploy_pipeline_t* pipeline) {
@@ -56,6 +69,12 @@ void mmdeploy_pipeline_destroy(mmdeploy_pipeline_t pipeline) {
 
 int mmdeploy_pipeline_apply(mmdeploy_pipeline_t pipeline, mmdeploy_value_t input,
                             mmdeploy_value_t* output) {
+  std::optional<TypeErasedArena> arena;
+  if (pipeline) {
+    if (auto size = Cast(pipeline)->request_arena_size()) {
+      arena.emplace(size);
+    }
+  }
   auto input_sender = mmdeploy_executor_just(input);
   if (!input_sender) {
     return MMDEPLOY_E_FAIL;
@@ -64,10 +83,95 @@ int mmdeploy_pipeline_apply(mmdeploy_pipeline_t pipeline, mmdeploy_value_t input
   if (auto ec = mmdeploy_pipeline_apply_async(pipeline, input_sender, &output_sender)) {
     return ec;
   }
-  auto _output = mmdeploy_executor_sync_wait(output_sender);
-  if (!_output) {
-    return MMDEPLOY_E_FAIL;
+  return mmdeploy_executor_sync_wait_v2(output_sender, output);
+}
+
+int mmdeploy_pipeline_stream_create(mmdeploy_pipeline_t pipeline, int max_in_flight,
+                                    mmdeploy_pipeline_stream_t* stream) {
+  if (!pipeline || max_in_flight <= 0 || !stream) {
+    return MMDEPLOY_E_INVALID_ARG;
+  }
+  try {
+    auto h = Cast(pipeline);
+    auto _stream = std::make_unique<StreamingPipeline>(h->node(), max_in_flight, h->profiler());
+    *stream = reinterpret_cast<mmdeploy_pipeline_stream_t>(_stream.release());
+    return MMDEPLOY_SUCCESS;
+  } catch (const std::exception& e) {
+    MMDEPLOY_ERROR("exception caught: {}", e.what());
+  } catch (...) {
+    MMDEPLOY_ERROR("unknown exception caught");
   }
-  *output = _output;
+  return MMDEPLOY_E_FAIL;
+}
+
+int mmdeploy_pipeline_stream_push(mmdeploy_pipeline_stream_t stream, mmdeploy_value_t input) {
+  if (!stream || !input) {
+    return MMDEPLOY_E_INVALID_ARG;
+  }
+  try {
+    if (auto r = Cast(stream)->Push(*Cast(input)); !r) {
+      return ToStatus(r.error().value().ec);
+    }
+    return MMDEPLOY_SUCCESS;
+  } catch (const std::exception& e) {
+    MMDEPLOY_ERROR("exception caught: {}", e.what());
+  } catch (...) {
+    MMDEPLOY_ERROR("unknown exception caught");
+  }
+  return MMDEPLOY_E_FAIL;
+}
+
+int mmdeploy_pipeline_stream_pop(mmdeploy_pipeline_stream_t stream, mmdeploy_value_t* output,
+                                 int* end_of_stream) {
+  if (!stream || !output || !end_of_stream) {
+    return MMDEPLOY_E_INVALID_ARG;
+  }
+  try {
+    *output = nullptr;
+    auto r = Cast(stream)->Pop();
+    *end_of_stream = !r;
+    if (!r) {
+      return MMDEPLOY_SUCCESS;
+    }
+    if (!*r) {
+      return ToStatus(r->error().value().ec);
+    }
+    *output = Take(std::move(*r).value());
+    return MMDEPLOY_SUCCESS;
+  } catch (const std::exception& e) {
+    MMDEPLOY_ERROR("exception caught: {}", e.what());
+  } catch (...) {
+    MMDEPLOY_ERROR("unknown exception caught");
+  }
+  return MMDEPLOY_E_FAIL;
+}
+
+int mmdeploy_pipeline_stream_close(mmdeploy_pipeline_stream_t stream) {
+  if (!stream) {
+    return MMDEPLOY_E_INVALID_ARG;
+  }
+  Cast(stream)->Close();
   return MMDEPLOY_SUCCESS;
 }
+
+int mmdeploy_pipeline_stream_get_stats(mmdeploy_pipeline_stream_t stream,
+                                       mmdeploy_value_t* stats) {
+  if (!stream || !stats) {
+    return MMDEPLOY_E_INVALID_ARG;
+  }
+  try {
+    *stats = Take(Cast(stream)->GetStats());
+    return MMDEPLOY_SUCCESS;
+  } catch (const std::exception& e) {
+    MMDEPLOY_ERROR("exception caught: {}", e.what());
+  } catch (...) {
+    MMDEPLOY_ERROR("unknown exception caught");
+  }
+  return MMDEPLOY_E_FAIL;
+}
+
+void mmdeploy_pipeline_stream_destroy(mmdeploy_pipeline_stream_t stream) {
+  if (stream != nullptr) {
+    delete Cast(stream);
+  }
+}
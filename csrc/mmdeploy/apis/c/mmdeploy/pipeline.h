@@ -54,6 +54,68 @@ MMDEPLOY_API int mmdeploy_pipeline_apply_async(mmdeploy_pipeline_t pipeline,
  */
 MMDEPLOY_API void mmdeploy_pipeline_destroy(mmdeploy_pipeline_t pipeline);
 
+/******************************************************************************
+ * Streaming APIs, for applying a pipeline to a continuous sequence of inputs such as the frames of
+ * a video. Consecutive frames are processed concurrently, overlapping across the stages of the
+ * pipeline, while their outputs are popped in order. */
+
+typedef struct mmdeploy_pipeline_stream* mmdeploy_pipeline_stream_t;
+
+/**
+ * @brief Create a stream of a pipeline
+ * @param[in] pipeline handle of the pipeline, which must outlive the stream
+ * @param[in] max_in_flight max number of frames pushed but not yet popped, it bounds the memory
+ * held by the stream
+ * @param[out] stream handle of the stream
+ * @return status of the operation
+ */
+MMDEPLOY_API int mmdeploy_pipeline_stream_create(mmdeploy_pipeline_t pipeline, int max_in_flight,
+                                                 mmdeploy_pipeline_stream_t* stream);
+
+/**
+ * @brief Push a frame into the stream, blocks while \p max_in_flight frames are not yet popped
+ * @param[in] stream handle of the stream
+ * @param[in] input input value of the pipeline, it's not consumed by the operation
+ * @return status of the operation, MMDEPLOY_E_INVALID_ARG when the stream is closed
+ */
+MMDEPLOY_API int mmdeploy_pipeline_stream_push(mmdeploy_pipeline_stream_t stream,
+                                               mmdeploy_value_t input);
+
+/**
+ * @brief Pop the output of the earliest frame not yet popped, blocks until it's ready
+ * @param[in] stream handle of the stream
+ * @param[out] output output value of the frame, which must be destroyed by \ref
+ * mmdeploy_value_destroy
+ * @param[out] end_of_stream set to 1 when the stream is closed and all of its frames are popped, no
+ * output is returned then
+ * @return status of the frame
+ */
+MMDEPLOY_API int mmdeploy_pipeline_stream_pop(mmdeploy_pipeline_stream_t stream,
+                                              mmdeploy_value_t* output, int* end_of_stream);
+
+/**
+ * @brief Close the stream, no more frames can be pushed. The frames in flight can still be popped.
+ * @param[in] stream handle of the stream
+ * @return status of the operation
+ */
+MMDEPLOY_API int mmdeploy_pipeline_stream_close(mmdeploy_pipeline_stream_t stream);
+
+/**
+ * @brief Get the statistics of the stream, including the frame rate, the latency and, when
+ * profiling of the pipeline is enabled, the throughput of each stage
+ * @param[in] stream handle of the stream
+ * @param[out] stats the statistics, which must be destroyed by \ref mmdeploy_value_destroy
+ * @return status of the operation
+ */
+MMDEPLOY_API int mmdeploy_pipeline_stream_get_stats(mmdeploy_pipeline_stream_t stream,
+                                                    mmdeploy_value_t* stats);
+
+/**
+ * @brief Destroy the stream, the frames not yet started are dropped
+ * @param[in] stream handle of the stream
+ */
+MMDEPLOY_API void mmdeploy_pipeline_stream_destroy(mmdeploy_pipeline_stream_t stream);
+
 #ifdef __cplusplus
 }
 #endif
@@ -86,15 +86,23 @@ int mmdeploy_segmentor_apply(mmdeploy_segmentor_t segmentor, const mmdeploy_mat_
   return MMDEPLOY_SUCCESS;
 }
 
-void mmdeploy_segmentor_release_result(mmdeploy_segmentation_t* results, int count) {
-  if (results == nullptr) {
-    return;
+int mmdeploy_segmentor_apply_with_buffer(mmdeploy_segmentor_t segmentor,
+                                         const mmdeploy_mat_t* mats, int mat_count,
+                                         mmdeploy_result_buffer_t buffer,
+                                         mmdeploy_segmentation_t** results) {
+  wrapped<mmdeploy_value_t> input;
+  if (auto ec = mmdeploy_segmentor_create_input(mats, mat_count, input.ptr())) {
+    return ec;
   }
-
-  for (auto i = 0; i < count; ++i) {
-    delete[] results[i].mask;
+  wrapped<mmdeploy_value_t> output;
+  if (auto ec = mmdeploy_segmentor_apply_v2(segmentor, input, output.ptr())) {
+    return ec;
   }
-  delete[] results;
+  return mmdeploy_segmentor_get_result_with_buffer(output, buffer, results);
+}
+
+void mmdeploy_segmentor_release_result(mmdeploy_segmentation_t* results, int /*count*/) {
+  ResultArena::Release(results);
 }
 
 void mmdeploy_segmentor_destroy(mmdeploy_segmentor_t segmentor) {
@@ -121,31 +129,55 @@ int mmdeploy_segmentor_apply_async(mmdeploy_segmentor_t segmentor, mmdeploy_send
   return mmdeploy_pipeline_apply_async((mmdeploy_pipeline_t)segmentor, input, output);
 }
 
-int mmdeploy_segmentor_get_result(mmdeploy_value_t output, mmdeploy_segmentation_t** results) {
+namespace {
+
+// The masks are either copied or referenced, i.e. `mask` points into the mask of `output`. The
+// results are placed in `buffer` when it's not null, or else they own the memory.
+int GetResult(mmdeploy_value_t output, mmdeploy_result_buffer_t buffer,
+              mmdeploy_segmentation_t** results, bool copy_masks) {
+  if (!output || !results) {
+    return MMDEPLOY_E_INVALID_ARG;
+  }
   try {
     const auto& value = Cast(output)->front();
 
     size_t image_count = value.size();
 
-    auto deleter = [&](mmdeploy_segmentation_t* p) {
-      mmdeploy_segmentor_release_result(p, static_cast<int>(image_count));
-    };
-    unique_ptr<mmdeploy_segmentation_t[], decltype(deleter)> _results(
-        new mmdeploy_segmentation_t[image_count]{}, deleter);
-    auto results_ptr = _results.get();
-    for (auto i = 0; i < image_count; ++i, ++results_ptr) {
+    vector<mmseg::SegmentorOutput> segmentor_outputs;
+    segmentor_outputs.reserve(image_count);
+    size_t mask_size = 0;
+    for (size_t i = 0; i < image_count; ++i) {
       auto& output_item = value[i];
       MMDEPLOY_DEBUG("the {}-th item in output: {}", i, output_item);
-      auto segmentor_output = from_value<mmseg::SegmentorOutput>(output_item);
-      results_ptr->height = segmentor_output.height;
-      results_ptr->width = segmentor_output.width;
-      results_ptr->classes = segmentor_output.classes;
-      auto mask_size = results_ptr->height * results_ptr->width;
-      results_ptr->mask = new int[mask_size];
-      const auto& mask = segmentor_output.mask;
-      std::copy_n(mask.data<int>(), mask_size, results_ptr->mask);
+      auto& segmentor_output =
+          segmentor_outputs.emplace_back(from_value<mmseg::SegmentorOutput>(output_item));
+      mask_size += segmentor_output.height * segmentor_output.width;
+    }
+
+    // the results come first, they are released by their address
+    ResultArena arena;
+    arena.Reserve<mmdeploy_segmentation_t>(image_count);
+    arena.Reserve<int>(copy_masks ? mask_size : 0);
+    arena.Allocate(buffer);
+    auto results_ptr = arena.Take<mmdeploy_segmentation_t>(image_count);
+    auto mask_data = arena.Take<int>(copy_masks ? mask_size : 0);
+
+    for (size_t i = 0; i < image_count; ++i) {
+      auto& segmentor_output = segmentor_outputs[i];
+      auto& result = results_ptr[i];
+      result.height = segmentor_output.height;
+      result.width = segmentor_output.width;
+      result.classes = segmentor_output.classes;
+      auto& mask = segmentor_output.mask;
+      if (copy_masks) {
+        result.mask = mask_data;
+        mask_data = std::copy_n(mask.data<int>(), result.height * result.width, mask_data);
+      } else {
+        result.mask = mask.data<int>();
+      }
     }
-    *results = _results.release();
+    arena.Detach();
+    *results = results_ptr;
     return MMDEPLOY_SUCCESS;
 
   } catch (const std::exception& e) {
@@ -155,3 +187,27 @@ int mmdeploy_segmentor_get_result(mmdeploy_value_t output, mmdeploy_segmentation
   }
   return MMDEPLOY_E_FAIL;
 }
+
+}  // namespace
+
+int mmdeploy_segmentor_get_result(mmdeploy_value_t output, mmdeploy_segmentation_t** results) {
+  return GetResult(output, nullptr, results, true);
+}
+
+int mmdeploy_segmentor_get_result_view(mmdeploy_value_t output,
+                                       mmdeploy_segmentation_t** results) {
+  return GetResult(output, nullptr, results, false);
+}
+
+int mmdeploy_segmentor_get_result_with_buffer(mmdeploy_value_t output,
+                                              mmdeploy_result_buffer_t buffer,
+                                              mmdeploy_segmentation_t** results) {
+  if (!buffer) {
+    return MMDEPLOY_E_INVALID_ARG;
+  }
+  return GetResult(output, buffer, results, true);
+}
+
+void mmdeploy_segmentor_release_result_view(mmdeploy_segmentation_t* results, int /*count*/) {
+  ResultArena::Release(results);
+}
@@ -68,10 +68,28 @@ MMDEPLOY_API int mmdeploy_segmentor_apply(mmdeploy_segmentor_t segmentor,
 /**
  * @brief Release result buffer returned by \ref mmdeploy_segmentor_apply
  * @param[in] results result buffer
- * @param[in] count length of \p results
+ * @param[in] count length of \p results, ignored since the buffer is released by \p results
  */
 MMDEPLOY_API void mmdeploy_segmentor_release_result(mmdeploy_segmentation_t* results, int count);
 
+/**
+ * @brief Same as \ref mmdeploy_segmentor_apply, but the results are placed in \p buffer, which is
+ * reused across calls. The results must not be released, they are valid until \p buffer is used
+ * again or destroyed.
+ * @param[in] segmentor segmentor's handle created by \ref mmdeploy_segmentor_create_by_path or \ref
+ * mmdeploy_segmentor_create
+ * @param[in] mats a batch of images
+ * @param[in] mat_count number of images in the batch
+ * @param[in] buffer result buffer created by \ref mmdeploy_result_buffer_create
+ * @param[out] results a linear buffer of length \p mat_count to save segmentation result of each
+ * image
+ * @return status of inference
+ */
+MMDEPLOY_API int mmdeploy_segmentor_apply_with_buffer(mmdeploy_segmentor_t segmentor,
+                                                      const mmdeploy_mat_t* mats, int mat_count,
+                                                      mmdeploy_result_buffer_t buffer,
+                                                      mmdeploy_segmentation_t** results);
+
 /**
  * @brief Destroy segmentor's handle
  * @param[in] segmentor segmentor's handle created by \ref mmdeploy_segmentor_create_by_path
@@ -97,6 +115,33 @@ MMDEPLOY_API int mmdeploy_segmentor_apply_async(mmdeploy_segmentor_t segmentor,
 MMDEPLOY_API int mmdeploy_segmentor_get_result(mmdeploy_value_t output,
                                                mmdeploy_segmentation_t** results);
 
+/**
+ * @brief Same as \ref mmdeploy_segmentor_get_result, but the results are placed in \p buffer, see
+ * \ref mmdeploy_segmentor_apply_with_buffer
+ */
+MMDEPLOY_API int mmdeploy_segmentor_get_result_with_buffer(mmdeploy_value_t output,
+                                                           mmdeploy_result_buffer_t buffer,
+                                                           mmdeploy_segmentation_t** results);
+
+/**
+ * @brief Same as \ref mmdeploy_segmentor_get_result, but the masks are not copied. `mask` of the
+ * results points into \p output, which must not be destroyed before the results are released.
+ * @param[in] output output obtained by applying a segmentor
+ * @param[out] results a linear buffer of length number of input images to save segmentation result
+ * of each image. It must be released by \ref mmdeploy_segmentor_release_result_view
+ * @return status of the operation
+ */
+MMDEPLOY_API int mmdeploy_segmentor_get_result_view(mmdeploy_value_t output,
+                                                    mmdeploy_segmentation_t** results);
+
+/**
+ * @brief Release result buffer returned by \ref mmdeploy_segmentor_get_result_view
+ * @param[in] results result buffer
+ * @param[in] count length of \p results, ignored since the buffer is released by \p results
+ */
+MMDEPLOY_API void mmdeploy_segmentor_release_result_view(mmdeploy_segmentation_t* results,
+                                                         int count);
+
 #ifdef __cplusplus
 }
 #endif
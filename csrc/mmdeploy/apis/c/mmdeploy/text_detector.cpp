@@ -109,58 +109,94 @@ int mmdeploy_text_detector_apply_async(mmdeploy_text_detector_t detector, mmdepl
   return mmdeploy_pipeline_apply_async((mmdeploy_pipeline_t)detector, input, output);
 }
 
-int mmdeploy_text_detector_get_result(mmdeploy_value_t output, mmdeploy_text_detection_t** results,
-                                      int** result_count) {
+namespace {
+
+// the results are placed in `buffer` when it's not null, or else they own the memory
+int GetResult(mmdeploy_value_t output, mmdeploy_result_buffer_t buffer,
+              mmdeploy_text_detection_t** results, int** result_count) {
   if (!output || !results || !result_count) {
     return MMDEPLOY_E_INVALID_ARG;
   }
   try {
-    Value& value = reinterpret_cast<Value*>(output)->front();
-    auto detector_outputs = from_value<std::vector<mmocr::TextDetectorOutput>>(value);
+    Value& value = Cast(output)->front();
+    auto detector_outputs = from_value<vector<mmocr::TextDetectorOutput>>(value);
 
-    vector<int> _result_count;
-    _result_count.reserve(detector_outputs.size());
-    for (const auto& det_output : detector_outputs) {
-      _result_count.push_back((int)det_output.scores.size());
+    size_t total = 0;
+    for (const auto& output_item : detector_outputs) {
+      total += output_item.scores.size();
     }
 
-    auto total = std::accumulate(_result_count.begin(), _result_count.end(), 0);
+    // the results come first, they are released by their address
+    ResultArena arena;
+    arena.Reserve<mmdeploy_text_detection_t>(total);
+    arena.Reserve<int>(detector_outputs.size());
+    arena.Allocate(buffer);
+    auto result_data = arena.Take<mmdeploy_text_detection_t>(total);
+    auto result_count_data = arena.Take<int>(detector_outputs.size());
 
-    std::unique_ptr<int[]> result_count_data(new int[_result_count.size()]{});
-    std::copy(_result_count.begin(), _result_count.end(), result_count_data.get());
-
-    std::unique_ptr<mmdeploy_text_detection_t[]> result_data(
-        new mmdeploy_text_detection_t[total]{});
-    auto result_ptr = result_data.get();
-
-    for (const auto& det_output : detector_outputs) {
-      for (auto i = 0; i < det_output.scores.size(); ++i, ++result_ptr) {
-        result_ptr->score = det_output.scores[i];
-        auto& bbox = det_output.boxes[i];
-        for (auto j = 0; j < bbox.size(); j += 2) {
-          result_ptr->bbox[j / 2].x = bbox[j];
-          result_ptr->bbox[j / 2].y = bbox[j + 1];
+    auto result_ptr = result_data;
+    for (size_t i = 0; i < detector_outputs.size(); ++i) {
+      const auto& output_item = detector_outputs[i];
+      result_count_data[i] = static_cast<int>(output_item.scores.size());
+      for (size_t j = 0; j < output_item.scores.size(); ++j, ++result_ptr) {
+        result_ptr->score = output_item.scores[j];
+        auto& bbox = output_item.boxes[j];
+        for (size_t k = 0; k < bbox.size(); k += 2) {
+          result_ptr->bbox[k / 2].x = bbox[k];
+          result_ptr->bbox[k / 2].y = bbox[k + 1];
         }
       }
     }
 
-    *result_count = result_count_data.release();
-    *results = result_data.release();
+    arena.Detach();
+    *result_count = result_count_data;
+    *results = result_data;
 
     return MMDEPLOY_SUCCESS;
-
   } catch (const std::exception& e) {
     MMDEPLOY_ERROR("unhandled exception: {}", e.what());
   } catch (...) {
     MMDEPLOY_ERROR("unknown exception caught");
   }
-  return 0;
+  return MMDEPLOY_E_FAIL;
+}
+
+}  // namespace
+
+int mmdeploy_text_detector_get_result(mmdeploy_value_t output, mmdeploy_text_detection_t** results,
+                                      int** result_count) {
+  return GetResult(output, nullptr, results, result_count);
+}
+
+int mmdeploy_text_detector_get_result_with_buffer(mmdeploy_value_t output,
+                                                  mmdeploy_result_buffer_t buffer,
+                                                  mmdeploy_text_detection_t** results,
+                                                  int** result_count) {
+  if (!buffer) {
+    return MMDEPLOY_E_INVALID_ARG;
+  }
+  return GetResult(output, buffer, results, result_count);
+}
+
+int mmdeploy_text_detector_apply_with_buffer(mmdeploy_text_detector_t detector,
+                                             const mmdeploy_mat_t* mats, int mat_count,
+                                             mmdeploy_result_buffer_t buffer,
+                                             mmdeploy_text_detection_t** results,
+                                             int** result_count) {
+  wrapped<mmdeploy_value_t> input;
+  if (auto ec = mmdeploy_text_detector_create_input(mats, mat_count, input.ptr())) {
+    return ec;
+  }
+  wrapped<mmdeploy_value_t> output;
+  if (auto ec = mmdeploy_text_detector_apply_v2(detector, input, output.ptr())) {
+    return ec;
+  }
+  return mmdeploy_text_detector_get_result_with_buffer(output, buffer, results, result_count);
 }
 
 void mmdeploy_text_detector_release_result(mmdeploy_text_detection_t* results,
-                                           const int* result_count, int count) {
-  delete[] results;
-  delete[] result_count;
+                                           const int* /*result_count*/, int /*count*/) {
+  ResultArena::Release(results);
 }
 
 void mmdeploy_text_detector_destroy(mmdeploy_text_detector_t detector) {
@@ -65,10 +65,30 @@ MMDEPLOY_API int mmdeploy_text_detector_apply(mmdeploy_text_detector_t detector,
                                               mmdeploy_text_detection_t** results,
                                               int** result_count);
 
+/**
+ * @brief Same as \ref mmdeploy_text_detector_apply, but the results are placed in \p buffer, which
+ * is reused across calls. The results must not be released, they are valid until \p buffer is used
+ * again or destroyed.
+ * @param[in] detector text-detector's handle created by \ref mmdeploy_text_detector_create_by_path
+ * @param[in] mats a batch of images
+ * @param[in] mat_count number of images in the batch
+ * @param[in] buffer result buffer created by \ref mmdeploy_result_buffer_create
+ * @param[out] results a linear buffer to save text detection results of each image
+ * @param[out] result_count a linear buffer of length \p mat_count to save the number of detection
+ * results of each image
+ * @return status of inference
+ */
+MMDEPLOY_API int mmdeploy_text_detector_apply_with_buffer(mmdeploy_text_detector_t detector,
+                                                          const mmdeploy_mat_t* mats, int mat_count,
+                                                          mmdeploy_result_buffer_t buffer,
+                                                          mmdeploy_text_detection_t** results,
+                                                          int** result_count);
+
 /** @brief Release the inference result buffer returned by \ref mmdeploy_text_detector_apply
  * @param[in] results text detection result buffer
- * @param[in] result_count  \p results size buffer
- * @param[in] count the length of buffer \p result_count
+ * @param[in] result_count  \p results size buffer, ignored
+ * @param[in] count the length of buffer \p result_count, ignored since the buffer is released by
+ * \p results
  */
 MMDEPLOY_API void mmdeploy_text_detector_release_result(mmdeploy_text_detection_t* results,
                                                         const int* result_count, int count);
@@ -131,6 +151,15 @@ MMDEPLOY_API
 int mmdeploy_text_detector_get_result(mmdeploy_value_t output, mmdeploy_text_detection_t** results,
                                       int** result_count);
 
+/**
+ * @brief Same as \ref mmdeploy_text_detector_get_result, but the results are placed in \p buffer,
+ * see \ref mmdeploy_text_detector_apply_with_buffer
+ */
+MMDEPLOY_API int mmdeploy_text_detector_get_result_with_buffer(mmdeploy_value_t output,
+                                                               mmdeploy_result_buffer_t buffer,
+                                                               mmdeploy_text_detection_t** results,
+                                                               int** result_count);
+
 typedef int (*mmdeploy_text_detector_continue_t)(mmdeploy_text_detection_t* results,
                                                  int* result_count, void* context,
                                                  mmdeploy_sender_t* output);
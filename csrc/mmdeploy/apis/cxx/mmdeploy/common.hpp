@@ -53,6 +53,32 @@ class Model {
   std::shared_ptr<mmdeploy_model> model_{};
 };
 
+// Holds the results of the `Apply(images, buffer)` overloads of the task classes. The memory of the
+// results is reused by the following calls with the same buffer, so the results of a call are valid
+// until the buffer is passed to another call.
+class ResultBuffer {
+ public:
+  ResultBuffer() {
+    mmdeploy_result_buffer_t buffer{};
+    auto ec = mmdeploy_result_buffer_create(&buffer);
+    if (ec != MMDEPLOY_SUCCESS) {
+      throw_exception(static_cast<ErrorCode>(ec));
+    }
+    buffer_.reset(buffer, [](auto p) { mmdeploy_result_buffer_destroy(p); });
+  }
+
+  operator mmdeploy_result_buffer_t() const noexcept { return buffer_.get(); }
+
+  // results in the buffer, which keep the buffer alive but are not released on their own
+  template <typename T>
+  std::shared_ptr<T> Share(T* results) const noexcept {
+    return std::shared_ptr<T>(buffer_, results);
+  }
+
+ private:
+  std::shared_ptr<mmdeploy_result_buffer> buffer_{};
+};
+
 class Device {
  public:
   explicit Device(std::string name, int index = 0) : name_(std::move(name)), index_(index) {}
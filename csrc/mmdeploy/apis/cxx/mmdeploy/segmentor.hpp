@@ -53,6 +53,32 @@ class Segmentor : public NonMovable {
     return rets;
   }
 
+  // results are valid until `buffer` is used again, see `ResultBuffer`
+  std::vector<Result> Apply(Span<const Mat> images, ResultBuffer& buffer) {
+    if (images.empty()) {
+      return {};
+    }
+
+    Segmentation* results{};
+    auto ec = mmdeploy_segmentor_apply_with_buffer(segmentor_, reinterpret(images.data()),
+                                                   static_cast<int>(images.size()), buffer,
+                                                   &results);
+    if (ec != MMDEPLOY_SUCCESS) {
+      throw_exception(static_cast<ErrorCode>(ec));
+    }
+
+    auto data = buffer.Share(results);
+
+    std::vector<Result> rets;
+    rets.reserve(images.size());
+
+    for (size_t i = 0; i < images.size(); ++i) {
+      rets.emplace_back(i, 1, data);
+    }
+
+    return rets;
+  }
+
   Result Apply(const Mat& image) { return Apply(Span{image})[0]; }
 
  private:
@@ -57,6 +57,34 @@ class TextDetector : public NonMovable {
     return rets;
   }
 
+  // results are valid until `buffer` is used again, see `ResultBuffer`
+  std::vector<Result> Apply(Span<const Mat> images, ResultBuffer& buffer) {
+    if (images.empty()) {
+      return {};
+    }
+
+    TextDetection* results{};
+    int* result_count{};
+    auto ec = mmdeploy_text_detector_apply_with_buffer(detector_, reinterpret(images.data()),
+                                                       static_cast<int>(images.size()), buffer,
+                                                       &results, &result_count);
+    if (ec != MMDEPLOY_SUCCESS) {
+      throw_exception(static_cast<ErrorCode>(ec));
+    }
+
+    auto data = buffer.Share(results);
+
+    std::vector<Result> rets;
+    rets.reserve(images.size());
+
+    size_t offset = 0;
+    for (size_t i = 0; i < images.size(); ++i) {
+      offset += rets.emplace_back(offset, result_count[i], data).size();
+    }
+
+    return rets;
+  }
+
   Result Apply(const Mat& image) { return Apply(Span{image})[0]; }
 
  private:
@@ -1,6 +1,7 @@
 #include "mmdeploy_TextRecognizer.h"
 
 #include <numeric>
+#include <vector>
 
 #include "mmdeploy/apis/c/mmdeploy/text_recognizer.h"
 #include "mmdeploy/apis/java/native/common.h"
@@ -57,15 +58,17 @@ jobjectArray Java_mmdeploy_TextRecognizer_applyBbox(JNIEnv *env, jobject thiz, j
                                                     jintArray bbox_count) {
   return With(env, images, [&](const mmdeploy_mat_t imgs[], int size) {
     mmdeploy_text_recognition_t *recog_results{};
-    auto *det_results = new mmdeploy_text_detection_t[env->GetArrayLength(bboxes)];
-    int *det_result_count = new int[env->GetArrayLength(bbox_count)];
+    // owned by the caller, the SDK only reads them
+    std::vector<mmdeploy_text_detection_t> det_results(env->GetArrayLength(bboxes));
+    std::vector<int> det_result_count(env->GetArrayLength(bbox_count));
     auto bbox_cls = env->FindClass("mmdeploy/TextDetector$Result");
     auto pointf_cls = env->FindClass("mmdeploy/PointF");
     auto bbox_id = env->GetFieldID(bbox_cls, "bbox", "[Lmmdeploy/PointF;");
     auto score_id = env->GetFieldID(bbox_cls, "score", "F");
     auto x_id = env->GetFieldID(pointf_cls, "x", "F");
     auto y_id = env->GetFieldID(pointf_cls, "y", "F");
-    env->GetIntArrayRegion(bbox_count, 0, env->GetArrayLength(bbox_count), det_result_count);
+    env->GetIntArrayRegion(bbox_count, 0, env->GetArrayLength(bbox_count),
+                          det_result_count.data());
     int total_bboxes = env->GetArrayLength(bboxes);
     for (int i = 0; i < total_bboxes; ++i) {
       auto bboxi = env->GetObjectArrayElement(bboxes, i);
@@ -78,8 +81,8 @@ jobjectArray Java_mmdeploy_TextRecognizer_applyBbox(JNIEnv *env, jobject thiz, j
       }
     }
     auto ec = mmdeploy_text_recognizer_apply_bbox((mmdeploy_text_recognizer_t)handle, imgs, size,
-                                                  (const mmdeploy_text_detection_t *)det_results,
-                                                  det_result_count, &recog_results);
+                                                  det_results.data(), det_result_count.data(),
+                                                  &recog_results);
     if (ec) {
       MMDEPLOY_ERROR("failed to apply bbox for text recognizer, code = {}", ec);
     }
@@ -96,8 +99,7 @@ jobjectArray Java_mmdeploy_TextRecognizer_applyBbox(JNIEnv *env, jobject thiz, j
       auto res = env->NewObject(result_cls, result_ctor, text, score);
       env->SetObjectArrayElement(array, i, res);
     }
-    mmdeploy_text_recognizer_release_result(recog_results, size);
-    mmdeploy_text_detector_release_result(det_results, det_result_count, 1);
+    mmdeploy_text_recognizer_release_result(recog_results, total_bboxes);
     return array;
   });
 }
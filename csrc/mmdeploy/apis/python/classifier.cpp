@@ -30,8 +30,12 @@ class PyClassifier {
     }
     mmdeploy_classification_t *results{};
     int *result_count{};
-    auto status = mmdeploy_classifier_apply(classifier_, mats.data(), (int)mats.size(), &results,
-                                            &result_count);
+    int status{};
+    {
+      py::gil_scoped_release _;
+      status = mmdeploy_classifier_apply(classifier_, mats.data(), (int)mats.size(), &results,
+                                         &result_count);
+    }
     if (status != MMDEPLOY_SUCCESS) {
       throw std::runtime_error("failed to apply classifier, code: " + std::to_string(status));
     }
@@ -62,7 +66,10 @@ static void register_python_classifier(py::module &m) {
            py::arg("model_path"), py::arg("device_name"), py::arg("device_id") = 0)
       .def("__call__",
            [](PyClassifier *self, const PyImage &img) { return self->Apply(std::vector{img})[0]; })
-      .def("batch", &PyClassifier::Apply);
+      .def("batch", &PyClassifier::Apply)
+      .def("apply_async", [](py::object self, py::args args) {
+        return RunAsync(self.attr("__call__"), args);
+      });
 }
 
 class PythonClassifierRegisterer {
@@ -32,6 +32,11 @@ mmdeploy_mat_t GetMat(const PyImage& img) {
   return mat;
 }
 
+py::object RunAsync(const py::object& fn, const py::args& args) {
+  auto loop = py::module::import("asyncio").attr("get_running_loop")();
+  return loop.attr("run_in_executor")(py::none(), fn, *args);
+}
+
 #if 0
 
 py::object ConvertToPyObject(const Value& value) {
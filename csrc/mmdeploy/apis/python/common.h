@@ -20,6 +20,11 @@ std::map<std::string, void (*)(py::module &)> &gPythonBindings();
 
 mmdeploy_mat_t GetMat(const PyImage &img);
 
+// Calls `fn(*args)` on the default executor of the running asyncio loop and returns the awaitable
+// future. The pending call holds `fn` (and the handle bound to it), the apply methods release the
+// GIL while they wait for the SDK.
+py::object RunAsync(const py::object &fn, const py::args &args);
+
 class Value;
 
 py::object ConvertToPyObject(const Value &value);
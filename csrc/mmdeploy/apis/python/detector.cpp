@@ -23,8 +23,12 @@ class PyDetector {
     }
     mmdeploy_detection_t *detection{};
     int *result_count{};
-    auto status = mmdeploy_detector_apply(detector_, mats.data(), (int)mats.size(), &detection,
-                                          &result_count);
+    int status{};
+    {
+      py::gil_scoped_release _;
+      status = mmdeploy_detector_apply(detector_, mats.data(), (int)mats.size(), &detection,
+                                       &result_count);
+    }
     if (status != MMDEPLOY_SUCCESS) {
       throw std::runtime_error("failed to apply detector, code: " + std::to_string(status));
     }
@@ -75,7 +79,10 @@ static void register_python_detector(py::module &m) {
            [](PyDetector *self, const PyImage &img) -> py::tuple {
              return self->Apply(std::vector{img})[0];
            })
-      .def("batch", &PyDetector::Apply);
+      .def("batch", &PyDetector::Apply)
+      .def("apply_async", [](py::object self, py::args args) {
+        return RunAsync(self.attr("__call__"), args);
+      });
 }
 
 class PythonDetectorRegisterer {
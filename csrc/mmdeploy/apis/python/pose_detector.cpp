@@ -57,8 +57,12 @@ class PyPoseDetector {
     }
 
     mmdeploy_pose_detection_t *detection{};
-    auto status = mmdeploy_pose_detector_apply_bbox(detector_, mats.data(), (int)mats.size(),
-                                                    boxes.data(), bbox_count.data(), &detection);
+    int status{};
+    {
+      py::gil_scoped_release _;
+      status = mmdeploy_pose_detector_apply_bbox(detector_, mats.data(), (int)mats.size(),
+                                                 boxes.data(), bbox_count.data(), &detection);
+    }
     if (status != MMDEPLOY_SUCCESS) {
       throw std::runtime_error("failed to apply pose_detector, code: " + std::to_string(status));
     }
@@ -122,7 +126,10 @@ static void register_python_pose_detector(py::module &m) {
           },
           py::arg("img"), py::arg("bboxes"))
       .def("batch", &PyPoseDetector::Apply, py::arg("imgs"),
-           py::arg("bboxes") = std::vector<std::vector<Rect>>());
+           py::arg("bboxes") = std::vector<std::vector<Rect>>())
+      .def("apply_async", [](py::object self, py::args args) {
+        return RunAsync(self.attr("__call__"), args);
+      });
 }
 
 class PythonPoseDetectorRegisterer {
@@ -27,7 +27,11 @@ class PyRestorer {
       mats.push_back(mat);
     }
     mmdeploy_mat_t *results{};
-    auto status = mmdeploy_restorer_apply(restorer_, mats.data(), (int)mats.size(), &results);
+    int status{};
+    {
+      py::gil_scoped_release _;
+      status = mmdeploy_restorer_apply(restorer_, mats.data(), (int)mats.size(), &results);
+    }
     if (status != MMDEPLOY_SUCCESS) {
       throw std::runtime_error("failed to apply restorer, code: " + std::to_string(status));
     }
@@ -56,7 +60,10 @@ static void register_python_restorer(py::module &m) {
            [](PyRestorer *self, const PyImage &img) -> py::array {
              return self->Apply(std::vector{img})[0];
            })
-      .def("batch", &PyRestorer::Apply);
+      .def("batch", &PyRestorer::Apply)
+      .def("apply_async", [](py::object self, py::args args) {
+        return RunAsync(self.attr("__call__"), args);
+      });
 }
 
 class PythonRestorerRegisterer {
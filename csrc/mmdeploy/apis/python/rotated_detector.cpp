@@ -25,8 +25,12 @@ class PyRotatedDetector {
 
     mmdeploy_rotated_detection_t *rbboxes{};
     int *res_count{};
-    auto status = mmdeploy_rotated_detector_apply(detector_, mats.data(), (int)mats.size(),
-                                                  &rbboxes, &res_count);
+    int status{};
+    {
+      py::gil_scoped_release _;
+      status = mmdeploy_rotated_detector_apply(detector_, mats.data(), (int)mats.size(), &rbboxes,
+                                               &res_count);
+    }
     if (status != MMDEPLOY_SUCCESS) {
       throw std::runtime_error("failed to apply rotated detector, code: " + std::to_string(status));
     }
@@ -71,7 +75,10 @@ static void register_python_rotated_detector(py::module &m) {
            [](PyRotatedDetector *self, const PyImage &img) -> py::tuple {
              return self->Apply(std::vector{img})[0];
            })
-      .def("batch", &PyRotatedDetector::Apply);
+      .def("batch", &PyRotatedDetector::Apply)
+      .def("apply_async", [](py::object self, py::args args) {
+        return RunAsync(self.attr("__call__"), args);
+      });
 }
 
 class PythonRotatedDetectorRegisterer {
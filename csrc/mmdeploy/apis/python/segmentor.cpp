@@ -28,7 +28,11 @@ class PySegmentor {
       mats.push_back(mat);
     }
     mmdeploy_segmentation_t *segm{};
-    auto status = mmdeploy_segmentor_apply(segmentor_, mats.data(), (int)mats.size(), &segm);
+    int status{};
+    {
+      py::gil_scoped_release _;
+      status = mmdeploy_segmentor_apply(segmentor_, mats.data(), (int)mats.size(), &segm);
+    }
     if (status != MMDEPLOY_SUCCESS) {
       throw std::runtime_error("failed to apply segmentor, code: " + std::to_string(status));
     }
@@ -57,7 +61,10 @@ static void register_python_segmentor(py::module &m) {
            [](PySegmentor *self, const PyImage &img) -> py::array {
              return self->Apply(std::vector{img})[0];
            })
-      .def("batch", &PySegmentor::Apply);
+      .def("batch", &PySegmentor::Apply)
+      .def("apply_async", [](py::object self, py::args args) {
+        return RunAsync(self.attr("__call__"), args);
+      });
 }
 
 class PythonSegmentorRegisterer {
@@ -24,8 +24,12 @@ class PyTextDetector {
     }
     mmdeploy_text_detection_t *detection{};
     int *result_count{};
-    auto status = mmdeploy_text_detector_apply(detector_, mats.data(), (int)mats.size(), &detection,
-                                               &result_count);
+    int status{};
+    {
+      py::gil_scoped_release _;
+      status = mmdeploy_text_detector_apply(detector_, mats.data(), (int)mats.size(), &detection,
+                                            &result_count);
+    }
     if (status != MMDEPLOY_SUCCESS) {
       throw std::runtime_error("failed to apply text_detector, code: " + std::to_string(status));
     }
@@ -65,7 +69,10 @@ static void register_python_text_detector(py::module &m) {
            [](PyTextDetector *self, const PyImage &img) -> py::array {
              return self->Apply(std::vector{img})[0];
            })
-      .def("batch", &PyTextDetector::Apply);
+      .def("batch", &PyTextDetector::Apply)
+      .def("apply_async", [](py::object self, py::args args) {
+        return RunAsync(self.attr("__call__"), args);
+      });
 }
 
 class PythonTextDetectorRegisterer {
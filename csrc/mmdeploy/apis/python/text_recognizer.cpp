@@ -23,8 +23,11 @@ class PyTextRecognizer {
       mats.push_back(mat);
     }
     mmdeploy_text_recognition_t *results{};
-    auto status =
-        mmdeploy_text_recognizer_apply(recognizer_, mats.data(), (int)mats.size(), &results);
+    int status{};
+    {
+      py::gil_scoped_release _;
+      status = mmdeploy_text_recognizer_apply(recognizer_, mats.data(), (int)mats.size(), &results);
+    }
     if (status != MMDEPLOY_SUCCESS) {
       throw std::runtime_error("failed to apply text_recognizer, code: " + std::to_string(status));
     }
@@ -44,8 +47,13 @@ class PyTextRecognizer {
     auto mat = GetMat(img);
     int bbox_count = bboxes.size() * sizeof(float) / sizeof(mmdeploy_text_detection_t);
     mmdeploy_text_recognition_t *results{};
-    auto status = mmdeploy_text_recognizer_apply_bbox(
-        recognizer_, &mat, 1, (mmdeploy_text_detection_t *)bboxes.data(), &bbox_count, &results);
+    int status{};
+    {
+      py::gil_scoped_release _;
+      status = mmdeploy_text_recognizer_apply_bbox(recognizer_, &mat, 1,
+                                                   (mmdeploy_text_detection_t *)bboxes.data(),
+                                                   &bbox_count, &results);
+    }
     if (status != MMDEPLOY_SUCCESS) {
       throw std::runtime_error("failed to apply text_recognizer, code: " + std::to_string(status));
     }
@@ -76,7 +84,10 @@ static void register_python_text_recognizer(py::module &m) {
                           const PyImage &img) { return self->Apply(std::vector{img})[0]; })
       .def("__call__", [](PyTextRecognizer *self, const PyImage &img,
                           const std::vector<float> &bboxes) { return self->Apply(img, bboxes); })
-      .def("batch", py::overload_cast<const std::vector<PyImage> &>(&PyTextRecognizer::Apply));
+      .def("batch", py::overload_cast<const std::vector<PyImage> &>(&PyTextRecognizer::Apply))
+      .def("apply_async", [](py::object self, py::args args) {
+        return RunAsync(self.attr("__call__"), args);
+      });
 }
 
 class PythonTextRecognizerRegisterer {
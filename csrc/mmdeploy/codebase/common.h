@@ -3,9 +3,14 @@
 #ifndef MMDEPLOY_SRC_CODEBASE_COMMON_H_
 #define MMDEPLOY_SRC_CODEBASE_COMMON_H_
 
+#include <cstring>
+#include <memory>
+#include <string>
+
 #include "mmdeploy/core/device.h"
 #include "mmdeploy/core/module.h"
 #include "mmdeploy/core/registry.h"
+#include "mmdeploy/core/tensor.h"
 #include "mmdeploy/core/utils/formatter.h"
 #include "mmdeploy/experimental/module_adapter.h"
 
@@ -27,6 +32,42 @@ class Context {
   Stream stream_;
 };
 
+// create the module forwarding the inputs of a composite module (e.g. tiled or sliding-window
+// inference), whose type is given by the "net" key of `cfg`, "Net" by default
+inline std::unique_ptr<Module> CreateNet(const Value& cfg) {
+  auto type = cfg.value<std::string>("net", "Net");
+  auto creator = Registry<Module>::Get().GetCreator(type);
+  if (!creator) {
+    MMDEPLOY_ERROR("'{}' is not found in Module registry", type);
+    throw_exception(eEntryNotFound);
+  }
+  auto net = creator->Create(cfg);
+  if (!net) {
+    MMDEPLOY_ERROR("failed to create net, config: {}", cfg);
+    throw_exception(eFail);
+  }
+  return net;
+}
+
+// copy the `height` x `width` region at (`top`, `left`) of a 1xCxHxW float tensor on host to a
+// tensor of its own
+inline Tensor CropTensor(const Tensor& src, int top, int left, int height, int width) {
+  auto channels = src.shape(1);
+  auto src_h = src.shape(2);
+  auto src_w = src.shape(3);
+  Tensor dst(
+      TensorDesc{src.device(), DataType::kFLOAT, {1, channels, height, width}, src.name()});
+  auto s = src.data<float>();
+  auto d = dst.data<float>();
+  for (int64_t c = 0; c < channels; ++c) {
+    for (int i = 0; i < height; ++i) {
+      std::memcpy(d, s + (c * src_h + top + i) * src_w + left, sizeof(float) * width);
+      d += width;
+    }
+  }
+  return dst;
+}
+
 template <class Tag>
 class CodebaseCreator : public Creator<Module> {
  public:
@@ -14,6 +14,18 @@ namespace mmedit {
 
 using RestorerOutput = Mat;
 
+// pixel format of the uint8 images converted from the CHW float outputs of restorers
+inline Result<PixelFormat> ChannelsToFormat(int channels) {
+  switch (channels) {
+    case 1:
+      return PixelFormat::kGRAYSCALE;
+    case 3:
+      return PixelFormat::kRGB;
+    default:
+      return Status(eNotSupported);
+  }
+}
+
 DECLARE_CODEBASE(MMEdit, mmedit);
 
 }  // namespace mmedit
@@ -13,6 +13,10 @@ class TensorToImg : public MMEdit {
   explicit TensorToImg(const Value& cfg) : MMEdit(cfg) {}
 
   Result<Value> operator()(const Value& input) {
+    if (input["output"].is_any<Mat>()) {
+      // already converted by `TiledRestorer`
+      return input["output"];
+    }
     auto upscale = input["output"].get<Tensor>();
     OUTCOME_TRY(auto upscale_cpu, MakeAvailableOnDevice(upscale, kHOST, stream()));
     OUTCOME_TRY(stream().Wait());
@@ -39,17 +43,6 @@ class TensorToImg : public MMEdit {
   }
 
  protected:
-  static Result<PixelFormat> ChannelsToFormat(int channels) {
-    switch (channels) {
-      case 1:
-        return PixelFormat::kGRAYSCALE;
-      case 3:
-        return PixelFormat::kRGB;
-      default:
-        return Status(eNotSupported);
-    }
-  }
-
   static constexpr const Device kHOST{0, 0};
 };
 
@@ -0,0 +1,140 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "mmdeploy/codebase/mmedit/mmedit.h"
+#include "mmdeploy/codebase/mmedit/tiling.h"
+#include "mmdeploy/core/logger.h"
+#include "mmdeploy/core/tensor.h"
+#include "mmdeploy/core/utils/device_utils.h"
+#include "mmdeploy/core/utils/formatter.h"
+
+namespace mmdeploy::mmedit {
+
+// Runs the restorer net on overlapping tiles of the input instead of the whole image, which bounds
+// the memory of the net by the tile size. The outputs are blended with feathered weights in the
+// overlapping areas and written to the final uint8 image. Tasks created by this module take the
+// config of the "Net" module with the additional keys
+//   "tile_size": size of the (square) tiles on the input, 256 by default
+//   "tile_overlap": minimum overlap of the neighbouring tiles, 16 by default
+//   "batch_size": number of tiles forwarded together, 4 by default
+//   "net": type of the module forwarding the tiles, "Net" by default
+class TiledRestorer : public Module {
+ public:
+  explicit TiledRestorer(const Value& cfg) : net_(CreateNet(cfg)) {
+    stream_ = cfg["context"]["stream"].get<Stream>();
+    tile_size_ = cfg.value("tile_size", tile_size_);
+    tile_overlap_ = cfg.value("tile_overlap", tile_overlap_);
+    batch_size_ = cfg.value("batch_size", batch_size_);
+    if (tile_size_ < 1 || tile_overlap_ < 0 || tile_overlap_ >= tile_size_ || batch_size_ < 1) {
+      MMDEPLOY_ERROR("invalid tiling, tile_size: {}, tile_overlap: {}, batch_size: {}", tile_size_,
+                     tile_overlap_, batch_size_);
+      throw_exception(eInvalidArgument);
+    }
+  }
+
+  Result<Value> Process(const Value& args) override {
+    auto img = args[0]["img"].get<Tensor>();
+    if (img.shape().size() != 4 || img.shape(0) != 1 || img.data_type() != DataType::kFLOAT) {
+      MMDEPLOY_ERROR("unsupported `img` tensor, shape: {}, dtype: {}", img.shape(),
+                     (int)img.data_type());
+      return Status(eNotSupported);
+    }
+    OUTCOME_TRY(auto input, MakeAvailableOnDevice(img, kHOST, stream_));
+    OUTCOME_TRY(stream_.Wait());
+
+    auto height = static_cast<int>(input.shape(2));
+    auto width = static_cast<int>(input.shape(3));
+    auto tile_h = std::min(tile_size_, height);
+    auto tile_w = std::min(tile_size_, width);
+    auto ys = GetTileOffsets(height, tile_h, tile_overlap_);
+    auto xs = GetTileOffsets(width, tile_w, tile_overlap_);
+    std::vector<std::pair<int, int>> tiles;
+    tiles.reserve(ys.size() * xs.size());
+    for (auto y : ys) {
+      for (auto x : xs) {
+        tiles.emplace_back(y, x);
+      }
+    }
+
+    std::optional<Blender> blender;
+    int scale_y{};
+    int scale_x{};
+    for (size_t i = 0; i < tiles.size(); i += batch_size_) {
+      auto n = std::min(tiles.size() - i, static_cast<size_t>(batch_size_));
+      Value::Array batch;
+      for (size_t j = 0; j < n; ++j) {
+        auto [y, x] = tiles[i + j];
+        batch.push_back({{"img", CropTensor(input, y, x, tile_h, tile_w)}});
+      }
+      OUTCOME_TRY(auto output, net_->Process(Value::Array{Value(std::move(batch))}));
+      std::vector<Tensor> outputs;
+      for (size_t j = 0; j < n; ++j) {
+        OUTCOME_TRY(auto tensor,
+                    MakeAvailableOnDevice(output[0][j]["output"].get<Tensor>(), kHOST, stream_));
+        outputs.push_back(std::move(tensor));
+      }
+      OUTCOME_TRY(stream_.Wait());
+
+      if (!blender) {
+        // the scale factor is only known after the first forward
+        auto& shape = outputs[0].shape();
+        if (shape.size() != 4 || outputs[0].data_type() != DataType::kFLOAT ||
+            shape[2] % tile_h || shape[3] % tile_w) {
+          MMDEPLOY_ERROR("unsupported `output` tensor, shape: {}, tile: {}x{}", shape, tile_h,
+                         tile_w);
+          return Status(eNotSupported);
+        }
+        auto channels = static_cast<int>(shape[1]);
+        OUTCOME_TRY(auto format, ChannelsToFormat(channels));
+        scale_y = static_cast<int>(shape[2]) / tile_h;
+        scale_x = static_cast<int>(shape[3]) / tile_w;
+        blender.emplace(Mat(height * scale_y, width * scale_x, format, DataType::kINT8, kHOST),
+                        channels);
+      }
+
+      for (size_t j = 0; j < n; ++j) {
+        auto [y, x] = tiles[i + j];
+        auto out_h = tile_h * scale_y;
+        auto out_w = tile_w * scale_x;
+        if (outputs[j].shape() != outputs[0].shape()) {
+          MMDEPLOY_ERROR("inconsistent output shapes: {} vs {}", outputs[j].shape(),
+                         outputs[0].shape());
+          return Status(eNotSupported);
+        }
+        auto wy = GetFeather(out_h, tile_overlap_ * scale_y, y > 0, y + tile_h < height);
+        auto wx = GetFeather(out_w, tile_overlap_ * scale_x, x > 0, x + tile_w < width);
+        blender->Blend(outputs[j].data<float>(), out_h, out_w, y * scale_y, x * scale_x, wy, wx);
+      }
+      // rows above the next tile are complete
+      auto next = i + n < tiles.size() ? tiles[i + n].first * scale_y : height * scale_y;
+      blender->Flush(next);
+    }
+    return Value(Value::Array{Value{{"output", blender->image()}}});
+  }
+
+ private:
+  static constexpr const Device kHOST{0, 0};
+
+  std::unique_ptr<Module> net_;
+  Stream stream_;
+  int tile_size_{256};
+  int tile_overlap_{16};
+  int batch_size_{4};
+};
+
+class TiledRestorerCreator : public Creator<Module> {
+ public:
+  const char* GetName() const override { return "TiledRestorer"; }
+  int GetVersion() const override { return 0; }
+  std::unique_ptr<Module> Create(const Value& cfg) override {
+    return std::make_unique<TiledRestorer>(cfg);
+  }
+};
+
+REGISTER_MODULE(Module, TiledRestorerCreator);
+
+}  // namespace mmdeploy::mmedit
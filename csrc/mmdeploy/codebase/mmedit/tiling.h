@@ -0,0 +1,105 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+#ifndef MMDEPLOY_CSRC_CODEBASE_MMEDIT_TILING_H_
+#define MMDEPLOY_CSRC_CODEBASE_MMEDIT_TILING_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "mmdeploy/core/mat.h"
+
+namespace mmdeploy::mmedit {
+
+// begin offsets of the tiles covering [0, length), consecutive tiles overlap by at least
+// `overlap`. The last tile is aligned to the end so that all the tiles are of the same size.
+inline std::vector<int> GetTileOffsets(int length, int tile, int overlap) {
+  std::vector<int> offsets{0};
+  while (offsets.back() + tile < length) {
+    offsets.push_back(std::min(offsets.back() + tile - overlap, length - tile));
+  }
+  return offsets;
+}
+
+// linear ramps of `ramp` pixels on the sides shared with the neighbouring tiles, the weights stay
+// positive so that every output pixel is covered by some tile
+inline std::vector<float> GetFeather(int size, int ramp, bool begin, bool end) {
+  std::vector<float> weights(size, 1.f);
+  for (int i = 0; i < size; ++i) {
+    if (begin) {
+      weights[i] = std::min(weights[i], (i + 1.f) / (ramp + 1.f));
+    }
+    if (end) {
+      weights[i] = std::min(weights[i], (size - i) / (ramp + 1.f));
+    }
+  }
+  return weights;
+}
+
+// weighted sums of the tile outputs for a band of output rows. Rows no longer covered by the
+// remaining tiles are converted to uint8 and written to the output image, so only the rows of the
+// tiles in flight are kept in float.
+class Blender {
+ public:
+  Blender(Mat image, int channels) : image_(std::move(image)), channels_(channels) {}
+
+  // `tile` is the CHW output of the `height` x `width` tile at (`top`, `left`) of the image
+  void Blend(const float* tile, int height, int width, int top, int left,
+             const std::vector<float>& wy, const std::vector<float>& wx) {
+    Extend(top + height);
+    auto stride = image_.width();
+    auto plane = static_cast<size_t>(height) * width;
+    for (int i = 0; i < height; ++i) {
+      auto row = static_cast<size_t>(top + i - begin_) * stride + left;
+      auto acc = accum_.data() + row * channels_;
+      auto w = weight_.data() + row;
+      for (int j = 0; j < width; ++j) {
+        w[j] += wy[i] * wx[j];
+      }
+      for (int c = 0; c < channels_; ++c) {
+        auto src = tile + c * plane + static_cast<size_t>(i) * width;
+        for (int j = 0; j < width; ++j) {
+          acc[j * channels_ + c] += wy[i] * wx[j] * src[j];
+        }
+      }
+    }
+  }
+
+  // write the rows before `limit` to the output image
+  void Flush(int limit) {
+    auto count = static_cast<size_t>(std::max(0, limit - begin_)) * image_.width();
+    auto dst = image_.data<uint8_t>() + static_cast<size_t>(begin_) * image_.width() * channels_;
+    for (size_t i = 0; i < count; ++i) {
+      auto scale = 255.f / weight_[i];
+      for (int c = 0; c < channels_; ++c) {
+        auto v = accum_[i * channels_ + c] * scale;
+        dst[i * channels_ + c] = static_cast<uint8_t>(std::clamp(v, 0.f, 255.f) + .5f);
+      }
+    }
+    accum_.erase(accum_.begin(), accum_.begin() + count * channels_);
+    weight_.erase(weight_.begin(), weight_.begin() + count);
+    begin_ += static_cast<int>(count / image_.width());
+  }
+
+  Mat& image() { return image_; }
+
+ private:
+  void Extend(int end) {
+    auto count = static_cast<size_t>(end - begin_) * image_.width();
+    if (count > weight_.size()) {
+      weight_.resize(count);
+      accum_.resize(count * channels_);
+    }
+  }
+
+  Mat image_;
+  int channels_;
+  int begin_{};
+  std::vector<float> accum_;
+  std::vector<float> weight_;
+};
+
+}  // namespace mmdeploy::mmedit
+
+#endif  // MMDEPLOY_CSRC_CODEBASE_MMEDIT_TILING_H_
@@ -84,7 +84,7 @@ class ResizeOCRImpl : public Module {
     Value output = input;
     output["img"] = img_resize;
     output["resize_shape"] = to_value(img_resize.desc().shape);
-    output["pad_shape"] = output["resize_shape"];
+    output["pad_shape"] = to_value(img_resize.desc().shape);
     output["valid_ratio"] = valid_ratio;
     MMDEPLOY_DEBUG("output: {}", to_json(output).dump(2));
     return output;
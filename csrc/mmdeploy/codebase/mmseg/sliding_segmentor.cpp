@@ -0,0 +1,317 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "mmdeploy/codebase/mmseg/mmseg.h"
+#include "mmdeploy/core/logger.h"
+#include "mmdeploy/core/tensor.h"
+#include "mmdeploy/core/utils/device_utils.h"
+#include "mmdeploy/core/utils/formatter.h"
+
+namespace mmdeploy::mmseg {
+
+namespace {
+
+constexpr const Device kHOST{0, 0};
+
+// begin offsets of the windows along an axis as in the "slide" test mode of mmseg, the windows of
+// the last row / column are shifted back into the image so that all the windows are of the same
+// size
+std::vector<int> GetWindowOffsets(int length, int crop, int stride) {
+  auto grids = std::max(length - crop + stride - 1, 0) / stride + 1;
+  std::vector<int> offsets(grids);
+  for (int i = 0; i < grids; ++i) {
+    offsets[i] = std::max(std::min(i * stride + crop, length) - crop, 0);
+  }
+  return offsets;
+}
+
+// per-pixel class scores for a band of rows, summed over the windows covering the pixels. Rows no
+// longer covered by the remaining windows are reduced to labels, so only the rows of the windows
+// in flight are kept. The scores are not normalized by the number of windows, which doesn't
+// change the argmax.
+class Canvas {
+ public:
+  Canvas(int height, int width, int classes)
+      : labels_(TensorDesc{kHOST, DataType::kINT32, {1, 1, height, width}, "output"}),
+        width_(width),
+        classes_(classes) {}
+
+  // `output` is either the logits (1xKxhxw) or the labels (1x1xhxw) of the hxw window at (top,
+  // left), the labels are counted as votes
+  Result<void> Add(const Tensor& output, int top, int left, int height, int width) {
+    auto& shape = output.shape();
+    if (shape.size() != 4 || shape[0] != 1 || shape[2] != height || shape[3] != width) {
+      MMDEPLOY_ERROR("unexpected shape of the `output` tensor: {}, window: {}x{}", shape, height,
+                     width);
+      return Status(eNotSupported);
+    }
+    Extend(top + height);
+    if (shape[1] == classes_ && output.data_type() == DataType::kFLOAT) {
+      auto plane = static_cast<size_t>(height) * width;
+      for (int k = 0; k < classes_; ++k) {
+        auto src = output.data<float>() + k * plane;
+        for (int i = 0; i < height; ++i, src += width) {
+          auto dst = Row(top + i) + static_cast<size_t>(left) * classes_ + k;
+          for (int j = 0; j < width; ++j) {
+            dst[j * classes_] += src[j];
+          }
+        }
+      }
+      return success();
+    }
+    if (shape[1] == 1) {
+      switch (output.data_type()) {
+        case DataType::kINT32:
+          return Vote(output.data<int32_t>(), height, width, top, left);
+        case DataType::kINT64:
+          return Vote(output.data<int64_t>(), height, width, top, left);
+        case DataType::kFLOAT:
+          return Vote(output.data<float>(), height, width, top, left);
+        default:
+          break;
+      }
+    }
+    MMDEPLOY_ERROR("unsupported `output` tensor, shape: {}, dtype: {}, num_classes: {}", shape,
+                   (int)output.data_type(), classes_);
+    return Status(eNotSupported);
+  }
+
+  // reduce the rows before `limit` to labels
+  void Flush(int limit) {
+    auto count = static_cast<size_t>(std::max(0, limit - begin_)) * width_;
+    auto dst = labels_.data<int32_t>() + static_cast<size_t>(begin_) * width_;
+    for (size_t i = 0; i < count; ++i) {
+      auto scores = scores_.data() + i * classes_;
+      dst[i] = static_cast<int32_t>(std::max_element(scores, scores + classes_) - scores);
+    }
+    scores_.erase(scores_.begin(), scores_.begin() + count * classes_);
+    begin_ += static_cast<int>(count / width_);
+  }
+
+  Tensor& labels() { return labels_; }
+
+ private:
+  template <typename T>
+  Result<void> Vote(const T* src, int height, int width, int top, int left) {
+    for (int i = 0; i < height; ++i, src += width) {
+      auto dst = Row(top + i) + static_cast<size_t>(left) * classes_;
+      for (int j = 0; j < width; ++j) {
+        auto label = static_cast<int>(src[j]);
+        if (label < 0 || label >= classes_) {
+          MMDEPLOY_ERROR("label {} out of range [0, {})", label, classes_);
+          return Status(eInvalidArgument);
+        }
+        dst[j * classes_ + label] += 1.f;
+      }
+    }
+    return success();
+  }
+
+  float* Row(int row) {
+    return scores_.data() + static_cast<size_t>(row - begin_) * width_ * classes_;
+  }
+
+  void Extend(int end) {
+    auto size = static_cast<size_t>(end - begin_) * width_ * classes_;
+    if (size > scores_.size()) {
+      scores_.resize(size);
+    }
+  }
+
+  Tensor labels_;
+  int width_;
+  int classes_;
+  int begin_{};
+  std::vector<float> scores_;
+};
+
+}  // namespace
+
+// Sliding-window inference, which matches the "slide" test mode of mmseg. Windows of the input are
+// forwarded in batches by the "Net" module and the window outputs are accumulated to the label
+// map of the whole input, which is passed on as the `output` of the net. Up to `max_in_flight`
+// batches are forwarded at the same time, the outputs of the finished batches are accumulated
+// while the others are running. Tasks created by this module take the config of the "Net" module
+// with the additional keys
+//   "crop_size": [h, w] of the windows
+//   "stride": [h, w] of the strides between the windows
+//   "num_classes": number of classes, required by the nets outputting labels instead of logits
+//   "batch_size": number of windows forwarded together, 1 by default
+//   "max_in_flight": max number of batches forwarded at the same time, 2 by default
+//   "net": type of the module forwarding the windows, "Net" by default
+class SlidingSegmentor : public Module {
+ public:
+  explicit SlidingSegmentor(const Value& cfg) : net_(CreateNet(cfg)) {
+    stream_ = cfg["context"]["stream"].get<Stream>();
+    try {
+      crop_size_ = {cfg["crop_size"][0].get<int>(), cfg["crop_size"][1].get<int>()};
+      stride_ = {cfg["stride"][0].get<int>(), cfg["stride"][1].get<int>()};
+    } catch (const std::exception& e) {
+      MMDEPLOY_ERROR("no valid 'crop_size' and 'stride' in config: {}", cfg);
+      throw_exception(eInvalidArgument);
+    }
+    num_classes_ = cfg.value("num_classes", num_classes_);
+    batch_size_ = cfg.value("batch_size", batch_size_);
+    max_in_flight_ = cfg.value("max_in_flight", max_in_flight_);
+    if (std::min({crop_size_[0], crop_size_[1], stride_[0], stride_[1], batch_size_,
+                  max_in_flight_}) < 1) {
+      MMDEPLOY_ERROR("invalid sliding window, crop_size: {}x{}, stride: {}x{}, batch_size: {}, "
+                     "max_in_flight: {}",
+                     crop_size_[0], crop_size_[1], stride_[0], stride_[1], batch_size_,
+                     max_in_flight_);
+      throw_exception(eInvalidArgument);
+    }
+  }
+
+  Result<Value> Process(const Value& args) override {
+    auto img = args[0]["img"].get<Tensor>();
+    if (img.shape().size() != 4 || img.shape(0) != 1 || img.data_type() != DataType::kFLOAT) {
+      MMDEPLOY_ERROR("unsupported `img` tensor, shape: {}, dtype: {}", img.shape(),
+                     (int)img.data_type());
+      return Status(eNotSupported);
+    }
+    OUTCOME_TRY(auto input, MakeAvailableOnDevice(img, kHOST, stream_));
+    OUTCOME_TRY(stream_.Wait());
+
+    auto height = static_cast<int>(input.shape(2));
+    auto width = static_cast<int>(input.shape(3));
+    auto crop_h = std::min(crop_size_[0], height);
+    auto crop_w = std::min(crop_size_[1], width);
+    std::vector<std::pair<int, int>> windows;
+    for (auto y : GetWindowOffsets(height, crop_h, stride_[0])) {
+      for (auto x : GetWindowOffsets(width, crop_w, stride_[1])) {
+        windows.emplace_back(y, x);
+      }
+    }
+    auto batch_count = (windows.size() + batch_size_ - 1) / batch_size_;
+    auto batch_begin = [&](size_t batch) { return batch * batch_size_; };
+    auto batch_end = [&](size_t batch) {
+      return std::min(windows.size(), (batch + 1) * batch_size_);
+    };
+
+    // the completions are delivered on the threads of the backend
+    auto state = std::make_shared<State>();
+    auto submit = [&](size_t batch) {
+      Value::Array samples;
+      for (auto i = batch_begin(batch); i < batch_end(batch); ++i) {
+        auto [y, x] = windows[i];
+        samples.push_back({{"img", CropTensor(input, y, x, crop_h, crop_w)}});
+      }
+      net_->ProcessAsync(Value(Value::Array{Value(std::move(samples))}),
+                         [state, batch](Result<Value> output) {
+                           std::lock_guard lock{state->mutex};
+                           state->done.emplace_back(batch, std::move(output));
+                           state->cv.notify_one();
+                         });
+    };
+
+    std::optional<Canvas> canvas;
+    std::vector<bool> finished(batch_count);
+    size_t submitted = 0;
+    size_t in_flight = 0;
+    size_t first_unfinished = 0;
+    auto max_in_flight = static_cast<size_t>(max_in_flight_);
+    Result<void> status = success();
+    while (in_flight || (status && submitted < batch_count)) {
+      for (; status && submitted < batch_count && in_flight < max_in_flight; ++submitted) {
+        submit(submitted);
+        ++in_flight;
+      }
+      std::unique_lock lock{state->mutex};
+      state->cv.wait(lock, [&] { return !state->done.empty(); });
+      auto [batch, output] = std::move(state->done.front());
+      state->done.pop_front();
+      lock.unlock();
+      --in_flight;
+      if (!status) {
+        continue;
+      }
+      if (!output) {
+        status = std::move(output).as_failure();
+        continue;
+      }
+      status = Accumulate(output.value()[0], windows, batch_begin(batch), crop_h, crop_w, canvas,
+                          height, width);
+      finished[batch] = true;
+      while (first_unfinished < batch_count && finished[first_unfinished]) {
+        ++first_unfinished;
+      }
+      if (status) {
+        // rows above the first unfinished window are complete
+        auto limit = first_unfinished < batch_count ? windows[batch_begin(first_unfinished)].first
+                                                    : height;
+        canvas->Flush(limit);
+      }
+    }
+    OUTCOME_TRY(std::move(status));
+    return Value(Value::Array{Value{{"output", canvas->labels()}}});
+  }
+
+ private:
+  struct State {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::pair<size_t, Result<Value>>> done;
+  };
+
+  Result<void> Accumulate(const Value& outputs, const std::vector<std::pair<int, int>>& windows,
+                          size_t offset, int crop_h, int crop_w, std::optional<Canvas>& canvas,
+                          int height, int width) {
+    std::vector<Tensor> tensors;
+    for (const auto& output : outputs) {
+      OUTCOME_TRY(auto tensor, MakeAvailableOnDevice(output["output"].get<Tensor>(), kHOST,
+                                                     stream_));
+      tensors.push_back(std::move(tensor));
+    }
+    OUTCOME_TRY(stream_.Wait());
+    for (size_t i = 0; i < tensors.size(); ++i) {
+      auto& shape = tensors[i].shape();
+      if (shape.size() != 4 || shape[0] != 1) {
+        MMDEPLOY_ERROR("unsupported `output` tensor, shape: {}", shape);
+        return Status(eNotSupported);
+      }
+      if (!canvas) {
+        // the number of classes of the logits is known from the first output
+        auto classes = shape[1] > 1 ? static_cast<int>(shape[1]) : num_classes_;
+        if (classes < 1) {
+          MMDEPLOY_ERROR("'num_classes' is required for the net outputting labels");
+          return Status(eInvalidArgument);
+        }
+        canvas.emplace(height, width, classes);
+      }
+      auto [y, x] = windows[offset + i];
+      OUTCOME_TRY(canvas->Add(tensors[i], y, x, crop_h, crop_w));
+    }
+    return success();
+  }
+
+  std::unique_ptr<Module> net_;
+  Stream stream_;
+  std::array<int, 2> crop_size_{};
+  std::array<int, 2> stride_{};
+  int num_classes_{};
+  int batch_size_{1};
+  int max_in_flight_{2};
+};
+
+class SlidingSegmentorCreator : public Creator<Module> {
+ public:
+  const char* GetName() const override { return "SlidingSegmentor"; }
+  int GetVersion() const override { return 0; }
+  std::unique_ptr<Module> Create(const Value& cfg) override {
+    return std::make_unique<SlidingSegmentor>(cfg);
+  }
+};
+
+REGISTER_MODULE(Module, SlidingSegmentorCreator);
+
+}  // namespace mmdeploy::mmseg
@@ -30,6 +30,8 @@ class AllocatorImpl;
 class BufferImpl;
 class KernelImpl;
 
+class Value;
+
 template <typename T>
 using optional = std::optional<T>;
 
@@ -247,12 +249,43 @@ T GetNative(Kernel &kernel, ErrorCode *ec = nullptr) {
   return reinterpret_cast<T>(kernel.GetNative(ec));
 }
 
+// counters of an allocator since its creation
+struct AllocatorStats {
+  // allocations requested from the allocator
+  size_t allocation_count{};
+  // allocations that missed the cache of the allocator and went to the upstream allocator
+  size_t upstream_allocation_count{};
+  // size of the blocks in use
+  size_t in_use_bytes{};
+  // size of the freed blocks kept for reuse
+  size_t cached_bytes{};
+  // peak size of the memory held from the upstream allocator
+  size_t peak_bytes{};
+
+  // fraction of the allocations served from the cache
+  double hit_rate() const noexcept {
+    return allocation_count ? 1. - static_cast<double>(upstream_allocation_count) /
+                                       static_cast<double>(allocation_count)
+                            : 0.;
+  }
+};
+
 class MMDEPLOY_API Allocator {
   friend class Access;
 
  public:
   Allocator() = default;
 
+  // creates an allocator as specified by `config`, e.g. {"type": "arena", "pool_size": 16}, throws
+  // if the platform doesn't support it
+  Allocator(Device device, const Value &config);
+
+  // the allocator used by buffers created without one, may be empty
+  static Allocator GetDefault(Device device);
+
+  // eNotSupported if the allocator doesn't keep the counters
+  Result<AllocatorStats> GetStats() const;
+
   explicit operator bool() const noexcept { return static_cast<bool>(impl_); }
 
  private:
@@ -54,6 +54,31 @@ Platform::Platform(int platform_id) {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Allocator
+
+Allocator::Allocator(Device device, const Value& config) {
+  if (auto p = GetPlatformImpl(device)) {
+    *this = p->CreateAllocator(device.device_id(), config).value();
+  } else {
+    throw_exception(eInvalidArgument);
+  }
+}
+
+Allocator Allocator::GetDefault(Device device) {
+  if (auto p = GetPlatformImpl(device)) {
+    return p->GetDefaultAllocator(device.device_id());
+  }
+  return {};
+}
+
+Result<AllocatorStats> Allocator::GetStats() const {
+  if (!impl_) {
+    return Status(eInvalidArgument);
+  }
+  return impl_->GetStats();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Buffer
 
@@ -46,6 +46,12 @@ class PlatformImpl {
 
   virtual Result<Stream> GetDefaultStream(int32_t device_id) = 0;
 
+  virtual Allocator GetDefaultAllocator(int32_t device_id) { return {}; }
+
+  virtual Result<Allocator> CreateAllocator(int32_t device_id, const Value& config) {
+    return Status(eNotSupported);
+  }
+
  protected:
   int platform_id_;
 };
@@ -62,6 +68,7 @@ class AllocatorImpl {
   virtual void Deallocate(Block& block) noexcept = 0;
   virtual bool Owns(const Block& block) const noexcept = 0;
   virtual const char* Name() const noexcept { return ""; }
+  virtual Result<AllocatorStats> GetStats() const { return Status(eNotSupported); }
   //  virtual Device device() const noexcept = 0;
 };
 
@@ -20,6 +20,26 @@ Result<void> NodeParser::Parse(const Value& config, Node& node) {
   }
 }
 
+const NodeError* FindError(const Value& values) {
+  if (auto error = values.get_ptr<const NodeError*>()) {
+    return error;
+  }
+  if (values.is_array()) {
+    for (const auto& v : values) {
+      if (auto error = v.get_ptr<const NodeError*>()) {
+        return error;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void ThrowIfError(const Value& values) {
+  if (auto error = FindError(values)) {
+    throw_exception(error->ec);
+  }
+}
+
 }  // namespace graph
 
 MMDEPLOY_DEFINE_REGISTRY(graph::Node);
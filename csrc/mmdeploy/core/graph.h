@@ -44,8 +44,26 @@ class MMDEPLOY_API NodeParser {
   static Result<void> Parse(const Value& config, Node& node);
 };
 
+// Failure of a node completed on a thread that can't throw, e.g. a module completed by the callback
+// of its backend. It takes the place of each output of the node, the nodes depending on the outputs
+// are skipped and the error is raised where the outputs of the pipeline are waited for.
+struct NodeError {
+  ErrorCode ec;
+};
+
+// returns the error in `values` (the array of the inputs or outputs of a node), nullptr if none
+MMDEPLOY_API const NodeError* FindError(const Value& values);
+
+// throws the error in `values` if any
+MMDEPLOY_API void ThrowIfError(const Value& values);
+
 }  // namespace graph
 
+template <>
+struct is_cast_by_erasure<graph::NodeError> : std::true_type {};
+
+MMDEPLOY_REGISTER_TYPE_ID(graph::NodeError, 11);
+
 MMDEPLOY_DECLARE_REGISTRY(graph::Node);
 
 }  // namespace mmdeploy
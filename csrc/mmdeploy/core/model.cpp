@@ -2,6 +2,17 @@
 
 #include "model.h"
 
+#include <atomic>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
 #include "mmdeploy/core/logger.h"
 #include "mmdeploy/core/model_impl.h"
 #include "mmdeploy/core/utils/filesystem.h"
@@ -10,6 +21,63 @@ using namespace std;
 
 namespace mmdeploy {
 
+FileView::FileView(std::string content) {
+  auto holder = std::make_shared<std::string>(std::move(content));
+  data_ = holder->data();
+  size_ = holder->size();
+  holder_ = std::move(holder);
+}
+
+#ifndef _WIN32
+
+Result<FileView> FileView::Map(const std::string& path) {
+  auto fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    MMDEPLOY_ERROR("failed to open {}", path);
+    return Status(eFileNotExist);
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    MMDEPLOY_ERROR("failed to get the size of {}", path);
+    return Status(eFail);
+  }
+  auto size = static_cast<size_t>(st.st_size);
+  if (size == 0) {
+    close(fd);
+    return FileView(std::string{});
+  }
+  auto addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping stays valid after the descriptor is closed
+  close(fd);
+  if (addr == MAP_FAILED) {
+    MMDEPLOY_ERROR("failed to map {} into memory", path);
+    return Status(eFail);
+  }
+  std::shared_ptr<const void> holder(addr, [size](const void* p) {
+    munmap(const_cast<void*>(p), size);
+  });
+  return FileView(std::move(holder), static_cast<const char*>(addr), size);
+}
+
+#else
+
+Result<FileView> FileView::Map(const std::string& path) {
+  std::ifstream ifs(path, std::ios::binary | std::ios::in);
+  if (!ifs.is_open()) {
+    MMDEPLOY_ERROR("failed to open {}", path);
+    return Status(eFileNotExist);
+  }
+  ifs.seekg(0, std::ios::end);
+  auto size = ifs.tellg();
+  ifs.seekg(0, std::ios::beg);
+  std::string content(size, '\0');
+  ifs.read(content.data(), size);
+  return FileView(std::move(content));
+}
+
+#endif
+
 Model::Model(const std::string& model_path) {
   if (auto r = Model::Init(model_path); !r) {
     MMDEPLOY_ERROR("load model failed. Its file path is '{}'", model_path);
@@ -38,6 +106,9 @@ Result<void> Model::Init(const std::string& model_path) {
     MMDEPLOY_INFO("{} successfully load model {}", entry.name, model_path);
     impl_ = std::move(impl);
     meta_ = std::move(meta);
+    std::error_code ec;
+    auto path = fs::canonical(model_path, ec);
+    identity_ = ec ? model_path : path.string();
     return success();
   }
 
@@ -59,6 +130,9 @@ Result<void> Model::Init(const void* buffer, size_t size) {
     MMDEPLOY_INFO("Successfully load model {}", entry.name);
     impl_ = std::move(impl);
     meta_ = std::move(meta);
+    // models loaded from memory are never considered the same
+    static std::atomic<uint64_t> count{};
+    identity_ = "<buffer " + std::to_string(++count) + ">";
     return success();
   }
 
@@ -80,6 +154,10 @@ Result<std::string> Model::ReadFile(const std::string& file_path) noexcept {
   return impl_->ReadFile(file_path);
 }
 
+Result<FileView> Model::MapFile(const std::string& file_path) noexcept {
+  return impl_->MapFile(file_path);
+}
+
 ModelRegistry& ModelRegistry::Get() {
   static ModelRegistry inst;
   return inst;
@@ -32,6 +32,50 @@ struct deploy_meta_info_t {
 
 class ModelImpl;
 
+/**
+ * @class FileView
+ * @brief Read-only view of a file's content. It's backed by a memory mapping of the file when
+ * possible, or else by a copy of the content. The memory stays valid as long as any copy of the
+ * view exists.
+ */
+class MMDEPLOY_API FileView {
+ public:
+  FileView() = default;
+
+  /**
+   * @brief construct a view owning `content`
+   */
+  explicit FileView(std::string content);
+
+  /**
+   * @brief construct a view of `size` bytes at `data`, which is kept valid by `holder`
+   */
+  FileView(std::shared_ptr<const void> holder, const char* data, size_t size)
+      : holder_(std::move(holder)), data_(data), size_(size) {}
+
+  /**
+   * @brief map the file at `path` into memory, its content is read into a buffer on platforms
+   * without `mmap`
+   */
+  static Result<FileView> Map(const std::string& path);
+
+  const char* data() const noexcept { return data_; }
+  size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+
+  /**
+   * @brief view of `size` bytes starting at `offset`, which shares the backing memory
+   */
+  FileView Slice(size_t offset, size_t size) const { return {holder_, data_ + offset, size}; }
+
+  std::string str() const { return {data_, size_}; }
+
+ private:
+  std::shared_ptr<const void> holder_;
+  const char* data_{};
+  size_t size_{};
+};
+
 /**
  * @class Model
  * @brief Read sdk model from file.
@@ -82,12 +126,27 @@ class MMDEPLOY_API Model {
    */
   Result<std::string> ReadFile(const std::string& file_path) noexcept;
 
+  /**
+   * @brief Get a read-only view of specified file in an sdk model without copying it when
+   * possible, which is preferred for large files like engines and weights
+   * @param file_path path relative to the root directory of an sdk model.
+   * @return view of the file's content if success
+   */
+  Result<FileView> MapFile(const std::string& file_path) noexcept;
+
   /**
    * @brief get meta information of an sdk model
    * @return sdk model's meta information
    */
   const deploy_meta_info_t& meta() const { return meta_; }
 
+  /**
+   * @brief identity of an sdk model, which is the canonical path of a model loaded from a path or
+   * a process-unique tag of a model loaded from memory
+   * @return the identity, it's shared by the copies of an instance of `Model`
+   */
+  const std::string& identity() const { return identity_; }
+
   /**
    * @brief Check if an instance of `Model` is valid
    * @return the status of an instance of `Model`
@@ -97,6 +156,7 @@ class MMDEPLOY_API Model {
  private:
   std::shared_ptr<ModelImpl> impl_;
   deploy_meta_info_t meta_;
+  std::string identity_;
 };
 
 /**
@@ -44,6 +44,17 @@ class ModelImpl {
    */
   virtual Result<std::string> ReadFile(const std::string& file_path) const = 0;
 
+  /**
+   * @brief Get a read-only view of specified file from an sdk model. Implementations should map
+   * the file instead of copying it when possible, the default one wraps the result of `ReadFile`
+   * @param file_path path relative to the root directory of an sdk model.
+   * @return view of the file's content if success
+   */
+  virtual Result<FileView> MapFile(const std::string& file_path) const {
+    OUTCOME_TRY(auto content, ReadFile(file_path));
+    return FileView(std::move(content));
+  }
+
   /**
    * @brief get meta information of an sdk model
    * @return sdk model's meta information
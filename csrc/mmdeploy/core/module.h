@@ -3,6 +3,8 @@
 #ifndef MMDEPLOY_SRC_CORE_MODULE_H_
 #define MMDEPLOY_SRC_CORE_MODULE_H_
 
+#include <functional>
+
 #include "mmdeploy/core/macro.h"
 #include "mmdeploy/core/registry.h"
 #include "mmdeploy/core/status_code.h"
@@ -14,6 +16,12 @@ class MMDEPLOY_API Module {
  public:
   virtual ~Module() = default;
   virtual Result<Value> Process(const Value& args) = 0;
+
+  // Asynchronous version of `Process`, `done` is invoked with the result on the thread completing
+  // the work, which is the calling thread for modules without asynchronous implementation.
+  virtual void ProcessAsync(const Value& args, std::function<void(Result<Value>)> done) {
+    done(Process(args));
+  }
 };
 
 MMDEPLOY_DECLARE_REGISTRY(Module);
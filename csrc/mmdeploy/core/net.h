@@ -3,6 +3,9 @@
 #ifndef MMDEPLOY_SRC_CORE_NET_H_
 #define MMDEPLOY_SRC_CORE_NET_H_
 
+#include <functional>
+#include <memory>
+
 #include "mpl/span.h"
 #include "registry.h"
 #include "tensor.h"
@@ -19,7 +22,34 @@ class Net {
   virtual Result<Span<Tensor>> GetOutputTensors() = 0;
   virtual Result<void> Reshape(Span<TensorShape> input_shapes) = 0;
   virtual Result<void> Forward() = 0;
-  virtual Result<void> ForwardAsync(Event* event) = 0;
+
+  // Optional asynchronous forward. Start the inference and return without waiting for it, `done`
+  // is invoked with the outcome, possibly on a thread of the backend, once the outputs are ready.
+  // The inputs (bound or not) must stay untouched and no other call may be made on the net until
+  // then. Returns eNotSupported without invoking `done` when the backend can't run asynchronously,
+  // the caller shall use `Forward` instead.
+  virtual Result<void> ForwardAsync(std::function<void(Result<void>)> done) {
+    return Status(eNotSupported);
+  }
+
+  // Optional. Create another execution context of the net, i.e. an instance sharing the weights
+  // and the compiled model with this one, but with I/O tensors & execution state of its own and
+  // using `stream`, so that both can forward concurrently. Returns eNotSupported when the backend
+  // can't share the model, the caller may create an independent instance instead.
+  virtual Result<std::unique_ptr<Net>> CreateExecutionContext(Stream stream) {
+    return Status(eNotSupported);
+  }
+
+  // Optional zero-copy input binding. Let the next `Forward` read from caller-owned tensors
+  // instead of the tensors from `GetInputTensors`. The tensors must match the reshaped input
+  // tensors and stay alive until `Forward` returns, the binding is reset afterwards. Returns
+  // eNotSupported when the backend can't read from them, the caller shall copy the data instead.
+  virtual Result<void> BindInputs(Span<Tensor> inputs) { return Status(eNotSupported); }
+
+  // Optional zero-copy output. Hand out the outputs of the last `Forward` by reference, the
+  // returned tensors keep their buffers alive and the backend never writes to them again. Returns
+  // eNotSupported when the backend reuses its output buffers, the caller shall copy the data.
+  virtual Result<std::vector<Tensor>> TakeOutputs() { return Status(eNotSupported); }
 };
 
 MMDEPLOY_DECLARE_REGISTRY(Net);
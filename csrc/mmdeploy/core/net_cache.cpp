@@ -0,0 +1,233 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+#include "mmdeploy/core/net_cache.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "mmdeploy/archive/json_archive.h"
+#include "mmdeploy/core/logger.h"
+#include "mmdeploy/core/utils/formatter.h"
+
+namespace mmdeploy {
+
+NetCache& NetCache::Get() {
+  static NetCache inst;
+  return inst;
+}
+
+namespace {
+
+// keys of the net config handled by the graph, the net module & the modules composed of it (e.g.
+// TiledRestorer & SlidingSegmentor) instead of the backend
+constexpr const char* kModuleKeys[] = {"context", "name", "type", "module", "input", "output",
+                                       "input_map", "output_map", "num_contexts", "output_buffers",
+                                       "batch_padding", "is_batched", "is_thread_safe",
+                                       "max_concurrency", "tile_size", "tile_overlap", "batch_size",
+                                       "crop_size", "stride", "num_classes", "max_in_flight",
+                                       "net"};
+
+// the backend options in `cfg`, formatted in the order of the keys
+std::string GetBackendOptions(const Value& cfg) {
+  std::vector<std::pair<std::string, const Value*>> options;
+  for (auto it = cfg.begin(); it != cfg.end(); ++it) {
+    auto key = it.key();
+    if (std::find(std::begin(kModuleKeys), std::end(kModuleKeys), key) == std::end(kModuleKeys)) {
+      options.emplace_back(std::move(key), &*it);
+    }
+  }
+  std::sort(options.begin(), options.end());
+  std::string str;
+  for (const auto& [key, value] : options) {
+    str += fmt::format("{}: {}\n", key, *value);
+  }
+  return str;
+}
+
+// collects the configs of the tasks running the nets of `names` in the pipeline config `cfg`
+void FindNetConfigs(const Value& cfg, const std::vector<std::string>& names,
+                    std::vector<Value>& net_cfgs) {
+  if (cfg.is_object()) {
+    if (cfg.contains("module") && cfg.contains("name") && cfg["name"].is_string() &&
+        std::count(names.begin(), names.end(), cfg["name"].get<std::string>())) {
+      net_cfgs.push_back(cfg);
+      return;
+    }
+    for (auto it = cfg.begin(); it != cfg.end(); ++it) {
+      FindNetConfigs(*it, names, net_cfgs);
+    }
+  } else if (cfg.is_array()) {
+    for (const auto& x : cfg) {
+      FindNetConfigs(x, names, net_cfgs);
+    }
+  }
+}
+
+}  // namespace
+
+Result<std::shared_ptr<NetCache::Entry>> NetCache::GetEntry(const Value& cfg) {
+  auto& context = cfg["context"];
+  auto name = cfg["name"].get<std::string>();
+  auto model = context["model"].get<Model>();
+  auto device = context["device"].get<Device>();
+  OUTCOME_TRY(auto config, model.GetModelConfig(name));
+  Key key{model.identity(), name, config.backend, device.platform_id(), device.device_id(),
+          config.precision, GetBackendOptions(cfg)};
+  std::lock_guard lock{mutex_};
+  Sweep();
+  auto& entry = entries_[key];
+  if (!entry) {
+    entry = std::make_shared<Entry>();
+  }
+  return entry;
+}
+
+Result<std::unique_ptr<Net>> NetCache::Create(Creator<Net>& creator, const Value& cfg,
+                                              std::shared_ptr<Net>& model) {
+  model.reset();
+  OUTCOME_TRY(auto entry, GetEntry(cfg));
+  auto stream = cfg["context"]["stream"].get<Stream>();
+  auto create = [&]() -> Result<std::unique_ptr<Net>> {
+    auto net = creator.Create(cfg);
+    if (!net) {
+      MMDEPLOY_ERROR("failed to create net, config: {}", cfg);
+      return Status(eFail);
+    }
+    return net;
+  };
+  // expected for the backends without execution contexts, the entry remembers it from now on
+  auto not_shareable = [&] {
+    MMDEPLOY_INFO("backend {} can't share the model between nets, {} is loaded per net",
+                  creator.GetName(), cfg["name"].get<std::string>());
+    entry->shareable = false;
+    entry->pinned.reset();
+  };
+
+  std::lock_guard lock{entry->mutex};
+  if (!entry->shareable) {
+    return create();
+  }
+  if (auto shared = entry->net.lock()) {
+    auto net = shared->CreateExecutionContext(stream);
+    if (net) {
+      model = std::move(shared);
+      return net;
+    }
+    if (!(net.error() == eNotSupported)) {
+      return std::move(net).as_failure();
+    }
+    // pinned by `Warmup` before the backend is known to be not shareable
+    not_shareable();
+    return create();
+  }
+  OUTCOME_TRY(auto loaded, create());
+  auto net = loaded->CreateExecutionContext(stream);
+  if (!net) {
+    if (!(net.error() == eNotSupported)) {
+      return std::move(net).as_failure();
+    }
+    not_shareable();
+    // the loaded net is the only one using the model, it's handed out directly
+    return loaded;
+  }
+  model = std::move(loaded);
+  entry->net = model;
+  return net;
+}
+
+Result<void> NetCache::Warmup(const Model& model, const Device& device) {
+  std::vector<std::string> names;
+  for (const auto& info : model.meta().models) {
+    names.push_back(info.name);
+  }
+  // the nets are configured by the tasks of the pipeline, whose backend options are in the keys
+  std::vector<Value> net_cfgs;
+  if (auto pipeline_json = Model(model).ReadFile("pipeline.json")) {
+    try {
+      FindNetConfigs(from_json<Value>(nlohmann::json::parse(pipeline_json.value())), names,
+                     net_cfgs);
+    } catch (const std::exception& e) {
+      MMDEPLOY_ERROR("failed to parse pipeline.json: {}", e.what());
+      return Status(eInvalidArgument);
+    }
+  }
+  // nets not configured by the pipeline get the default options
+  for (const auto& name : names) {
+    if (std::none_of(net_cfgs.begin(), net_cfgs.end(),
+                     [&](const Value& cfg) { return cfg["name"].get<std::string>() == name; })) {
+      net_cfgs.push_back(Value{{"name", name}});
+    }
+  }
+  for (auto& cfg : net_cfgs) {
+    OUTCOME_TRY(auto config, model.GetModelConfig(cfg["name"].get<std::string>()));
+    auto creator = Registry<Net>::Get().GetCreator(config.backend);
+    if (!creator) {
+      MMDEPLOY_ERROR("Net backend not found: {}, available backends: {}", config.backend,
+                     Registry<Net>::Get().List());
+      return Status(eEntryNotFound);
+    }
+    cfg["context"] = {{"model", model}, {"device", device}, {"stream", Stream::GetDefault(device)}};
+    OUTCOME_TRY(auto entry, GetEntry(cfg));
+    std::lock_guard lock{entry->mutex};
+    if (!entry->shareable) {
+      continue;
+    }
+    auto net = entry->net.lock();
+    if (!net) {
+      net = creator->Create(cfg);
+      if (!net) {
+        MMDEPLOY_ERROR("failed to create net, config: {}", cfg);
+        return Status(eFail);
+      }
+      entry->net = net;
+    }
+    entry->pinned = std::move(net);
+  }
+  return success();
+}
+
+void NetCache::Evict(const Model& model) {
+  std::lock_guard lock{mutex_};
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (std::get<0>(it->first) == model.identity()) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void NetCache::Sweep() {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    // entries held by others are being used to load nets or to create execution contexts
+    auto& entry = it->second;
+    if (entry.use_count() == 1) {
+      std::lock_guard entry_lock{entry->mutex};
+      if (entry->net.expired()) {
+        it = entries_.erase(it);
+        continue;
+      }
+    }
+    ++it;
+  }
+}
+
+void NetCache::Clear() {
+  std::lock_guard lock{mutex_};
+  entries_.clear();
+}
+
+size_t NetCache::size() {
+  std::lock_guard lock{mutex_};
+  Sweep();
+  size_t count = 0;
+  for (auto& [key, entry] : entries_) {
+    std::lock_guard entry_lock{entry->mutex};
+    count += !entry->net.expired();
+  }
+  return count;
+}
+
+}  // namespace mmdeploy
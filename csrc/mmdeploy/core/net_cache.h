@@ -0,0 +1,94 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+#ifndef MMDEPLOY_CSRC_CORE_NET_CACHE_H_
+#define MMDEPLOY_CSRC_CORE_NET_CACHE_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "mmdeploy/core/macro.h"
+#include "mmdeploy/core/model.h"
+#include "mmdeploy/core/net.h"
+
+namespace mmdeploy {
+
+/**
+ * Process-wide cache of loaded nets, so that the pipelines created from the same model on the same
+ * device share the weights & the compiled sessions of the backend instead of loading copies of
+ * their own.
+ *
+ * An entry is keyed by (model identity, net name, backend, device, precision, backend options),
+ * where the backend options are the keys of the net config other than the ones of the graph & the
+ * net module, e.g. the number of threads of the backend. It holds a loaded net that is never
+ * forwarded, the users get execution contexts of it (see `Net::CreateExecutionContext`). The
+ * loaded net is reference counted, it's released when the last user is gone unless it's pinned by
+ * `Warmup`, and the entries of the released nets are removed. Backends that can't share the model
+ * bypass the cache.
+ */
+class MMDEPLOY_API NetCache {
+ public:
+  static NetCache& Get();
+
+  /**
+   * @brief create a net of `cfg` with `creator`, sharing the model with the other nets of the
+   * same entry
+   * @param cfg config of the net, `cfg["context"]` contains "model", "device" & "stream". The net
+   * uses the stream.
+   * @param model receives the shared net, which the caller must hold while the created net is in
+   * use. It's null when the backend can't share the model, the net is an independent instance then.
+   */
+  Result<std::unique_ptr<Net>> Create(Creator<Net>& creator, const Value& cfg,
+                                      std::shared_ptr<Net>& model);
+
+  /**
+   * @brief load all the nets of `model` on `device` into the cache, they stay in the cache until
+   * evicted. The nets are configured as the tasks running them in the pipeline.json of `model`, so
+   * that they are found by the handles created from the model
+   */
+  Result<void> Warmup(const Model& model, const Device& device);
+
+  /**
+   * @brief remove the entries of `model` from the cache, the nets in use are not affected
+   */
+  void Evict(const Model& model);
+
+  /**
+   * @brief remove all entries
+   */
+  void Clear();
+
+  /**
+   * @brief number of the nets held by the cache, loaded and not yet released
+   */
+  size_t size();
+
+ private:
+  NetCache() = default;
+
+  // model identity, net name, backend, platform id, device id, precision, backend options
+  using Key =
+      std::tuple<std::string, std::string, std::string, int, int, std::string, std::string>;
+
+  struct Entry {
+    // locked while loading the net or creating execution contexts from it
+    std::mutex mutex;
+    std::weak_ptr<Net> net;
+    std::shared_ptr<Net> pinned;
+    bool shareable{true};
+  };
+
+  Result<std::shared_ptr<Entry>> GetEntry(const Value& cfg);
+
+  // remove the entries of the released nets, `mutex_` must be held
+  void Sweep();
+
+  std::mutex mutex_;
+  std::map<Key, std::shared_ptr<Entry>> entries_;
+};
+
+}  // namespace mmdeploy
+
+#endif  // MMDEPLOY_CSRC_CORE_NET_CACHE_H_
@@ -0,0 +1,212 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+#include "mmdeploy/core/profiler.h"
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mmdeploy/archive/json_archive.h"
+#include "mmdeploy/core/logger.h"
+
+namespace mmdeploy {
+
+namespace {
+
+// log-scale histogram with 4 buckets per power of 2, quantiles are accurate within ~19%
+class Histogram {
+ public:
+  void Add(double value) {
+    ++count_;
+    sum_ += value;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    ++buckets_[GetBucket(value)];
+  }
+
+  double Quantile(double q) const {
+    auto rank = static_cast<size_t>(std::ceil(q * static_cast<double>(count_)));
+    size_t acc = 0;
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+      acc += buckets_[i];
+      if (acc >= rank) {
+        return std::clamp(std::exp2((i + 1) / 4.) - 1, min_, max_);
+      }
+    }
+    return max_;
+  }
+
+  Value ToValue() const {
+    return {{"count", count_}, {"sum", sum_},          {"mean", sum_ / count_},
+            {"min", min_},     {"max", max_},          {"p50", Quantile(.5)},
+            {"p90", Quantile(.9)}, {"p99", Quantile(.99)}};
+  }
+
+ private:
+  static constexpr size_t kBuckets = 128;
+
+  static size_t GetBucket(double value) {
+    auto index = static_cast<int>(4 * std::log2(1 + std::max(value, 0.)));
+    return std::min(static_cast<size_t>(index), kBuckets - 1);
+  }
+
+  size_t count_{};
+  double sum_{};
+  double min_{std::numeric_limits<double>::max()};
+  double max_{std::numeric_limits<double>::lowest()};
+  std::array<size_t, kBuckets> buckets_{};
+};
+
+}  // namespace
+
+struct Profiler::Impl {
+  struct Event {
+    std::string name;
+    const char* category;
+    double ts;
+    double dur;
+    int tid;
+    Value args;
+  };
+
+  Impl(std::string path, size_t max_events)
+      : path_(std::move(path)), max_events_(max_events), origin_(Now()) {}
+
+  ~Impl() {
+    for (const auto& [name, histogram] : histograms_) {
+      auto stats = histogram.ToValue();
+      MMDEPLOY_INFO("[profiler] {}: count={}, mean={:.1f}, p50={:.1f}, p99={:.1f}, max={:.1f}",
+                    name, stats["count"].get<size_t>(), stats["mean"].get<double>(),
+                    stats["p50"].get<double>(), stats["p99"].get<double>(),
+                    stats["max"].get<double>());
+    }
+    if (!path_.empty()) {
+      (void)Dump(path_);
+    }
+  }
+
+  static double Micros(TimePoint t0, TimePoint t1) {
+    return std::chrono::duration<double, std::micro>(t1 - t0).count();
+  }
+
+  void Record(const std::string& name, const char* category, TimePoint begin, TimePoint end,
+              Value args) {
+    std::lock_guard lock{mutex_};
+    auto dur = Micros(begin, end);
+    histograms_[name].Add(dur);
+    if (events_.size() < max_events_) {
+      events_.push_back({name, category, Micros(origin_, begin), dur, GetThreadIndex(),
+                         std::move(args)});
+    }
+  }
+
+  void Sample(const std::string& name, double value) {
+    std::lock_guard lock{mutex_};
+    histograms_[name].Add(value);
+  }
+
+  Value GetStats() {
+    std::lock_guard lock{mutex_};
+    Value stats = ValueType::kObject;
+    for (const auto& [name, histogram] : histograms_) {
+      stats[name] = histogram.ToValue();
+    }
+    return stats;
+  }
+
+  Result<void> Dump(const std::string& path) {
+    nlohmann::json trace_events = nlohmann::json::array();
+    {
+      std::lock_guard lock{mutex_};
+      for (const auto& e : events_) {
+        nlohmann::json event{{"name", e.name}, {"cat", e.category}, {"ph", "X"}, {"ts", e.ts},
+                             {"dur", e.dur},   {"pid", 0},          {"tid", e.tid}};
+        if (e.args.is_object()) {
+          event["args"] = to_json(e.args);
+        }
+        trace_events.push_back(std::move(event));
+      }
+    }
+    std::ofstream ofs(path);
+    if (!ofs.is_open()) {
+      MMDEPLOY_ERROR("failed to open {} for writing trace events", path);
+      return Status(eFileNotExist);
+    }
+    ofs << nlohmann::json{{"traceEvents", std::move(trace_events)}}.dump();
+    MMDEPLOY_INFO("[profiler] trace events written to {}", path);
+    return success();
+  }
+
+  // small indices for the threads, which are more readable than the hashes of thread ids
+  int GetThreadIndex() {
+    auto id = std::this_thread::get_id();
+    if (auto it = threads_.find(id); it != threads_.end()) {
+      return it->second;
+    }
+    auto index = static_cast<int>(threads_.size());
+    threads_.emplace(id, index);
+    return index;
+  }
+
+  std::string path_;
+  size_t max_events_;
+  TimePoint origin_;
+  std::mutex mutex_;
+  std::vector<Event> events_;
+  std::map<std::string, Histogram> histograms_;
+  std::map<std::thread::id, int> threads_;
+};
+
+Profiler::Profiler(const Value& config) {
+  auto path = config.is_object() ? config.value("path", std::string{}) : std::string{};
+  auto max_events = config.is_object() ? config.value("max_events", 1000000) : 1000000;
+  impl_ = std::make_shared<Impl>(std::move(path), static_cast<size_t>(std::max(0, max_events)));
+}
+
+Profiler Profiler::FromEnv() {
+  if (auto path = std::getenv("MMDEPLOY_PROFILER")) {
+    return Profiler(Value{{"path", path}});
+  }
+  return {};
+}
+
+Profiler Profiler::FromConfig(const Value& config) {
+  if (!config.contains("profiler")) {
+    return FromEnv();
+  }
+  auto& profiler_config = config["profiler"];
+  if (profiler_config.is_boolean() && !profiler_config.get<bool>()) {
+    return {};
+  }
+  return Profiler(profiler_config);
+}
+
+void Profiler::Record(const std::string& name, const char* category, TimePoint begin,
+                      TimePoint end, Value args) const {
+  if (impl_) {
+    impl_->Record(name, category, begin, end, std::move(args));
+  }
+}
+
+void Profiler::Sample(const std::string& name, double value) const {
+  if (impl_) {
+    impl_->Sample(name, value);
+  }
+}
+
+Value Profiler::GetStats() const { return impl_ ? impl_->GetStats() : Value(ValueType::kObject); }
+
+Result<void> Profiler::Dump(const std::string& path) const {
+  if (!impl_) {
+    return Status(eNotReady);
+  }
+  return impl_->Dump(path);
+}
+
+}  // namespace mmdeploy
@@ -0,0 +1,69 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+#ifndef MMDEPLOY_CSRC_CORE_PROFILER_H_
+#define MMDEPLOY_CSRC_CORE_PROFILER_H_
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "mmdeploy/core/macro.h"
+#include "mmdeploy/core/status_code.h"
+#include "mmdeploy/core/value.h"
+
+namespace mmdeploy {
+
+/**
+ * Collects the wall time of pipeline nodes & modules as trace events and aggregates them, together
+ * with samples of other quantities (e.g. batch size, bytes copied), into histograms.
+ *
+ * A default constructed profiler is disabled, the instrumented code checks it before taking any
+ * time point. An enabled profiler is passed to the nodes & modules by `context["profiler"]`. When
+ * the last copy of it is destroyed, the statistics are logged and the trace is written to the
+ * configured path in the Chrome trace event format (viewable in chrome://tracing or Perfetto).
+ */
+class MMDEPLOY_API Profiler {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using TimePoint = Clock::time_point;
+
+  Profiler() = default;
+
+  // config: {"path": "trace.json", "max_events": 1000000}, both are optional
+  explicit Profiler(const Value& config);
+
+  // creates an enabled profiler from the environment variable `MMDEPLOY_PROFILER` when it is set,
+  // its value is used as the trace path
+  static Profiler FromEnv();
+
+  // creates a profiler from `config["profiler"]` when it's present, which is either a config as
+  // above or a boolean, or else from the environment
+  static Profiler FromConfig(const Value& config);
+
+  explicit operator bool() const noexcept { return static_cast<bool>(impl_); }
+
+  static TimePoint Now() noexcept { return Clock::now(); }
+
+  // records the complete event `name` of `category` on the calling thread, and adds its duration
+  // to the histogram of `name`
+  void Record(const std::string& name, const char* category, TimePoint begin, TimePoint end,
+              Value args = {}) const;
+
+  // adds a sample to the histogram of `name`
+  void Sample(const std::string& name, double value) const;
+
+  // {name: {"count", "sum", "mean", "min", "max", "p50", "p90", "p99"}}, durations are in
+  // microseconds
+  Value GetStats() const;
+
+  // writes the recorded events in the Chrome trace event format
+  Result<void> Dump(const std::string& path) const;
+
+ private:
+  struct Impl;
+  std::shared_ptr<Impl> impl_;
+};
+
+}  // namespace mmdeploy
+
+#endif  // MMDEPLOY_CSRC_CORE_PROFILER_H_
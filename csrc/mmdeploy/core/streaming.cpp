@@ -0,0 +1,216 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+#include "mmdeploy/core/streaming.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "mmdeploy/core/logger.h"
+#include "mmdeploy/execution/just.h"
+#include "mmdeploy/execution/sync_wait.h"
+
+namespace mmdeploy::graph {
+
+struct StreamingPipeline::Impl {
+  struct Frame {
+    Value input;
+    Result<Value> output{Status(eNotReady)};
+    bool done{};
+    Profiler::TimePoint pushed;
+  };
+
+  Impl(Node& node, int max_in_flight, Profiler profiler)
+      : node_(node),
+        max_in_flight_(static_cast<size_t>(std::max(1, max_in_flight))),
+        profiler_(std::move(profiler)) {
+    // the profiler may be shared by the handle, the throughput is counted from here
+    if (profiler_) {
+      auto stages = profiler_.GetStats();
+      for (auto it = stages.begin(); it != stages.end(); ++it) {
+        base_counts_[it.key()] = (*it)["count"].get<double>();
+      }
+    }
+    workers_.reserve(max_in_flight_);
+    for (size_t i = 0; i < max_in_flight_; ++i) {
+      workers_.emplace_back([this] { Work(); });
+    }
+  }
+
+  ~Impl() {
+    {
+      std::lock_guard lock{mutex_};
+      pending_.clear();
+      closed_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  Result<void> Push(Value input) {
+    auto frame = std::make_shared<Frame>();
+    frame->input = std::move(input);
+    {
+      std::unique_lock lock{mutex_};
+      cv_.wait(lock, [&] { return closed_ || frames_.size() < max_in_flight_; });
+      if (closed_) {
+        return Status(eInvalidArgument);
+      }
+      frame->pushed = Profiler::Now();
+      if (!pushed_++) {
+        start_ = frame->pushed;
+      }
+      frames_.push_back(frame);
+      pending_.push_back(std::move(frame));
+    }
+    cv_.notify_all();
+    return success();
+  }
+
+  std::optional<Result<Value>> Pop() {
+    std::shared_ptr<Frame> frame;
+    {
+      std::unique_lock lock{mutex_};
+      cv_.wait(lock, [&] {
+        return (!frames_.empty() && frames_.front()->done) || (closed_ && frames_.empty());
+      });
+      if (frames_.empty()) {
+        return std::nullopt;
+      }
+      frame = std::move(frames_.front());
+      frames_.pop_front();
+      ++popped_;
+    }
+    // a slot of the window is released
+    cv_.notify_all();
+    return std::move(frame->output);
+  }
+
+  void Close() {
+    {
+      std::lock_guard lock{mutex_};
+      closed_ = true;
+    }
+    cv_.notify_all();
+  }
+
+  Value GetStats() const {
+    Value stats;
+    double elapsed{};
+    {
+      std::lock_guard lock{mutex_};
+      elapsed = pushed_ ? std::chrono::duration<double>(Profiler::Now() - start_).count() : 0.;
+      auto completed = completed_ ? static_cast<double>(completed_) : 1.;
+      stats = {{"pushed", pushed_},
+               {"popped", popped_},
+               {"failed", failed_},
+               {"in_flight", frames_.size()},
+               {"elapsed", elapsed},
+               {"fps", elapsed > 0 ? static_cast<double>(popped_) / elapsed : 0.},
+               {"latency", {{"mean", latency_sum_ / completed}, {"max", latency_max_}}}};
+    }
+    if (profiler_) {
+      auto stages = profiler_.GetStats();
+      for (auto it = stages.begin(); it != stages.end(); ++it) {
+        auto count = (*it)["count"].get<double>();
+        if (auto base = base_counts_.find(it.key()); base != base_counts_.end()) {
+          count -= base->second;
+        }
+        (*it)["throughput"] = elapsed > 0 ? count / elapsed : 0.;
+      }
+      stats["stages"] = std::move(stages);
+    }
+    return stats;
+  }
+
+  Result<Value> Run(Value input) {
+    try {
+      auto [output] = SyncWait(node_.Process(Just(std::move(input))));
+      if (auto error = graph::FindError(output)) {
+        return Status(error->ec);
+      }
+      return std::move(output);
+    } catch (const Exception& e) {
+      MMDEPLOY_ERROR("exception caught while processing a frame: {}", e.what());
+      return failure(e.code());
+    } catch (const std::exception& e) {
+      MMDEPLOY_ERROR("exception caught while processing a frame: {}", e.what());
+    } catch (...) {
+      MMDEPLOY_ERROR("unknown exception caught while processing a frame");
+    }
+    return Status(eFail);
+  }
+
+  void Work() {
+    while (true) {
+      std::shared_ptr<Frame> frame;
+      {
+        std::unique_lock lock{mutex_};
+        cv_.wait(lock, [&] { return closed_ || !pending_.empty(); });
+        if (pending_.empty()) {
+          return;
+        }
+        frame = std::move(pending_.front());
+        pending_.pop_front();
+      }
+      auto output = Run(std::move(frame->input));
+      {
+        std::lock_guard lock{mutex_};
+        auto latency =
+            std::chrono::duration<double, std::micro>(Profiler::Now() - frame->pushed).count();
+        latency_sum_ += latency;
+        latency_max_ = std::max(latency_max_, latency);
+        ++completed_;
+        failed_ += output.has_error();
+        frame->output = std::move(output);
+        frame->done = true;
+      }
+      cv_.notify_all();
+    }
+  }
+
+  Node& node_;
+  size_t max_in_flight_;
+  Profiler profiler_;
+  // counts of the profiler entries when the stream is created
+  std::map<std::string, double> base_counts_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  // frames not yet popped, in the order they are pushed
+  std::deque<std::shared_ptr<Frame>> frames_;
+  // frames not yet started
+  std::deque<std::shared_ptr<Frame>> pending_;
+  bool closed_{};
+
+  size_t pushed_{};
+  size_t popped_{};
+  size_t completed_{};
+  size_t failed_{};
+  double latency_sum_{};
+  double latency_max_{};
+  Profiler::TimePoint start_;
+
+  std::vector<std::thread> workers_;
+};
+
+StreamingPipeline::StreamingPipeline(Node& node, int max_in_flight, Profiler profiler)
+    : impl_(std::make_unique<Impl>(node, max_in_flight, std::move(profiler))) {}
+
+StreamingPipeline::~StreamingPipeline() = default;
+
+Result<void> StreamingPipeline::Push(Value input) { return impl_->Push(std::move(input)); }
+
+std::optional<Result<Value>> StreamingPipeline::Pop() { return impl_->Pop(); }
+
+void StreamingPipeline::Close() { impl_->Close(); }
+
+Value StreamingPipeline::GetStats() const { return impl_->GetStats(); }
+
+}  // namespace mmdeploy::graph
@@ -0,0 +1,71 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+#ifndef MMDEPLOY_CSRC_CORE_STREAMING_H_
+#define MMDEPLOY_CSRC_CORE_STREAMING_H_
+
+#include <memory>
+#include <optional>
+
+#include "mmdeploy/core/graph.h"
+#include "mmdeploy/core/profiler.h"
+
+namespace mmdeploy::graph {
+
+/**
+ * Runs a node on a continuous sequence of inputs, e.g. the frames of a video.
+ *
+ * Up to `max_in_flight` inputs are processed concurrently, each on a worker thread of the stream,
+ * so that consecutive frames overlap across the stages of the node (preprocess of a frame runs
+ * while the previous one is in inference, bounding the per-node concurrency by "max_concurrency"
+ * in the pipeline config turns the nodes into proper stages). The outputs are popped in the order
+ * of the inputs. A frame occupies its slot in the window until its output is popped, so pushing
+ * blocks when the consumer falls behind, which bounds the memory held by the stream.
+ */
+class MMDEPLOY_API StreamingPipeline {
+ public:
+  /**
+   * @param node the node to run, which must outlive the stream
+   * @param max_in_flight number of frames pushed but not yet popped
+   * @param profiler profiler of the node, used to report the statistics of its stages
+   */
+  StreamingPipeline(Node& node, int max_in_flight, Profiler profiler = {});
+
+  // closes the stream, the frames not yet started are dropped
+  ~StreamingPipeline();
+
+  StreamingPipeline(const StreamingPipeline&) = delete;
+  StreamingPipeline& operator=(const StreamingPipeline&) = delete;
+
+  /**
+   * @brief push a frame, blocks while the window is full
+   * @return `eInvalidArgument` when the stream is closed
+   */
+  Result<void> Push(Value input);
+
+  /**
+   * @brief pop the output of the earliest frame not yet popped, blocks until it's ready
+   * @return the output or the error of the frame, or `std::nullopt` when the stream is closed and
+   * all the frames are popped
+   */
+  std::optional<Result<Value>> Pop();
+
+  // no more frames will be pushed, the frames in flight are still processed
+  void Close();
+
+  /**
+   * @brief statistics of the stream: {"pushed", "popped", "failed", "in_flight", "elapsed", "fps",
+   * "latency": {"mean", "max"}, "stages"}. The elapsed time is in seconds, and the latency from
+   * pushing to completion is in microseconds. "stages" is the statistics of the profiler (see
+   * `Profiler::GetStats`) with the "throughput" of each entry, i.e. the count per second since the
+   * stream is created, it's present only when profiling is enabled.
+   */
+  Value GetStats() const;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace mmdeploy::graph
+
+#endif  // MMDEPLOY_CSRC_CORE_STREAMING_H_
@@ -3,44 +3,49 @@
 #ifndef MMDEPLOY_SRC_UITLS_SCOPECOUNTER_H_
 #define MMDEPLOY_SRC_UITLS_SCOPECOUNTER_H_
 
-#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mmdeploy/core/profiler.h"
 
 namespace mmdeploy {
 
+// Marks time points in a scope, the durations between consecutive time points are recorded to the
+// profiler as "<name>: <tag0> -> <tag1>" events when the scope exits. Nothing is recorded by a
+// default constructed counter or one with a disabled profiler.
 class ScopeCounter {
  public:
-  class State {
-    std::map<std::string, std::pair<double, int> > v;
-  };
-  ScopeCounter() : state_() {}
-  explicit ScopeCounter(State& state) : state_(&state) {}
+  ScopeCounter() : profiler_() {}
+  ScopeCounter(const Profiler& profiler, const std::string& name)
+      : profiler_(profiler ? &profiler : nullptr), name_(profiler ? name : std::string{}) {}
   ScopeCounter(const ScopeCounter&) = delete;
   ScopeCounter(ScopeCounter&&) = delete;
   ScopeCounter& operator=(const ScopeCounter&) = delete;
   ScopeCounter& operator=(ScopeCounter&&) = delete;
   void operator()(const std::string& tag) { operator()(tag.c_str()); }
   void operator()(const char* tag) {
-    time_points_.emplace_back(tag, std::chrono::high_resolution_clock::now());
+    if (profiler_) {
+      time_points_.emplace_back(tag, Profiler::Now());
+    }
   }
   ~ScopeCounter() {
-    std::vector<std::pair<std::string, double> > durations;
     for (int i = 1; i < time_points_.size(); ++i) {
       auto& [n0, t0] = time_points_[i - 1];
       auto& [n1, t1] = time_points_[i];
-      auto diff = std::chrono::duration<double, std::milli>(t1 - t0).count();
-      auto name = n0;
+      auto name = name_;
+      name += ": ";
+      name += n0;
       name += " -> ";
       name += n1;
-      durations.emplace_back(name, diff);
-    }
-    if (state_) {
+      profiler_->Record(name, "module", t0, t1);
     }
   }
 
  private:
-  using time_point = std::chrono::high_resolution_clock::time_point;
-  std::vector<std::pair<std::string, time_point> > time_points_;
-  State* state_;
+  std::vector<std::pair<std::string, Profiler::TimePoint> > time_points_;
+  const Profiler* profiler_;
+  std::string name_;
 };
 
 }  // namespace mmdeploy
@@ -0,0 +1,69 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+#include "mmdeploy/core/value.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace mmdeploy {
+
+namespace {
+
+// bounds of the interned keys, which are the keys of configs & pipeline data in practice. Keys
+// derived from the data (e.g. file names or labels) are not worth keeping for the whole process.
+constexpr size_t kMaxInternedKeys = 1 << 14;
+constexpr size_t kMaxInternedKeyLength = 64;
+
+// nullptr for the keys not interned
+const std::string* Intern(std::string_view str) {
+  if (str.size() > kMaxInternedKeyLength) {
+    return nullptr;
+  }
+  // the lookups are served by a per-thread cache, the global set is locked only for new keys
+  thread_local std::unordered_map<std::string_view, const std::string*> cache;
+  if (auto it = cache.find(str); it != cache.end()) {
+    return it->second;
+  }
+  struct Keys {
+    std::mutex mutex;
+    std::deque<std::string> strings;
+    std::unordered_map<std::string_view, const std::string*> index;
+    // set when the bound is reached, the index is read-only since then
+    std::atomic<bool> full{false};
+  };
+  // never destroyed, the keys may be used by static values during destruction
+  static auto& keys = *new Keys;
+  const std::string* key{};
+  if (keys.full.load(std::memory_order_acquire)) {
+    if (auto it = keys.index.find(str); it != keys.index.end()) {
+      key = it->second;
+    }
+  } else {
+    std::lock_guard lock{keys.mutex};
+    if (auto it = keys.index.find(str); it != keys.index.end()) {
+      key = it->second;
+    } else if (keys.strings.size() < kMaxInternedKeys) {
+      key = &keys.strings.emplace_back(str);
+      keys.index.emplace(*key, key);
+    } else {
+      keys.full.store(true, std::memory_order_release);
+    }
+  }
+  if (key) {
+    cache.emplace(*key, key);
+  }
+  return key;
+}
+
+}  // namespace
+
+ValueKey::ValueKey(std::string_view str) : str_(Intern(str)) {
+  if (!str_) {
+    owner_ = std::make_shared<const std::string>(str);
+    str_ = owner_.get();
+  }
+}
+
+}  // namespace mmdeploy
@@ -3,12 +3,20 @@
 #ifndef MMDEPLOY_TYPES_VALUE_H_
 #define MMDEPLOY_TYPES_VALUE_H_
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -47,6 +55,306 @@ namespace detail {
 class ValueRef;
 }
 
+// Interned key of objects. Keys of the same content share a single string which is never released,
+// so copying a key copies a pointer and keys compare equal iff their strings are the same object.
+// The interned strings are bounded, long keys and the keys created after the bound is reached own
+// their strings and are compared by content.
+class MMDEPLOY_API ValueKey {
+ public:
+  ValueKey() : ValueKey(std::string_view{}) {}
+  ValueKey(std::string_view str);
+  ValueKey(const std::string& str) : ValueKey(std::string_view{str}) {}
+  ValueKey(const char* str) : ValueKey(std::string_view{str}) {}
+
+  const std::string& str() const noexcept { return *str_; }
+  bool interned() const noexcept { return !owner_; }
+  const char* c_str() const noexcept { return str_->c_str(); }
+  operator const std::string&() const noexcept { return *str_; }
+
+  friend bool operator==(const ValueKey& a, const ValueKey& b) noexcept {
+    return a.str_ == b.str_ || (a.owner_ && b.owner_ && *a.str_ == *b.str_);
+  }
+  friend bool operator!=(const ValueKey& a, const ValueKey& b) noexcept { return !(a == b); }
+  friend bool operator<(const ValueKey& a, const ValueKey& b) noexcept {
+    return a.str_ != b.str_ && *a.str_ < *b.str_;
+  }
+  friend bool operator==(const ValueKey& a, const std::string& b) noexcept { return *a.str_ == b; }
+  friend bool operator==(const std::string& a, const ValueKey& b) noexcept { return a == *b.str_; }
+  friend bool operator==(const ValueKey& a, const char* b) noexcept { return *a.str_ == b; }
+  friend bool operator==(const char* a, const ValueKey& b) noexcept { return a == *b.str_; }
+  friend bool operator!=(const ValueKey& a, const std::string& b) noexcept { return !(a == b); }
+  friend bool operator!=(const std::string& a, const ValueKey& b) noexcept { return !(a == b); }
+  friend bool operator!=(const ValueKey& a, const char* b) noexcept { return !(a == b); }
+  friend bool operator!=(const char* a, const ValueKey& b) noexcept { return !(a == b); }
+
+ private:
+  const std::string* str_;
+  // null for interned keys
+  std::shared_ptr<const std::string> owner_;
+};
+
+template <typename Key>
+inline constexpr bool is_value_key_v =
+    std::is_same_v<uncvref_t<Key>, ValueKey> || std::is_convertible_v<const Key&, std::string_view>;
+
+namespace detail {
+
+// Object storage of `Value`, a flat map of interned keys sorted in the order of the strings, which
+// is the iteration order of the `std::map` it replaces. It implements the part of the `std::map`
+// interface used by the code base. Lookups are linear scans over the small objects that make up
+// most of the pipeline data, keys are interned only when inserted. Lookups by `ValueKey` compare
+// the addresses of the interned strings, while lookups by strings compare the contents, so the hot
+// call sites keep their keys as `ValueKey`s, e.g. `static const ValueKey kImg{"img"}`. Like
+// `std::vector`, inserting may invalidate the references to the elements.
+template <typename T>
+class ValueObject {
+ public:
+  using key_type = ValueKey;
+  using mapped_type = T;
+  using value_type = std::pair<ValueKey, T>;
+  using size_type = std::size_t;
+  using iterator = typename std::vector<value_type>::iterator;
+  using const_iterator = typename std::vector<value_type>::const_iterator;
+
+  ValueObject() = default;
+
+  ValueObject(std::initializer_list<value_type> init) {
+    data_.reserve(init.size());
+    for (const auto& x : init) {
+      insert(x);
+    }
+  }
+
+  iterator begin() noexcept { return data_.begin(); }
+  iterator end() noexcept { return data_.end(); }
+  const_iterator begin() const noexcept { return data_.begin(); }
+  const_iterator end() const noexcept { return data_.end(); }
+  const_iterator cbegin() const noexcept { return data_.begin(); }
+  const_iterator cend() const noexcept { return data_.end(); }
+
+  size_type size() const noexcept { return data_.size(); }
+  bool empty() const noexcept { return data_.empty(); }
+  void clear() noexcept { data_.clear(); }
+  void reserve(size_type n) { data_.reserve(n); }
+
+  template <typename Key, std::enable_if_t<is_value_key_v<Key>, int> = 0>
+  iterator find(const Key& key) {
+    return begin() + (_find(key) - cbegin());
+  }
+
+  template <typename Key, std::enable_if_t<is_value_key_v<Key>, int> = 0>
+  const_iterator find(const Key& key) const {
+    return _find(key);
+  }
+
+  template <typename Key, std::enable_if_t<is_value_key_v<Key>, int> = 0>
+  size_type count(const Key& key) const {
+    return _find(key) != end();
+  }
+
+  template <typename Key, std::enable_if_t<is_value_key_v<Key>, int> = 0>
+  bool contains(const Key& key) const {
+    return _find(key) != end();
+  }
+
+  template <typename Key, std::enable_if_t<is_value_key_v<Key>, int> = 0>
+  T& at(const Key& key) {
+    auto it = find(key);
+    if (it == end()) {
+      throw std::out_of_range("key not found");
+    }
+    return it->second;
+  }
+
+  template <typename Key, std::enable_if_t<is_value_key_v<Key>, int> = 0>
+  const T& at(const Key& key) const {
+    auto it = find(key);
+    if (it == end()) {
+      throw std::out_of_range("key not found");
+    }
+    return it->second;
+  }
+
+  template <typename Key, std::enable_if_t<is_value_key_v<Key>, int> = 0>
+  T& operator[](const Key& key) {
+    return try_emplace(key).first->second;
+  }
+
+  template <typename Key, typename... Args, std::enable_if_t<is_value_key_v<Key>, int> = 0>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    if (auto it = find(key); it != end()) {
+      return {it, false};
+    }
+    auto pos = lower_bound(key);
+    auto it = data_.emplace(pos, std::piecewise_construct, std::forward_as_tuple(ToKey(key)),
+                            std::forward_as_tuple(std::forward<Args>(args)...));
+    return {it, true};
+  }
+
+  template <typename Key, typename... Args, std::enable_if_t<is_value_key_v<Key>, int> = 0>
+  std::pair<iterator, bool> emplace(const Key& key, Args&&... args) {
+    return try_emplace(key, std::forward<Args>(args)...);
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return try_emplace(value.first, value.second);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return try_emplace(value.first, std::move(value.second));
+  }
+
+  template <typename Key, typename U, std::enable_if_t<is_value_key_v<Key>, int> = 0>
+  std::pair<iterator, bool> insert_or_assign(const Key& key, U&& value) {
+    auto ret = try_emplace(key, std::forward<U>(value));
+    if (!ret.second) {
+      ret.first->second = std::forward<U>(value);
+    }
+    return ret;
+  }
+
+  iterator erase(const_iterator pos) { return data_.erase(pos); }
+
+  template <typename Key, std::enable_if_t<is_value_key_v<Key>, int> = 0>
+  size_type erase(const Key& key) {
+    if (auto it = find(key); it != end()) {
+      data_.erase(it);
+      return 1;
+    }
+    return 0;
+  }
+
+  friend bool operator==(const ValueObject& a, const ValueObject& b) { return a.data_ == b.data_; }
+  friend bool operator!=(const ValueObject& a, const ValueObject& b) { return a.data_ != b.data_; }
+
+ private:
+  // beyond which binary search is used for lookups
+  static constexpr size_type kLinearSearchSize = 16;
+
+  template <typename Key>
+  static ValueKey ToKey(const Key& key) {
+    if constexpr (std::is_same_v<Key, ValueKey>) {
+      return key;
+    } else {
+      return ValueKey{std::string_view{key}};
+    }
+  }
+
+  template <typename Key>
+  const_iterator _find(const Key& key) const {
+    if constexpr (std::is_same_v<Key, ValueKey>) {
+      if (size() <= kLinearSearchSize) {
+        if (key.interned()) {
+          // the equal keys share the interned string
+          auto str = &key.str();
+          return std::find_if(begin(), end(),
+                              [str](const value_type& x) { return &x.first.str() == str; });
+        }
+        return std::find_if(begin(), end(), [&](const value_type& x) { return x.first == key; });
+      }
+      auto it = lower_bound(key);
+      return it != end() && it->first == key ? it : end();
+    } else {
+      std::string_view str{key};
+      if (size() <= kLinearSearchSize) {
+        return std::find_if(begin(), end(),
+                            [&](const value_type& x) { return x.first.str() == str; });
+      }
+      auto it = lower_bound(key);
+      return it != end() && it->first.str() == str ? it : end();
+    }
+  }
+
+  template <typename Key>
+  const_iterator lower_bound(const Key& key) const {
+    std::string_view str{ToString(key)};
+    return std::lower_bound(begin(), end(), str, [](const value_type& x, std::string_view s) {
+      return std::string_view{x.first.str()} < s;
+    });
+  }
+
+  template <typename Key>
+  static std::string_view ToString(const Key& key) {
+    if constexpr (std::is_same_v<Key, ValueKey>) {
+      return key.str();
+    } else {
+      return key;
+    }
+  }
+
+  std::vector<value_type> data_;
+};
+
+// Storage of the arrays & objects of values. The node is shared by the copies of a value and a value
+// replaces it by a copy of its own before modifying it, so copying a value is O(1) in the size of
+// the tree. Handing out a mutable reference into the node pins it to the value: it's made unique
+// first, so writes through the reference are never observed by the earlier copies. The pin ends
+// when the value is copied, the copy shares the node again and the next mutable access unshares it.
+template <typename T>
+class SharedNode {
+ public:
+  explicit SharedNode(std::shared_ptr<const T> node) noexcept : node_(std::move(node)) {}
+
+  const T& get() const noexcept { return *node_; }
+
+  // the node for a copy of the value, which ends the mutable accesses handed out so far
+  std::shared_ptr<const T> share() const {
+    if (state_.load(std::memory_order_relaxed) == kPinned) {
+      state_.store(kShareable, std::memory_order_relaxed);
+    }
+    return node_;
+  }
+
+  // for modifications of the structure, which must not race with any other access to the value
+  T& unshare() {
+    if (state_.load(std::memory_order_relaxed) == kShareable) {
+      detach();
+    }
+    return const_cast<T&>(*node_);
+  }
+
+  // for handing out mutable references, which may be done concurrently for distinct elements
+  T& pin() {
+    auto state = state_.load(std::memory_order_acquire);
+    if (state != kPinned) {
+      state = kShareable;
+      if (state_.compare_exchange_strong(state, kPinning, std::memory_order_acquire)) {
+        try {
+          detach();
+        } catch (...) {
+          state_.store(kShareable, std::memory_order_release);
+          throw;
+        }
+        state_.store(kPinned, std::memory_order_release);
+      } else {
+        while (state_.load(std::memory_order_acquire) != kPinned) {
+          std::this_thread::yield();
+        }
+      }
+    }
+    return const_cast<T&>(*node_);
+  }
+
+ private:
+  void detach() {
+    if (node_.use_count() != 1) {
+      // the other holders may be reading the node, so it's replaced instead of being modified
+      node_ = std::make_shared<T>(*node_);
+    } else {
+      // pairs with the release when the other holders dropped the node
+      std::atomic_thread_fence(std::memory_order_acquire);
+    }
+  }
+
+  enum : uint8_t { kShareable, kPinning, kPinned };
+
+  // created as a non-const `T`, the constness only guards the readers of a shared node
+  std::shared_ptr<const T> node_;
+  mutable std::atomic<uint8_t> state_{kShareable};
+};
+
+}  // namespace detail
+
 template <typename T>
 class ValueIterator {
  public:
@@ -55,8 +363,12 @@ class ValueIterator {
   using pointer = value_type*;
   using reference = value_type&;
   using iterator_category = std::bidirectional_iterator_tag;
-  using object_iterator_t = typename T::Object::iterator;
-  using array_iterator_t = typename T::Array::iterator;
+  using object_iterator_t =
+      std::conditional_t<std::is_const_v<T>, typename T::Object::const_iterator,
+                         typename T::Object::iterator>;
+  using array_iterator_t =
+      std::conditional_t<std::is_const_v<T>, typename T::Array::const_iterator,
+                         typename T::Array::iterator>;
   ValueIterator() = default;
   ValueIterator(T* value, object_iterator_t iter) : value_(value), object_iter_(iter) {}
   ValueIterator(T* value, array_iterator_t iter) : value_(value), array_iter_(iter) {}
@@ -103,7 +415,7 @@ class ValueIterator {
   }
   const std::string& key() {
     if (value_->is_object()) {
-      return object_iter_->first;
+      return object_iter_->first.str();
     }
     throw_exception(eInvalidArgument);
   }
@@ -147,12 +459,14 @@ template <class T>
 struct is_cast_by_erasure : std::false_type {};
 
 class Device;
+class Allocator;
 class Buffer;
 class Stream;
 class Event;
 class Model;
 class Tensor;
 class Mat;
+class Profiler;
 
 template <>
 struct is_cast_by_erasure<Device> : std::true_type {};
@@ -168,6 +482,10 @@ template <>
 struct is_cast_by_erasure<Tensor> : std::true_type {};
 template <>
 struct is_cast_by_erasure<Mat> : std::true_type {};
+template <>
+struct is_cast_by_erasure<Allocator> : std::true_type {};
+template <>
+struct is_cast_by_erasure<Profiler> : std::true_type {};
 
 MMDEPLOY_REGISTER_TYPE_ID(Device, 1);
 MMDEPLOY_REGISTER_TYPE_ID(Buffer, 2);
@@ -176,6 +494,8 @@ MMDEPLOY_REGISTER_TYPE_ID(Event, 4);
 MMDEPLOY_REGISTER_TYPE_ID(Model, 5);
 MMDEPLOY_REGISTER_TYPE_ID(Tensor, 6);
 MMDEPLOY_REGISTER_TYPE_ID(Mat, 7);
+MMDEPLOY_REGISTER_TYPE_ID(Allocator, 9);
+MMDEPLOY_REGISTER_TYPE_ID(Profiler, 10);
 
 template <typename T>
 struct is_value : std::is_same<T, Value> {};
@@ -194,6 +514,12 @@ template <typename T>
 struct is_const_reference<const T&> : std::true_type {};
 }  // namespace detail
 
+// Copies of a value share the arrays & objects until one of them is modified, see
+// `detail::SharedNode`. References to the elements of a value never observe the modifications of
+// its copies. Copying a value ends the mutable accesses to it: the references and iterators obtained
+// before may still be read, but writes through them would be observed by the copy. Concurrent const
+// access to a value is safe, so is concurrent non-const access to distinct elements of an array or
+// object as long as the structure of the container itself is not modified at the same time.
 class Value {
  public:
   using value_type = Value;
@@ -215,7 +541,8 @@ class Value {
   using String = std::string;
   using Binary = std::vector<Byte>;
   using Array = std::vector<Value>;
-  using Object = std::map<std::string, Value>;
+  using Object = detail::ValueObject<Value>;
+  using Key = ValueKey;
   using Pointer = std::shared_ptr<Value>;
   using Dynamic = ::mmdeploy::Dynamic;
   using Any = ::mmdeploy::StaticAny;
@@ -264,10 +591,10 @@ class Value {
         data_ = *other.data_.binary;
         break;
       case ValueType::kArray:
-        data_ = *other.data_.array;
+        data_.array = create<Shared<Array>>(other.data_.array->share());
         break;
       case ValueType::kObject:
-        data_ = *other.data_.object;
+        data_.object = create<Shared<Object>>(other.data_.object->share());
         break;
       case ValueType::kPointer:
         data_ = *other.data_.pointer;
@@ -384,9 +711,9 @@ class Value {
       case ValueType::kNull:
         return 0;
       case ValueType::kArray:
-        return data_.array->size();
+        return _array().size();
       case ValueType::kObject:
-        return data_.object->size();
+        return _object().size();
       default:
         return 1;
     }
@@ -397,9 +724,9 @@ class Value {
       case Type::kNull:
         return true;
       case Type::kArray:
-        return data_.array->empty();
+        return _array().empty();
       case Type::kObject:
-        return data_.object->empty();
+        return _object().empty();
       default:
         return false;
     }
@@ -436,13 +763,13 @@ class Value {
   const Binary* get_impl_ptr(const Binary*) const noexcept {
     return _is_binary() ? data_.binary : nullptr;
   }
-  Array* get_impl_ptr(Array*) noexcept { return _is_array() ? data_.array : nullptr; }
+  Array* get_impl_ptr(Array*) noexcept { return _is_array() ? &_array() : nullptr; }
   const Array* get_impl_ptr(const Array*) const noexcept {
-    return _is_array() ? data_.array : nullptr;
+    return _is_array() ? &_array() : nullptr;
   }
-  Object* get_impl_ptr(Object*) noexcept { return _is_object() ? data_.object : nullptr; }
+  Object* get_impl_ptr(Object*) noexcept { return _is_object() ? &_object() : nullptr; }
   const Object* get_impl_ptr(const Object*) const noexcept {
-    return _is_object() ? data_.object : nullptr;
+    return _is_object() ? &_object() : nullptr;
   }
   Pointer* get_impl_ptr(Pointer*) noexcept { return _is_pointer() ? data_.pointer : nullptr; }
   const Pointer* get_impl_ptr(const Pointer*) const noexcept {
@@ -633,20 +960,24 @@ class Value {
     return static_cast<const value_type&&>(_unwrap()._subscript(idx));
   }
 
-  value_type& operator[](const Object::key_type& idx) & {
-    return static_cast<value_type&>(_unwrap()._subscript(idx));
+  template <typename Key, std::enable_if_t<is_value_key_v<Key>, int> = 0>
+  value_type& operator[](const Key& key) & {
+    return static_cast<value_type&>(_unwrap()._subscript_key(key));
   }
 
-  value_type&& operator[](const Object::key_type& idx) && {
-    return static_cast<value_type&&>(_unwrap()._subscript(idx));
+  template <typename Key, std::enable_if_t<is_value_key_v<Key>, int> = 0>
+  value_type&& operator[](const Key& key) && {
+    return static_cast<value_type&&>(_unwrap()._subscript_key(key));
   }
 
-  const value_type& operator[](const Object::key_type& idx) const& {
-    return static_cast<const value_type&>(_unwrap()._subscript(idx));
+  template <typename Key, std::enable_if_t<is_value_key_v<Key>, int> = 0>
+  const value_type& operator[](const Key& key) const& {
+    return static_cast<const value_type&>(_unwrap()._subscript_key(key));
   }
 
-  const value_type&& operator[](const Object::key_type& idx) const&& {
-    return static_cast<const value_type&&>(_unwrap()._subscript(idx));
+  template <typename Key, std::enable_if_t<is_value_key_v<Key>, int> = 0>
+  const value_type&& operator[](const Key& key) const&& {
+    return static_cast<const value_type&&>(_unwrap()._subscript_key(key));
   }
 
   reference front() { return _unwrap()._front(); }
@@ -676,8 +1007,8 @@ class Value {
     return _unwrap()._find(std::forward<Key>(key));
   }
 
-  template <typename T>
-  T value(const typename Object::key_type& key, const T& default_value) const {
+  template <typename T, typename Key, std::enable_if_t<is_value_key_v<Key>, int> = 0>
+  T value(const Key& key, const T& default_value) const {
     return _unwrap()._value(key, default_value);
   }
 
@@ -694,28 +1025,28 @@ class Value {
  private:
   reference _front() {
     if (_is_array()) {
-      return (*data_.array).front();
+      return _array().front();
     }
     throw_exception(eInvalidArgument);
   }
 
   const_reference _front() const {
     if (_is_array()) {
-      return (*data_.array).front();
+      return _array().front();
     }
     throw_exception(eInvalidArgument);
   }
 
   reference _back() {
     if (_is_array()) {
-      return (*data_.array).back();
+      return _array().back();
     }
     throw_exception(eInvalidArgument);
   }
 
   const_reference _back() const {
     if (_is_array()) {
-      return (*data_.array).back();
+      return _array().back();
     }
     throw_exception(eInvalidArgument);
   }
@@ -727,7 +1058,7 @@ class Value {
     if (_is_null()) {
       *this = Type::kArray;
     }
-    data_.array->push_back(std::move(val));
+    data_.array->unshare().push_back(std::move(val));
   }
 
   void _push_back(const Value& val) {
@@ -737,18 +1068,18 @@ class Value {
     if (_is_null()) {
       *this = Type::kArray;
     }
-    data_.array->push_back(val);
+    data_.array->unshare().push_back(val);
   }
 
   template <typename Key>
   bool _contains(Key&& key) const {
-    return _is_object() && data_.object->find(std::forward<Key>(key)) != data_.object->end();
+    return _is_object() && _object().find(std::forward<Key>(key)) != _object().end();
   }
 
   template <typename Key>
   iterator _find(Key&& key) {
     if (_is_object()) {
-      auto iter = data_.object->find(std::forward<Key>(key));
+      auto iter = _object().find(std::forward<Key>(key));
       return {this, iter};
     }
     throw_exception(eInvalidArgument);
@@ -757,18 +1088,18 @@ class Value {
   template <typename Key>
   const_iterator _find(Key&& key) const {
     if (_is_object()) {
-      auto iter = data_.object->find(std::forward<Key>(key));
+      auto iter = _object().find(std::forward<Key>(key));
       return {this, iter};
     }
     throw_exception(eInvalidArgument);
   }
 
-  template <typename T>
-  T _value(const typename Object::key_type& key, const T& default_value) const {
+  template <typename T, typename Key>
+  T _value(const Key& key, const T& default_value) const {
     if (_is_object()) {
       const auto it = _find(key);
       if (it != _end()) {
-        return (*it)._get<T>();
+        return (*it).template _get<T>();
       }
       return default_value;
     }
@@ -777,9 +1108,9 @@ class Value {
 
   iterator _begin() {
     if (_is_array()) {
-      return {this, data_.array->begin()};
+      return {this, _array().begin()};
     } else if (_is_object()) {
-      return {this, data_.object->begin()};
+      return {this, _object().begin()};
     } else {
       throw_exception(eInvalidArgument);
     }
@@ -787,9 +1118,9 @@ class Value {
 
   iterator _end() {
     if (_is_array()) {
-      return {this, data_.array->end()};
+      return {this, _array().end()};
     } else if (_is_object()) {
-      return {this, data_.object->end()};
+      return {this, _object().end()};
     } else {
       throw_exception(eInvalidArgument);
     }
@@ -797,9 +1128,9 @@ class Value {
 
   const_iterator _begin() const {
     if (_is_array()) {
-      return {this, data_.array->begin()};
+      return {this, _array().begin()};
     } else if (_is_object()) {
-      return {this, data_.object->begin()};
+      return {this, _object().begin()};
     } else {
       throw_exception(eInvalidArgument);
     }
@@ -807,9 +1138,9 @@ class Value {
 
   const_iterator _end() const {
     if (_is_array()) {
-      return {this, data_.array->end()};
+      return {this, _array().end()};
     } else if (_is_object()) {
-      return {this, data_.object->end()};
+      return {this, _object().end()};
     } else {
       throw_exception(eInvalidArgument);
     }
@@ -817,14 +1148,17 @@ class Value {
 
   void _update(const_reference v) {
     if (_is_null()) {
-      type_ = ValueType::kObject;
-      data_.object = create<Object>();
+      *this = Type::kObject;
     }
     if (!(_is_object() && v._is_object())) {
       throw_exception(eInvalidArgument);
     }
-    for (auto it = v._begin(); it != v._end(); ++it) {
-      data_.object->operator[](it.key()) = *it;
+    if (&v == this) {
+      return;
+    }
+    auto& object = data_.object->unshare();
+    for (const auto& [key, value] : v._object()) {
+      object.insert_or_assign(key, value);
     }
   }
 
@@ -855,38 +1189,62 @@ class Value {
     delete ptr;
   }
 
+  template <typename T>
+  using Shared = detail::SharedNode<T>;
+
+  template <typename T, typename... Args>
+  static Shared<T>* create_shared(Args&&... args) {
+    return create<Shared<T>>(std::make_shared<T>(std::forward<Args>(args)...));
+  }
+
+  const Array& _array() const noexcept { return data_.array->get(); }
+  Array& _array() { return data_.array->pin(); }
+  const Object& _object() const noexcept { return data_.object->get(); }
+  Object& _object() { return data_.object->pin(); }
+
   value_type& _subscript(size_t idx) {
     if (_is_array()) {
-      return (*data_.array)[idx];
+      return _array()[idx];
     }
     throw_exception(eInvalidArgument);
   }
 
   const value_type& _subscript(size_t idx) const {
     if (_is_array()) {
-      return (*data_.array)[idx];
+      return _array()[idx];
     }
     throw_exception(eInvalidArgument);
   }
 
-  reference _subscript(const Object::key_type& key) {
+  template <typename Key>
+  reference _subscript_key(const Key& key) {
     if (_is_null()) {
-      type_ = Type::kObject;
-      data_.object = create<Object>();
+      *this = Type::kObject;
     }
     if (_is_object()) {
-      return (*data_.object)[key];
+      return _object()[key];
     }
     throw_exception(eInvalidArgument);
   }
 
-  const_reference _subscript(const Object::key_type& key) const {
+  // missing keys are not inserted, a null value is returned instead
+  template <typename Key>
+  const_reference _subscript_key(const Key& key) const {
     if (_is_object()) {
-      return (*data_.object)[key];
+      const auto& object = _object();
+      if (auto it = object.find(key); it != object.end()) {
+        return it->second;
+      }
+      return _null();
     }
     throw_exception(eInvalidArgument);
   }
 
+  static const Value& _null() {
+    static const Value null;
+    return null;
+  }
+
  private:
   union ValueData {
     Boolean boolean;
@@ -895,8 +1253,8 @@ class Value {
     Float number_float;
     String* string;
     Binary* binary;
-    Array* array;
-    Object* object;
+    Shared<Array>* array;
+    Shared<Object>* object;
     Dynamic* dynamic;
     Pointer* pointer;
     Any* any;
@@ -932,10 +1290,10 @@ class Value {
           binary = create<Binary>();
           break;
         case Type::kArray:
-          array = create<Array>();
+          array = create_shared<Array>();
           break;
         case Type::kObject:
-          object = create<Object>();
+          object = create_shared<Object>();
           break;
         case Type::kPointer:
           pointer = create<Pointer>();
@@ -959,13 +1317,13 @@ class Value {
 
     ValueData(Binary&& value) { binary = create<Binary>(std::move(value)); }
 
-    ValueData(const Object& value) { object = create<Object>(value); }
+    ValueData(const Object& value) { object = create_shared<Object>(value); }
 
-    ValueData(Object&& value) { object = create<Object>(std::move(value)); }
+    ValueData(Object&& value) { object = create_shared<Object>(std::move(value)); }
 
-    ValueData(const Array& value) { array = create<Array>(value); }
+    ValueData(const Array& value) { array = create_shared<Array>(value); }
 
-    ValueData(Array&& value) { array = create<Array>(std::move(value)); }
+    ValueData(Array&& value) { array = create_shared<Array>(std::move(value)); }
 
     ValueData(const Pointer& value) { pointer = create<Pointer>(value); }
 
@@ -1061,14 +1419,16 @@ inline Value::Value(std::initializer_list<ValueRef> init, bool type_deduction, T
   if (is_an_object) {
     type_ = Type::kObject;
     data_ = Type::kObject;
+    auto& object = data_.object->unshare();
+    object.reserve(init.size());
     for (const auto& x : init) {
       auto e = x.moved_or_copied();
-      data_.object->emplace(std::move(*((*e.data_.array)[0].data_.string)),
-                            std::move((*e.data_.array)[1]));
+      auto& pair = e.data_.array->unshare();
+      object.emplace(*pair[0].data_.string, std::move(pair[1]));
     }
   } else {
     type_ = Type::kArray;
-    data_.array = create<Array>(init.begin(), init.end());
+    data_.array = create_shared<Array>(init.begin(), init.end());
   }
 }
 
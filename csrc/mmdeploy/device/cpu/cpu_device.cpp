@@ -5,54 +5,120 @@
 #include <cstdlib>
 #include <cstring>
 
+#include "mmdeploy/core/logger.h"
+#include "mmdeploy/core/value.h"
+#include "mmdeploy/device/device_allocator.h"
+
 namespace mmdeploy {
 
+namespace cpu {
+
+class Mallocator : public AllocatorImpl {
+ public:
+  Block Allocate(size_t size) noexcept override {
+    Block block;
+    block.handle = std::malloc(size);
+    if (block.handle) {
+      block.size = size;
+    }
+    return block;
+  }
+  void Deallocate(Block& block) noexcept override {
+    std::free(block.handle);
+    block.handle = nullptr;
+    block.size = 0;
+  }
+  bool Owns(const Block& block) const noexcept override { return true; }
+};
+
+Result<Allocator> CreateAllocator(const Value& config) {
+  using namespace device_allocator;
+  AllocatorImplPtr allocator = std::make_shared<Mallocator>();
+  // buffers are malloc'ed by default, pipelines opt in to the arena through `context["allocator"]`
+  auto type = config.value("type", std::string{"malloc"});
+  if (type == "arena") {
+    Arena::Options options;
+    options.tiny_size = config.value("tiny_size", options.tiny_size);
+    options.tiny_step = config.value("tiny_step", options.tiny_step);
+    options.small_size = config.value("small_size", options.small_size);
+    options.small_step = config.value("small_step", options.small_step);
+    options.pool_size = config.value("pool_size", options.pool_size);
+    options.max_cached_bytes = config.value("max_cached_bytes", options.max_cached_bytes);
+    options.threshold = config.value("threshold", options.threshold);
+    if (!options.tiny_step || !options.tiny_size || options.tiny_size % options.tiny_step) {
+      MMDEPLOY_ERROR("'tiny_size' ({}) must be a positive multiple of 'tiny_step' ({})",
+                     options.tiny_size, options.tiny_step);
+      return Status(eInvalidArgument);
+    }
+    if (!options.small_step || options.small_size <= options.tiny_size ||
+        (options.small_size - options.tiny_size) % options.small_step) {
+      MMDEPLOY_ERROR(
+          "'small_size' ({}) must exceed 'tiny_size' ({}) by a multiple of 'small_step' ({})",
+          options.small_size, options.tiny_size, options.small_step);
+      return Status(eInvalidArgument);
+    }
+    allocator = std::make_shared<Arena>(allocator, options, config.value("name", type));
+  } else if (type == "malloc") {
+    // counted for `mmdeploy_default_allocator_get_stats`
+    allocator = std::make_shared<AtomicStats>(allocator, config.value("name", type));
+  } else {
+    MMDEPLOY_ERROR("unsupported CPU allocator type: {}", type);
+    return Status(eNotSupported);
+  }
+  return Access::create<Allocator>(allocator);
+}
+
+}  // namespace cpu
+
 class CpuHostMemory : public NonCopyable {
  public:
-  CpuHostMemory() : size_(), data_(), owned_data_{false} {}
-  Result<void> Init(size_t size, size_t alignment) {
+  CpuHostMemory() : size_(), owned_block_{false} {}
+  Result<void> Init(size_t size, Allocator allocator, size_t alignment) {
     if (alignment != 1) {
       return Status(eNotSupported);
     }
-    data_ = std::malloc(size);
-    if (!data_) {
+    allocator_ = std::move(allocator);
+    block_ = Access::get<AllocatorImpl>(allocator_).Allocate(size);
+    if (!block_.handle) {
       return Status(eOutOfMemory);
     }
     size_ = size;
-    owned_data_ = true;
+    owned_block_ = true;
     return success();
   }
   Result<void> Init(size_t size, std::shared_ptr<void> data) {
     size_ = size;
     external_ = std::move(data);
-    data_ = external_.get();
-    owned_data_ = false;
+    block_.handle = external_.get();
+    owned_block_ = false;
     return success();
   }
   Result<void> Init(size_t size, void* data) {
     size_ = size;
-    data_ = data;
-    owned_data_ = false;
+    block_.handle = data;
+    owned_block_ = false;
     return success();
   }
   ~CpuHostMemory() {
-    if (data_) {
-      if (owned_data_) {
-        std::free(data_);
-        owned_data_ = false;
+    if (block_.handle) {
+      if (owned_block_) {
+        Access::get<AllocatorImpl>(allocator_).Deallocate(block_);
+        owned_block_ = false;
       }
-      data_ = nullptr;
+      block_.handle = nullptr;
     }
     external_.reset();
     size_ = 0;
   }
   size_t size() const { return size_; }
-  void* data() const { return data_; }
+  void* data() const { return block_.handle; }
+  const Allocator& allocator() const { return allocator_; }
 
  private:
   size_t size_;
-  void* data_;
-  bool owned_data_;
+  AllocatorImpl::Block block_;
+  bool owned_block_;
+  Allocator allocator_;
   std::shared_ptr<void> external_;
 };
 
@@ -152,6 +218,18 @@ Result<void> CpuPlatformImpl::Copy(Buffer src, Buffer dst, size_t size, size_t s
                   stream);
 }
 
+Allocator CpuPlatformImpl::GetDefaultAllocator(int32_t device_id) {
+  std::call_once(allocator_init_flag_, [&] {
+    default_allocator_ = cpu::CreateAllocator(Value::kObject).value();
+    MMDEPLOY_DEBUG("Default CPU allocator initialized");
+  });
+  return default_allocator_;
+}
+
+Result<Allocator> CpuPlatformImpl::CreateAllocator(int32_t device_id, const Value& config) {
+  return cpu::CreateAllocator(config);
+}
+
 Result<Stream> CpuPlatformImpl::GetDefaultStream(int32_t device_id) {
   try {
     std::call_once(init_flag_, [&] { default_stream_ = Stream(GetDevice(device_id)); });
@@ -175,7 +253,7 @@ void* CpuBufferImpl::GetNative(ErrorCode* ec) {
   return OffsetPtr(memory_->data(), offset_);
 }
 
-Allocator CpuBufferImpl::GetAllocator() const { return {}; }
+Allocator CpuBufferImpl::GetAllocator() const { return memory_->allocator(); }
 
 size_t CpuBufferImpl::GetSize(ErrorCode* ec) {
   if (!memory_) {
@@ -214,9 +292,11 @@ size_t CpuBufferImpl::GetSize(ErrorCode* ec) {
 
 Result<void> CpuBufferImpl::Init(size_t size, Allocator allocator, size_t alignment,
                                  uint64_t flags) {
-  assert(!allocator && "CPU device doesn't support allocators yet");
   memory_ = std::make_shared<CpuHostMemory>();
-  OUTCOME_TRY(memory_->Init(size, alignment));
+  if (!allocator) {
+    allocator = gCpuPlatform().GetDefaultAllocator(device_.device_id());
+  }
+  OUTCOME_TRY(memory_->Init(size, std::move(allocator), alignment));
   size_ = size;
   return success();
 }
@@ -34,6 +34,10 @@ class CpuPlatformImpl : public PlatformImpl {
 
   Result<Stream> GetDefaultStream(int32_t device_id) override;
 
+  Allocator GetDefaultAllocator(int32_t device_id) override;
+
+  Result<Allocator> CreateAllocator(int32_t device_id, const Value& config) override;
+
   Device GetDevice(int device_id) const { return Device(GetPlatformId(), device_id); }
 
  private:
@@ -45,6 +49,8 @@ class CpuPlatformImpl : public PlatformImpl {
 
   Stream default_stream_;
   std::once_flag init_flag_;
+  Allocator default_allocator_;
+  std::once_flag allocator_init_flag_;
 };
 
 CpuPlatformImpl& gCpuPlatform();
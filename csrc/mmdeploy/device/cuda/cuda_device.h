@@ -45,7 +45,7 @@ class CudaPlatformImpl : public PlatformImpl {
 
   Result<Stream> GetDefaultStream(int32_t device_id) override;
 
-  Allocator GetDefaultAllocator(int32_t device_id);
+  Allocator GetDefaultAllocator(int32_t device_id) override;
 
   Device GetDevice(int device_id) { return Device(platform_id_, device_id); }
 
@@ -3,6 +3,7 @@
 #ifndef MMDEPLOY_SRC_CORE_DEVICE_ALLOCATOR_H_
 #define MMDEPLOY_SRC_CORE_DEVICE_ALLOCATOR_H_
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <map>
@@ -158,10 +159,23 @@ class Tree : public AllocatorImpl {
 
 class Stats : public AllocatorImpl {
  public:
-  explicit Stats(AllocatorImplPtr allocator, std::string name)
-      : allocator_(std::move(allocator)), name_(std::move(name)) {}
+  struct Data {
+    size_t allocation_count{};
+    size_t deallocation_count{};
+    size_t allocated_bytes{};
+    size_t deallocated_bytes{};
+    size_t peak{};
+    double allocation_time{};
+    double deallocation_time{};
+  };
+
+  explicit Stats(AllocatorImplPtr allocator, std::string name, bool report = true)
+      : allocator_(std::move(allocator)), name_(std::move(name)), report_(report) {}
 
   ~Stats() override {
+    if (!report_) {
+      return;
+    }
     MMDEPLOY_INFO("=== {} ===", name_);
     MMDEPLOY_INFO("  Allocation: count={}, size={}MB, time={}ms", data_.allocation_count,
                   data_.allocated_bytes / (1024 * 1024.f),
@@ -196,19 +210,14 @@ class Stats : public AllocatorImpl {
 
   const char* Name() const noexcept override { return name_.c_str(); }
 
+  // not synchronized, read it under the same lock guarding the allocations
+  const Data& data() const noexcept { return data_; }
+
  private:
-  struct Data {
-    size_t allocation_count{};
-    size_t deallocation_count{};
-    size_t allocated_bytes{};
-    size_t deallocated_bytes{};
-    size_t peak{};
-    double allocation_time{};
-    double deallocation_time{};
-  };
   Data data_;
   AllocatorImplPtr allocator_;
   std::string name_;
+  bool report_;
 };
 
 class Locked : public AllocatorImpl {
@@ -347,6 +356,137 @@ inline AllocatorImplPtr CreatePoolBucketizer(size_t min_size, size_t max_size, s
   return CreateBucketizer(min_size, max_size, step_size, creator);
 }
 
+// Thread safe counterpart of `Stats` for allocators shared by concurrent pipelines, the counters
+// are updated atomically instead of under a lock. Timing is not measured.
+class AtomicStats : public AllocatorImpl {
+ public:
+  explicit AtomicStats(AllocatorImplPtr allocator, std::string name)
+      : allocator_(std::move(allocator)), name_(std::move(name)) {}
+
+  Block Allocate(size_t size) noexcept override {
+    auto block = allocator_->Allocate(size);
+    if (block.handle) {
+      ++allocation_count_;
+      auto allocated = allocated_bytes_.fetch_add(block.size) + block.size;
+      auto in_use = allocated - deallocated_bytes_.load();
+      auto peak = peak_.load();
+      while (peak < in_use && !peak_.compare_exchange_weak(peak, in_use)) {
+      }
+    }
+    return block;
+  }
+
+  void Deallocate(Block& block) noexcept override {
+    ++deallocation_count_;
+    deallocated_bytes_ += block.size;
+    allocator_->Deallocate(block);
+  }
+
+  bool Owns(const Block& block) const noexcept override { return allocator_->Owns(block); }
+
+  const char* Name() const noexcept override { return name_.c_str(); }
+
+  // for an allocator without a cache of its own, e.g. malloc, every allocation is an upstream one
+  Result<AllocatorStats> GetStats() const override {
+    auto counters = data();
+    AllocatorStats stats;
+    stats.allocation_count = counters.allocation_count;
+    stats.upstream_allocation_count = counters.allocation_count;
+    stats.in_use_bytes = counters.allocated_bytes - counters.deallocated_bytes;
+    stats.peak_bytes = counters.peak;
+    return stats;
+  }
+
+  // a snapshot of the counters, which may be updated concurrently
+  Stats::Data data() const noexcept {
+    Stats::Data data;
+    data.allocation_count = allocation_count_.load();
+    data.deallocation_count = deallocation_count_.load();
+    data.deallocated_bytes = deallocated_bytes_.load();
+    data.allocated_bytes = allocated_bytes_.load();
+    data.peak = peak_.load();
+    return data;
+  }
+
+ private:
+  AllocatorImplPtr allocator_;
+  std::string name_;
+  std::atomic<size_t> allocation_count_{};
+  std::atomic<size_t> deallocation_count_{};
+  std::atomic<size_t> allocated_bytes_{};
+  std::atomic<size_t> deallocated_bytes_{};
+  std::atomic<size_t> peak_{};
+};
+
+// Caches freed blocks for reuse so that steady state workloads don't hit `upstream` at all. Small
+// blocks are kept in fixed size pools and large blocks in a best-fit tree. There is no arena-wide
+// lock: each pool has its own lock, so does the tree, and the counters are atomic.
+class Arena : public AllocatorImpl {
+ public:
+  struct Options {
+    // blocks smaller than `tiny_size` are served by pools with a granularity of `tiny_step`, so
+    // that small tensors are not rounded up to a multiple of `small_step`
+    size_t tiny_size{4 << 10};
+    size_t tiny_step{64};
+    // blocks smaller than `small_size` are served by pools with a granularity of `small_step`
+    size_t small_size{64 << 10};
+    size_t small_step{4 << 10};
+    // max number of cached blocks per pool
+    unsigned pool_size{8};
+    // max total size of cached large blocks
+    size_t max_cached_bytes{size_t{64} << 20};
+    // a cached large block is reused for requests no smaller than `threshold` of its size
+    float threshold{.875f};
+  };
+
+  Arena(AllocatorImplPtr upstream, const Options& options, const std::string& name)
+      : upstream_(std::make_shared<AtomicStats>(std::move(upstream), name + ".upstream")) {
+    auto tiny = CreatePoolBucketizer(0, options.tiny_size, options.tiny_step, options.pool_size,
+                                     upstream_);
+    auto small = CreatePoolBucketizer(options.tiny_size, options.small_size, options.small_step,
+                                      options.pool_size, upstream_);
+    auto large = std::make_shared<Locked>(
+        std::make_shared<Tree>(upstream_, options.max_cached_bytes, options.threshold));
+    requested_ = std::make_shared<AtomicStats>(
+        CreateSegregator(options.tiny_size - 1, std::move(tiny),
+                         CreateSegregator(options.small_size - 1, std::move(small),
+                                          std::move(large))),
+        name);
+  }
+
+  Block Allocate(size_t size) noexcept override { return requested_->Allocate(size); }
+
+  void Deallocate(Block& block) noexcept override { requested_->Deallocate(block); }
+
+  bool Owns(const Block& block) const noexcept override { return requested_->Owns(block); }
+
+  const char* Name() const noexcept override { return requested_->Name(); }
+
+  // allocations requested from the arena
+  Stats::Data requested() const { return requested_->data(); }
+
+  // allocations the arena failed to serve from its cache
+  Stats::Data upstream() const { return upstream_->data(); }
+
+  Result<AllocatorStats> GetStats() const override {
+    auto requested = requested_->data();
+    auto upstream = upstream_->data();
+    AllocatorStats stats;
+    stats.allocation_count = requested.allocation_count;
+    stats.upstream_allocation_count = upstream.allocation_count;
+    stats.in_use_bytes = requested.allocated_bytes - requested.deallocated_bytes;
+    auto held_bytes = upstream.allocated_bytes - upstream.deallocated_bytes;
+    // the two snapshots are not taken atomically
+    stats.cached_bytes = held_bytes > stats.in_use_bytes ? held_bytes - stats.in_use_bytes : 0;
+    stats.peak_bytes = upstream.peak;
+    return stats;
+  }
+
+ private:
+  std::shared_ptr<AtomicStats> upstream_;
+  std::shared_ptr<AtomicStats> requested_;
+};
+
 }  // namespace mmdeploy::device_allocator
 
 #endif  // MMDEPLOY_SRC_CORE_DEVICE_ALLOCATOR_H_
@@ -4,6 +4,8 @@
 #define MMDEPLOY_CSRC_EXECUTION_DYNAMIC_BATCH_H_
 
 #include <atomic>
+#include <optional>
+#include <vector>
 
 #include "mmdeploy/execution/then.h"
 #include "mmdeploy/execution/utility.h"
@@ -58,6 +60,45 @@ struct dynamic_batch_t {
 using _dynamic_batch::dynamic_batch_t;
 inline constexpr dynamic_batch_t DynamicBatch{};
 
+// counters of a dynamic batch scheduler, times are in microseconds
+struct DynamicBatchStats {
+  // number of batches by batch size
+  std::vector<size_t> batch_size_histogram;
+  size_t batch_count{};
+  // batches submitted when full
+  size_t full_submits{};
+  // batches submitted when the wait window ends
+  size_t timeouts{};
+  // total time the batches waited for more requests
+  double wait_time{};
+  // total time executing the batches
+  double execution_time{};
+  // current wait window, smoothed request interval & batch execution time
+  double timeout{};
+  double request_interval{};
+  double batch_execution_time{};
+};
+
+namespace _get_dynamic_batch_stats {
+
+struct get_dynamic_batch_stats_t {
+  template <typename Scheduler,
+            std::enable_if_t<tag_invocable<get_dynamic_batch_stats_t, const Scheduler&>, int> = 0>
+  std::optional<DynamicBatchStats> operator()(const Scheduler& scheduler) const {
+    return tag_invoke(*this, scheduler);
+  }
+  template <typename Scheduler,
+            std::enable_if_t<!tag_invocable<get_dynamic_batch_stats_t, const Scheduler&>, int> = 0>
+  std::optional<DynamicBatchStats> operator()(const Scheduler&) const {
+    return std::nullopt;
+  }
+};
+
+}  // namespace _get_dynamic_batch_stats
+
+using _get_dynamic_batch_stats::get_dynamic_batch_stats_t;
+inline constexpr get_dynamic_batch_stats_t GetDynamicBatchStats{};
+
 }  // namespace mmdeploy
 
 #endif  // MMDEPLOY_CSRC_EXECUTION_DYNAMIC_BATCH_H_
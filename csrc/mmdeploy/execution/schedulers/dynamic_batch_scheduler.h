@@ -3,6 +3,12 @@
 #ifndef MMDEPLOY_CSRC_EXECUTION_SCHEDULERS_DYNAMIC_BATCH_SCHEDULER_H_
 #define MMDEPLOY_CSRC_EXECUTION_SCHEDULERS_DYNAMIC_BATCH_SCHEDULER_H_
 
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include "mmdeploy/core/utils/formatter.h"
 #include "mmdeploy/execution/dynamic_batch.h"
 #include "mmdeploy/execution/schedulers/timed_single_thread_context.h"
@@ -12,6 +18,167 @@ namespace mmdeploy {
 
 namespace _dynamic_batch_scheduler {
 
+// Decides how long a batch waits for more requests and keeps the counters of a scheduler.
+//
+// With a latency SLO the wait window adapts to the load: it is the smaller of the time expected to
+// fill the batch at the current request rate and the SLO less the expected batch execution time.
+// No wait at all when not even one more request is expected within that budget. Without a SLO the
+// wait window is always `timeout`.
+class DynamicBatchPolicy {
+ public:
+  using duration_t = std::chrono::duration<int64_t, std::micro>;
+  using clock_t = std::chrono::steady_clock;
+
+  DynamicBatchPolicy(size_t max_batch_size, duration_t timeout, duration_t latency_slo = {})
+      : max_batch_size_(max_batch_size), timeout_(timeout), latency_slo_(latency_slo) {
+    stats_.batch_size_histogram.resize(max_batch_size_ + 1);
+    stats_.timeout = static_cast<double>(timeout_.count());
+  }
+
+  bool adaptive() const noexcept { return latency_slo_.count() > 0; }
+
+  void OnRequest(size_t count, clock_t::time_point now) {
+    std::lock_guard lock{mutex_};
+    if (last_request_ != clock_t::time_point{}) {
+      auto interval = std::chrono::duration<double, std::micro>(now - last_request_).count();
+      Update(stats_.request_interval, interval / static_cast<double>(count));
+    }
+    last_request_ = now;
+  }
+
+  // wait window of a new batch holding `size` requests
+  duration_t GetTimeout(size_t size) {
+    std::lock_guard lock{mutex_};
+    if (!adaptive() || stats_.request_interval <= 0) {
+      return timeout_;
+    }
+    auto budget = static_cast<double>(latency_slo_.count()) - stats_.batch_execution_time;
+    auto timeout = 0.;
+    if (budget >= stats_.request_interval) {
+      auto fill_time = static_cast<double>(max_batch_size_ - size) * stats_.request_interval;
+      timeout = std::min({budget, fill_time, static_cast<double>(timeout_.count())});
+    }
+    stats_.timeout = timeout;
+    return duration_t(static_cast<int64_t>(timeout));
+  }
+
+  void OnSubmit(size_t size, bool full, clock_t::duration wait_time) {
+    std::lock_guard lock{mutex_};
+    ++stats_.batch_count;
+    ++stats_.batch_size_histogram[std::min(size, max_batch_size_)];
+    ++(full ? stats_.full_submits : stats_.timeouts);
+    stats_.wait_time += std::chrono::duration<double, std::micro>(wait_time).count();
+  }
+
+  void OnExecute(clock_t::duration execution_time) {
+    std::lock_guard lock{mutex_};
+    auto t = std::chrono::duration<double, std::micro>(execution_time).count();
+    stats_.execution_time += t;
+    Update(stats_.batch_execution_time, t);
+  }
+
+  DynamicBatchStats GetStats() const {
+    std::lock_guard lock{mutex_};
+    return stats_;
+  }
+
+ private:
+  // exponential moving average
+  static void Update(double& average, double value) {
+    average = average > 0 ? average + kAlpha * (value - average) : value;
+  }
+
+  static constexpr double kAlpha = .125;
+
+  size_t max_batch_size_;
+  duration_t timeout_;
+  duration_t latency_slo_;
+  mutable std::mutex mutex_;
+  clock_t::time_point last_request_;
+  DynamicBatchStats stats_;
+};
+
+// Creates the policies of the batch contexts sharing a scheduler. Each context gets its own policy,
+// so that batch functions with different loads don't mix their request intervals and execution
+// times, while the counters are aggregated over all of them.
+class DynamicBatchPolicyGroup : public std::enable_shared_from_this<DynamicBatchPolicyGroup> {
+ public:
+  using duration_t = DynamicBatchPolicy::duration_t;
+
+  DynamicBatchPolicyGroup(size_t max_batch_size, duration_t timeout, duration_t latency_slo = {})
+      : max_batch_size_(max_batch_size), timeout_(timeout), latency_slo_(latency_slo) {
+    retired_.batch_size_histogram.resize(max_batch_size_ + 1);
+  }
+
+  std::shared_ptr<DynamicBatchPolicy> Create() {
+    // counters of a policy are kept by the group when it's destroyed
+    std::shared_ptr<DynamicBatchPolicy> policy(
+        new DynamicBatchPolicy(max_batch_size_, timeout_, latency_slo_),
+        [group = shared_from_this()](DynamicBatchPolicy* p) {
+          group->Retire(*p);
+          delete p;
+        });
+    std::lock_guard lock{mutex_};
+    policies_.push_back(policy);
+    return policy;
+  }
+
+  // the counters are summed up, the wait window, request interval & batch execution time are
+  // averaged over the live policies
+  DynamicBatchStats GetStats() const {
+    std::lock_guard lock{mutex_};
+    auto stats = retired_;
+    stats.timeout = static_cast<double>(timeout_.count());
+    size_t count = 0;
+    double timeout = 0;
+    for (const auto& weak : policies_) {
+      if (auto policy = weak.lock()) {
+        auto s = policy->GetStats();
+        Accumulate(stats, s);
+        timeout += s.timeout;
+        stats.request_interval += s.request_interval;
+        stats.batch_execution_time += s.batch_execution_time;
+        ++count;
+      }
+    }
+    if (count) {
+      stats.timeout = timeout / static_cast<double>(count);
+      stats.request_interval /= static_cast<double>(count);
+      stats.batch_execution_time /= static_cast<double>(count);
+    }
+    return stats;
+  }
+
+ private:
+  void Retire(const DynamicBatchPolicy& policy) {
+    auto stats = policy.GetStats();
+    std::lock_guard lock{mutex_};
+    Accumulate(retired_, stats);
+    policies_.erase(std::remove_if(policies_.begin(), policies_.end(),
+                                   [](const auto& weak) { return weak.expired(); }),
+                    policies_.end());
+  }
+
+  static void Accumulate(DynamicBatchStats& sum, const DynamicBatchStats& stats) {
+    for (size_t i = 0; i < sum.batch_size_histogram.size(); ++i) {
+      sum.batch_size_histogram[i] += stats.batch_size_histogram[i];
+    }
+    sum.batch_count += stats.batch_count;
+    sum.full_submits += stats.full_submits;
+    sum.timeouts += stats.timeouts;
+    sum.wait_time += stats.wait_time;
+    sum.execution_time += stats.execution_time;
+  }
+
+  size_t max_batch_size_;
+  duration_t timeout_;
+  duration_t latency_slo_;
+  mutable std::mutex mutex_;
+  std::vector<std::weak_ptr<DynamicBatchPolicy>> policies_;
+  // counters of the destroyed policies
+  DynamicBatchStats retired_;
+};
+
 template <typename SubmitSch, typename ExecuteSch, typename AssemblerType>
 struct DynamicBatchScheduler {
   using Assembler = AssemblerType;
@@ -21,10 +188,20 @@ struct DynamicBatchScheduler {
   TimedSingleThreadContext* timer_;
   size_t max_batch_size_;
   std::chrono::duration<int64_t, std::micro> timeout_;
+  // shared by the copies of the scheduler, a fixed timeout policy is used when it's empty
+  std::shared_ptr<DynamicBatchPolicyGroup> policies_{};
 
   friend auto tag_invoke(schedule_t, const DynamicBatchScheduler& self) {
     return Schedule(self.submit_sch_);
   }
+
+  friend std::optional<DynamicBatchStats> tag_invoke(get_dynamic_batch_stats_t,
+                                                     const DynamicBatchScheduler& self) {
+    if (self.policies_) {
+      return self.policies_->GetStats();
+    }
+    return std::nullopt;
+  }
 };
 
 template <typename... Args>
@@ -55,27 +232,41 @@ using context_base_t = dynamic_batch_t::context_base_t;
 //                         start   count
 using range_t = std::pair<size_t, size_t>;
 
+// Owned by the `dynamic_batch_t::context_t` it's created for, pending deferred submissions only
+// refer to it weakly and are canceled when it's destroyed.
 template <typename Sender, typename Scheduler, typename Receiver, typename Func>
-struct Context : context_base_t {
+struct Context : context_base_t,
+                 std::enable_shared_from_this<Context<Sender, Scheduler, Receiver, Func>> {
   using _duration_t = std::chrono::duration<int64_t, std::micro>;
 
   Scheduler scheduler_;
   using Assembler = typename Scheduler::Assembler;
   Func func_;
   size_t max_batch_size_;
-  _duration_t delay_;
   TimedSingleThreadContext* timer_;
+  std::shared_ptr<DynamicBatchPolicy> policy_;
 
   std::mutex mutex_;
   size_t counter_{0};
 
+  // released by `dynamic_batch_t::context_t`
+  std::shared_ptr<Context> self_;
+
   Context(Scheduler scheduler, Func func)
-      : context_base_t{[](context_base_t* p) { delete static_cast<Context*>(p); }},
+      : context_base_t{[](context_base_t* p) {
+          // the context is destroyed here unless a deferred submission is running
+          auto self = std::move(static_cast<Context*>(p)->self_);
+        }},
         scheduler_(std::move(scheduler)),
         func_(std::move(func)),
         max_batch_size_(scheduler_.max_batch_size_),
-        delay_(scheduler_.timeout_),
-        timer_(scheduler_.timer_) {}
+        timer_(scheduler_.timer_) {
+    if (scheduler_.policies_) {
+      policy_ = scheduler_.policies_->Create();
+    } else {
+      policy_ = std::make_shared<DynamicBatchPolicy>(max_batch_size_, scheduler_.timeout_);
+    }
+  }
 
   ~Context() { MMDEPLOY_DEBUG("~Context()"); }
 
@@ -88,14 +279,18 @@ struct Context : context_base_t {
     std::vector<range_t> ranges_;
     completion_signatures_of_t<Sender> values_;
     size_t size_{0};
+    DynamicBatchPolicy::clock_t::time_point created_;
     Batch(Context* context, size_t index, size_t max_batch_size)
-        : context_(context), index_(index), values_{} {
+        : context_(context),
+          index_(index),
+          values_{},
+          created_(DynamicBatchPolicy::clock_t::now()) {
       states_.reserve(max_batch_size);
       ranges_.reserve(max_batch_size);
     }
 
     friend std::ostream& operator<<(std::ostream& os, const Batch& batch) {
-      os << fmt::format("(index={}, size={})", batch.index_, batch.size_);
+      return os << fmt::format("(index={}, size={})", batch.index_, batch.size_);
     }
   };
 
@@ -107,6 +302,7 @@ struct Context : context_base_t {
     const size_t size = Assembler::get_size((Args &&) args...);
     op_state->count_ = size;
     op_state->batch_size_ = size;
+    policy_->OnRequest(size, DynamicBatchPolicy::clock_t::now());
 
     size_t index = 0;
     while (index != size) {
@@ -128,40 +324,58 @@ struct Context : context_base_t {
       if (batch->size_ == max_batch_size_) {
         MMDEPLOY_DEBUG("direct submit of batch {}", *batch);
         // batch is full, submit immediately
-        Execute(scheduler_.execute_sch_, [this, batch = std::move(batch)] { Run(*batch); });
+        SubmitNow(std::move(batch), true);
       } else if (new_batch && timer_) {
-        MMDEPLOY_DEBUG("set off deferred submission for batch {}", *batch);
-        // set off a deferred task to submit the batch if it still exists at the moment.
-        StartDetached(Then(ScheduleAfter(timer_->GetScheduler(), delay_),
-                           [this, batch_index = batch->index_] { Submit(batch_index); }));
+        // without a latency SLO, a zero timeout still defers the submission to the timer, which
+        // gathers the requests arriving in the meantime
+        if (auto delay = policy_->GetTimeout(batch->size_);
+            delay.count() > 0 || !policy_->adaptive()) {
+          MMDEPLOY_DEBUG("set off deferred submission for batch {}", *batch);
+          // set off a deferred task to submit the batch if it still exists at the moment.
+          StartDetached(Then(ScheduleAfter(timer_->GetScheduler(), delay),
+                             [self = this->weak_from_this(), batch_index = batch->index_] {
+                               // the submission is canceled if the context is gone
+                               if (auto context = self.lock()) {
+                                 context->Submit(batch_index);
+                               }
+                             }));
+        } else {
+          MMDEPLOY_DEBUG("no more requests expected, submit batch {}", *batch);
+          SubmitNow(std::move(batch), false);
+        }
       }
     }
 
     batch_ = std::move(batch);
   }
 
+  void SubmitNow(std::unique_ptr<Batch> batch, bool full) {
+    policy_->OnSubmit(batch->size_, full, DynamicBatchPolicy::clock_t::now() - batch->created_);
+    Execute(scheduler_.execute_sch_, [this, batch = std::move(batch)] { Run(*batch); });
+  }
+
   void Submit(size_t batch_index) {
-    Execute(scheduler_.execute_sch_, [this, batch_index] {
-      std::unique_ptr<Batch> batch;
-      {
-        std::lock_guard lock{mutex_};
-        if (batch_ && batch_->index_ == batch_index) {
-          batch = std::move(batch_);
-        } else {
-          MMDEPLOY_DEBUG("batch index mismatch, signal canceled ({} vs {})", batch_index,
-                         (batch_ ? (int)batch_->index_ : -1));
-        }
-      }
-      if (batch) {
-        MMDEPLOY_DEBUG("deferred submit of batch {}", *batch);
-        Run(*batch);
+    std::unique_ptr<Batch> batch;
+    {
+      std::lock_guard lock{mutex_};
+      if (batch_ && batch_->index_ == batch_index) {
+        batch = std::move(batch_);
+      } else {
+        MMDEPLOY_DEBUG("batch index mismatch, signal canceled ({} vs {})", batch_index,
+                       (batch_ ? (int)batch_->index_ : -1));
       }
-    });
+    }
+    if (batch) {
+      MMDEPLOY_DEBUG("deferred submit of batch {}", *batch);
+      SubmitNow(std::move(batch), false);
+    }
   }
 
   void Run(Batch& batch) {
+    auto t0 = DynamicBatchPolicy::clock_t::now();
     auto rets = std::apply([&](auto&&... args) { return func_((decltype(args)&&)args...); },
                            std::move(batch.values_));
+    policy_->OnExecute(DynamicBatchPolicy::clock_t::now() - t0);
     auto& states = batch.states_;
     auto& ranges = batch.ranges_;
     size_t start = 0;
@@ -210,13 +424,15 @@ struct _Operation<Sender, Scheduler, Receiver, Func>::type {
     if (old) {
       return static_cast<_context_t*>(old);
     } else {
-      auto p = std::make_unique<_context_t>(scheduler, std::move(func));
+      auto p = std::make_shared<_context_t>(scheduler, std::move(func));
+      p->self_ = p;
       if (context.compare_exchange_strong(old, p.get(), std::memory_order_release,
                                           std::memory_order_acquire)) {
-        // context is filled with p, and now it has the ownership of its value
-        return p.release();
+        // context is filled with p, and now it shares the ownership of its value
+        return p.get();
       } else {
         // old contains context created by some other thread, p will be destroyed
+        p->self_.reset();
         return static_cast<_context_t*>(old);
       }
     }
@@ -274,6 +490,8 @@ auto tag_invoke(dynamic_batch_t, const scheduler_t<Args...>& scheduler, Sender&&
 
 }  // namespace _dynamic_batch_scheduler
 
+using _dynamic_batch_scheduler::DynamicBatchPolicy;
+using _dynamic_batch_scheduler::DynamicBatchPolicyGroup;
 using _dynamic_batch_scheduler::DynamicBatchScheduler;
 
 }  // namespace mmdeploy
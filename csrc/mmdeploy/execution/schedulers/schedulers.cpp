@@ -1,11 +1,15 @@
 // Copyright (c) OpenMMLab. All rights reserved.
 
+#include <algorithm>
+#include <thread>
+
 #include "mmdeploy/execution/schedulers/dynamic_batch_scheduler.h"
 #include "mmdeploy/execution/schedulers/inlined_scheduler.h"
 #include "mmdeploy/execution/schedulers/registry.h"
 #include "mmdeploy/execution/schedulers/single_thread_context.h"
 #include "mmdeploy/execution/schedulers/static_thread_pool.h"
 #include "mmdeploy/execution/schedulers/timed_single_thread_context.h"
+#include "mmdeploy/execution/schedulers/work_stealing_thread_pool.h"
 
 namespace mmdeploy {
 
@@ -50,6 +54,29 @@ class StaticThreadPoolSchedCreator : public Creator<Scheduler> {
  public:
   const char* GetName() const override { return "ThreadPool"; }
   int GetVersion() const override { return 0; }
+  ReturnType Create(const Value& cfg) override {
+    auto num_threads = -1;
+    auto bulk_grain_size = 0;
+    if (cfg.is_object() && cfg.contains("num_threads")) {
+      num_threads = cfg["num_threads"].get<int>();
+    }
+    if (cfg.is_object() && cfg.contains("bulk_grain_size")) {
+      bulk_grain_size = std::max(0, cfg["bulk_grain_size"].get<int>());
+    }
+    if (num_threads < 1) {
+      num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    return CreateFromContext(
+        std::make_unique<__static_thread_pool::StaticThreadPool>(num_threads, bulk_grain_size));
+  }
+};
+
+REGISTER_MODULE(Scheduler, StaticThreadPoolSchedCreator);
+
+class WorkStealingThreadPoolSchedCreator : public Creator<Scheduler> {
+ public:
+  const char* GetName() const override { return "WorkStealingThreadPool"; }
+  int GetVersion() const override { return 0; }
   ReturnType Create(const Value& cfg) override {
     auto num_threads = -1;
     if (cfg.is_object() && cfg.contains("num_threads")) {
@@ -57,14 +84,15 @@ class StaticThreadPoolSchedCreator : public Creator<Scheduler> {
     }
     if (num_threads >= 1) {
       return CreateFromContext(
-          std::make_unique<__static_thread_pool::StaticThreadPool>(num_threads));
+          std::make_unique<__work_stealing_thread_pool::WorkStealingThreadPool>(num_threads));
     } else {
-      return CreateFromContext(std::make_unique<__static_thread_pool::StaticThreadPool>());
+      return CreateFromContext(
+          std::make_unique<__work_stealing_thread_pool::WorkStealingThreadPool>());
     }
   }
 };
 
-REGISTER_MODULE(Scheduler, StaticThreadPoolSchedCreator);
+REGISTER_MODULE(Scheduler, WorkStealingThreadPoolSchedCreator);
 
 struct ValueAssembler {
   using range_t = std::pair<size_t, size_t>;
@@ -132,8 +160,14 @@ class DynamicBatchSchedCreator : public Creator<Scheduler> {
     if (timeout >= 0) {
       timer = &gTimedSingleThreadContext();
     }
+    // adapt the wait window to meet the latency SLO (in microseconds) when it's specified
+    auto latency_slo = cfg.value("latency_slo", 0);
+    auto policies = std::make_shared<DynamicBatchPolicyGroup>(
+        (size_t)max_batch_size, std::chrono::microseconds(timeout),
+        std::chrono::microseconds(latency_slo));
     return ReturnType{SchedulerType{inline_scheduler, std::move(scheduler), timer,
-                                    (size_t)max_batch_size, std::chrono::microseconds(timeout)}};
+                                    (size_t)max_batch_size, std::chrono::microseconds(timeout),
+                                    std::move(policies)}};
   }
 };
 
@@ -5,11 +5,15 @@
 #ifndef MMDEPLOY_CSRC_EXPERIMENTAL_EXECUTION_STATIC_THREAD_POOL_H_
 #define MMDEPLOY_CSRC_EXPERIMENTAL_EXECUTION_STATIC_THREAD_POOL_H_
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <mutex>
+#include <optional>
 #include <thread>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "intrusive_queue.h"
@@ -31,12 +35,22 @@ struct _Operation {
 template <typename Receiver>
 using operation_t = typename _Operation<remove_cvref_t<Receiver>>::type;
 
+namespace __bulk {
+
+template <typename Receiver, typename Shape, typename Func, typename Tuple>
+struct _Receiver;
+
+}  // namespace __bulk
+
 class StaticThreadPool;
 
 struct Scheduler {
   template <typename Receiver>
   friend struct _Operation;
 
+  template <typename Receiver, typename Shape, typename Func, typename Tuple>
+  friend struct __bulk::_Receiver;
+
   struct Sender {
     using value_types = std::tuple<>;
 
@@ -84,9 +98,14 @@ class StaticThreadPool {
   template <typename Receiver>
   friend struct _Operation;
 
+  template <typename Receiver, typename Shape, typename Func, typename Tuple>
+  friend struct __bulk::_Receiver;
+
  public:
   StaticThreadPool();
-  explicit StaticThreadPool(std::uint32_t thread_count);
+  // `bulk_grain_size` is the number of consecutive indices claimed at a time by the tasks of a bulk
+  // operation, 0 for a grain size derived from the shape
+  explicit StaticThreadPool(std::uint32_t thread_count, std::size_t bulk_grain_size = 0);
   ~StaticThreadPool();
 
   Scheduler GetScheduler() noexcept { return Scheduler{*this}; }
@@ -115,6 +134,7 @@ class StaticThreadPool {
   void Enqueue(TaskBase* task) noexcept;
 
   std::uint32_t thread_count_;
+  std::size_t bulk_grain_size_;
   std::vector<std::thread> threads_;
   std::vector<ThreadState> thread_states_;
   std::atomic<std::uint32_t> next_thread_;
@@ -142,8 +162,11 @@ struct _Operation<Receiver>::type : TaskBase {
 inline StaticThreadPool::StaticThreadPool()
     : StaticThreadPool(std::thread::hardware_concurrency()) {}
 
-inline StaticThreadPool::StaticThreadPool(std::uint32_t thread_count)
-    : thread_count_(thread_count), thread_states_(thread_count), next_thread_(0) {
+inline StaticThreadPool::StaticThreadPool(std::uint32_t thread_count, std::size_t bulk_grain_size)
+    : thread_count_(thread_count),
+      bulk_grain_size_(bulk_grain_size),
+      thread_states_(thread_count),
+      next_thread_(0) {
   assert(thread_count_ > 0);
 
   threads_.reserve(thread_count_);
@@ -269,12 +292,11 @@ inline void StaticThreadPool::ThreadState::request_stop() {
 
 namespace __bulk {
 
-template <typename CvrefSender, typename Shape, typename Func, typename Receiver>
-struct _Operation {
-  struct type;
-};
-template <typename CvrefSender, typename Shape, typename Func, typename Receiver>
-using operation_t = typename _Operation<CvrefSender, Shape, Func, Receiver>::type;
+// Bulk runs on at most `kMaxChunks` tasks of the pool. Instead of owning a fixed slice of the
+// index space, a task claims `grain` consecutive indices at a time from a shared counter until all
+// of them are claimed, so the tasks that finish early take over the remaining chunks of the slow
+// ones.
+inline constexpr std::uint32_t kMaxChunks = 32;
 
 template <typename Receiver, typename Shape, typename Func, typename Tuple>
 struct _Receiver {
@@ -285,36 +307,100 @@ using receiver_t = typename _Receiver<remove_cvref_t<Receiver>, Shape, Func, Tup
 
 template <typename Receiver, typename Shape, typename Func, typename Tuple>
 struct _Receiver<Receiver, Shape, Func, Tuple>::type {
+  struct State;
+
+  struct Chunk : TaskBase {
+    State* state_;
+  };
+
+  // allocated once per operation, including the tasks enqueued to the pool
   struct State {
+    State(Receiver&& receiver, Shape shape, Func&& func, StaticThreadPool& pool)
+        : receiver_((Receiver &&) receiver), shape_(shape), func_((Func &&) func), pool_(pool) {}
+
     Receiver receiver_;
     Shape shape_;
     Func func_;
+    StaticThreadPool& pool_;
     std::optional<Tuple> values_;
-    Scheduler scheduler_;
-    std::atomic<Shape> count_;
+    Shape grain_{};
+    std::atomic<Shape> next_{};
+    std::atomic<std::uint32_t> pending_{};
+    std::array<Chunk, kMaxChunks> chunks_{};
   };
 
-  std::shared_ptr<State> state_;
+  State* state_;
 
   type(Receiver&& receiver, Shape shape, Func func, Scheduler scheduler)
-      : state_(new State{(Receiver &&) receiver, shape, (Func &&) func, std::nullopt, scheduler,
-                         shape}) {}
+      : state_(new State((Receiver &&) receiver, shape, (Func &&) func, *scheduler.pool_)) {}
+
+  type(type&& other) noexcept : state_(std::exchange(other.state_, nullptr)) {}
+
+  ~type() { delete state_; }
+
+  static void Execute(TaskBase* task) noexcept {
+    auto state = static_cast<Chunk*>(task)->state_;
+    const auto shape = state->shape_;
+    const auto grain = state->grain_;
+    auto& values = *state->values_;
+    for (auto begin = state->next_.fetch_add(grain, std::memory_order_relaxed); begin < shape;
+         begin = state->next_.fetch_add(grain, std::memory_order_relaxed)) {
+      const auto end = shape - begin > grain ? begin + grain : shape;
+      std::apply(
+          [&](auto&... vals) {
+            for (auto index = begin; index < end; ++index) {
+              state->func_(index, vals...);
+            }
+          },
+          values);
+    }
+    if (state->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      Complete(state);
+    }
+  }
+
+  // the state is released before completion, the receiver may destroy the operation it belongs to
+  static void Complete(State* state) noexcept {
+    auto receiver = std::move(state->receiver_);
+    auto values = std::move(*state->values_);
+    delete state;
+    std::apply([&](auto&... vals) { SetValue(std::move(receiver), std::move(vals)...); }, values);
+  }
 
   template <typename... As>
-  friend void tag_invoke(set_value_t, type&& self, As&&... as) noexcept {
-    auto& state = self.state_;
+  static void Start(State* state, As&&... as) noexcept {
     state->values_.emplace((As &&) as...);
-    for (Shape index = {}; index < state->shape_; ++index) {
-      StartDetached(Then(Schedule(state->scheduler_), [state, index] {
-        std::apply([&](auto&... vals) { state->func_(index, vals...); }, state->values_.value());
-        if (0 == --state->count_) {
-          std::apply(
-              [&](auto&... vals) { SetValue(std::move(state->receiver_), std::move(vals)...); },
-              state->values_.value());
-        }
-        return 0;
-      }));
+    const auto shape = state->shape_;
+    if (!(Shape{} < shape)) {
+      return Complete(state);
     }
+    auto& pool = state->pool_;
+    const auto max_chunks = std::min(pool.thread_count_, kMaxChunks);
+    auto grain = static_cast<Shape>(pool.bulk_grain_size_);
+    if (!(Shape{} < grain)) {
+      // ~4 chunks per task for load balancing
+      grain = std::max(static_cast<Shape>(shape / static_cast<Shape>(max_chunks * 4)), Shape{1});
+    }
+    const auto n_chunks = static_cast<std::uint32_t>(
+        std::min<std::common_type_t<Shape, std::uint32_t>>((shape - 1) / grain + 1, max_chunks));
+    state->grain_ = grain;
+    state->pending_.store(n_chunks, std::memory_order_relaxed);
+    for (std::uint32_t i = 0; i < n_chunks; ++i) {
+      state->chunks_[i].execute_ = &Execute;
+      state->chunks_[i].state_ = state;
+    }
+    for (std::uint32_t i = 1; i < n_chunks; ++i) {
+      pool.Enqueue(&state->chunks_[i]);
+    }
+    // the predecessor completes on the pool, so the current thread takes part in the work instead
+    // of waiting for it
+    Execute(&state->chunks_[0]);
+  }
+
+  template <typename... As>
+  friend void tag_invoke(set_value_t, type&& self, As&&... as) noexcept {
+    // the state is owned by the chunks from now on, the last one of them completes the operation
+    Start(std::exchange(self.state_, nullptr), (As &&) as...);
   }
 };
 
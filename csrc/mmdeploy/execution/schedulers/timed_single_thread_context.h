@@ -112,7 +112,8 @@ class MMDEPLOY_API TimedSingleThreadContext {
   void Run() {
     std::unique_lock lock{mutex_};
 
-    while (!stop_) {
+    // the pending tasks are run before stopping
+    while (!stop_ || head_ != nullptr) {
       if (head_ != nullptr) {
         auto now = Clock::now();
         auto next_due_time = head_->due_time_;
@@ -0,0 +1,134 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+// Chase-Lev deque following "Correct and Efficient Work-Stealing for Weak Memory Models"
+// (Lê, Pop, Cohen, Zappa Nardelli, PPoPP'13)
+
+#ifndef MMDEPLOY_CSRC_EXECUTION_SCHEDULERS_WORK_STEALING_DEQUE_H_
+#define MMDEPLOY_CSRC_EXECUTION_SCHEDULERS_WORK_STEALING_DEQUE_H_
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace mmdeploy {
+
+// Single-producer multi-consumer deque of pointers. The owner thread pushes & pops at the bottom
+// (LIFO), other threads steal from the top (FIFO). The buffer grows on demand; outgrown buffers are
+// kept until the deque is destroyed because concurrent thieves may still be reading them.
+template <typename T>
+class WorkStealingDeque {
+  static_assert(std::is_pointer_v<T>);
+
+  class Array {
+   public:
+    explicit Array(int64_t capacity)
+        : mask_(capacity - 1), buffer_(new std::atomic<T>[capacity]) {
+      assert((capacity & mask_) == 0);
+    }
+
+    int64_t capacity() const noexcept { return mask_ + 1; }
+
+    T get(int64_t index) const noexcept {
+      return buffer_[index & mask_].load(std::memory_order_relaxed);
+    }
+
+    void put(int64_t index, T item) noexcept {
+      buffer_[index & mask_].store(item, std::memory_order_relaxed);
+    }
+
+    std::unique_ptr<Array> grow(int64_t bottom, int64_t top) const {
+      auto array = std::make_unique<Array>(capacity() * 2);
+      for (auto i = top; i != bottom; ++i) {
+        array->put(i, get(i));
+      }
+      return array;
+    }
+
+   private:
+    int64_t mask_;
+    std::unique_ptr<std::atomic<T>[]> buffer_;
+  };
+
+ public:
+  explicit WorkStealingDeque(int64_t capacity = 1024)
+      : top_(0), bottom_(0), array_(new Array(capacity)) {
+    buffers_.emplace_back(array_.load(std::memory_order_relaxed));
+  }
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  bool empty() const noexcept {
+    auto b = bottom_.load(std::memory_order_relaxed);
+    auto t = top_.load(std::memory_order_relaxed);
+    return b <= t;
+  }
+
+  // owner only
+  void push(T item) {
+    auto b = bottom_.load(std::memory_order_relaxed);
+    auto t = top_.load(std::memory_order_acquire);
+    auto array = array_.load(std::memory_order_relaxed);
+    if (b - t > array->capacity() - 1) {
+      buffers_.push_back(array->grow(b, t));
+      array = buffers_.back().get();
+      array_.store(array, std::memory_order_release);
+    }
+    array->put(b, item);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  // owner only, returns nullptr when the deque is empty
+  T pop() noexcept {
+    auto b = bottom_.load(std::memory_order_relaxed) - 1;
+    auto array = array_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto t = top_.load(std::memory_order_relaxed);
+    T item = nullptr;
+    if (t <= b) {
+      item = array->get(b);
+      if (t == b) {
+        // last item, race against thieves
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+          item = nullptr;
+        }
+        bottom_.store(b + 1, std::memory_order_relaxed);
+      }
+    } else {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  // any thread, returns nullptr when the deque is empty or the race is lost
+  T steal() noexcept {
+    auto t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto b = bottom_.load(std::memory_order_acquire);
+    if (t < b) {
+      auto array = array_.load(std::memory_order_acquire);
+      T item = array->get(t);
+      if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        return nullptr;
+      }
+      return item;
+    }
+    return nullptr;
+  }
+
+ private:
+  alignas(64) std::atomic<int64_t> top_;
+  alignas(64) std::atomic<int64_t> bottom_;
+  std::atomic<Array*> array_;
+  std::vector<std::unique_ptr<Array>> buffers_;
+};
+
+}  // namespace mmdeploy
+
+#endif  // MMDEPLOY_CSRC_EXECUTION_SCHEDULERS_WORK_STEALING_DEQUE_H_
@@ -0,0 +1,402 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+#ifndef MMDEPLOY_CSRC_EXECUTION_SCHEDULERS_WORK_STEALING_THREAD_POOL_H_
+#define MMDEPLOY_CSRC_EXECUTION_SCHEDULERS_WORK_STEALING_THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "intrusive_queue.h"
+#include "mmdeploy/execution/execution.h"
+#include "work_stealing_deque.h"
+
+namespace mmdeploy {
+
+namespace __work_stealing_thread_pool {
+
+struct TaskBase {
+  TaskBase* next_;
+  void (*execute_)(TaskBase*) noexcept;
+};
+
+template <typename Receiver>
+struct _Operation {
+  struct type;
+};
+template <typename Receiver>
+using operation_t = typename _Operation<remove_cvref_t<Receiver>>::type;
+
+class WorkStealingThreadPool;
+
+namespace __bulk {
+template <typename Receiver, typename Shape, typename Func, typename Tuple>
+struct _Receiver;
+}
+
+struct Scheduler {
+  template <typename Receiver>
+  friend struct _Operation;
+
+  struct Sender {
+    using value_types = std::tuple<>;
+
+    template <typename Receiver>
+    operation_t<Receiver> MakeOperation(Receiver&& r) const {
+      return {pool_, (Receiver &&) r};
+    }
+
+    template <typename Receiver>
+    friend operation_t<Receiver> tag_invoke(connect_t, Sender s, Receiver&& r) {
+      return s.MakeOperation((Receiver &&) r);
+    }
+
+    friend auto tag_invoke(get_completion_scheduler_t, const Sender& sender) noexcept -> Scheduler {
+      return Scheduler{sender.pool_};
+    }
+
+    friend struct Scheduler;
+
+    explicit Sender(WorkStealingThreadPool& pool) noexcept : pool_(pool) {}
+
+    WorkStealingThreadPool& pool_;
+  };
+
+  Sender MakeSender_() const { return Sender{*pool_}; }
+
+  friend class WorkStealingThreadPool;
+  template <typename Receiver, typename Shape, typename Func, typename Tuple>
+  friend struct __bulk::_Receiver;
+
+ public:
+  explicit Scheduler(WorkStealingThreadPool& pool) noexcept : pool_(&pool) {}
+
+  friend bool operator==(Scheduler a, Scheduler b) noexcept { return a.pool_ == b.pool_; }
+
+  friend bool operator!=(Scheduler a, Scheduler b) noexcept { return a.pool_ != b.pool_; }
+
+  friend Sender tag_invoke(schedule_t, const Scheduler& self) noexcept {
+    return self.MakeSender_();
+  }
+
+ private:
+  WorkStealingThreadPool* pool_{nullptr};
+};
+
+// Each worker owns a Chase-Lev deque. Tasks scheduled from a worker thread are pushed to & popped
+// from the bottom of its own deque (LIFO) without locking; idle workers steal from the top of other
+// workers' deques (FIFO). Tasks scheduled from outside the pool go through a shared queue.
+class WorkStealingThreadPool {
+  template <typename Receiver>
+  friend struct _Operation;
+  template <typename Receiver, typename Shape, typename Func, typename Tuple>
+  friend struct __bulk::_Receiver;
+
+ public:
+  WorkStealingThreadPool();
+  explicit WorkStealingThreadPool(std::uint32_t thread_count);
+  ~WorkStealingThreadPool();
+
+  Scheduler GetScheduler() noexcept { return Scheduler{*this}; }
+
+  void RequestStop() noexcept;
+
+ private:
+  struct WorkerContext {
+    WorkStealingThreadPool* pool;
+    std::uint32_t index;
+  };
+
+  static WorkerContext& CurrentWorker() noexcept {
+    static thread_local WorkerContext context{};
+    return context;
+  }
+
+  void Run(std::uint32_t index) noexcept;
+  void Join() noexcept;
+
+  void Enqueue(TaskBase* task) noexcept;
+  void Notify() noexcept;
+
+  TaskBase* TryPop(std::uint32_t index) noexcept;
+  TaskBase* TryPopShared() noexcept;
+  TaskBase* TrySteal(std::uint32_t index) noexcept;
+
+  static constexpr int kSpinCount = 64;
+
+  std::uint32_t thread_count_;
+  std::vector<std::thread> threads_;
+  std::vector<WorkStealingDeque<TaskBase*>> deques_;
+
+  // `CurrentWorker` is resolved once here, modules built with hidden visibility would otherwise
+  // each get their own copy of the thread-local context
+  WorkerContext& (*current_worker_)() noexcept;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  intrusive_queue<&TaskBase::next_> queue_;
+  std::atomic<std::size_t> queue_size_{0};
+  std::atomic<std::uint32_t> num_sleeping_{0};
+  bool stop_requested_{false};
+};
+
+template <typename Receiver>
+struct _Operation<Receiver>::type : TaskBase {
+  friend Scheduler::Sender;
+
+  WorkStealingThreadPool& pool_;
+  Receiver receiver_;
+
+  type(WorkStealingThreadPool& pool, Receiver&& r)
+      : TaskBase{}, pool_(pool), receiver_((Receiver &&) r) {
+    this->execute_ = [](TaskBase* t) noexcept {
+      auto& op = *static_cast<type*>(t);
+      SetValue((Receiver &&) op.receiver_);
+    };
+  }
+
+  void enqueue_(TaskBase* op) const { return pool_.Enqueue(op); }
+
+  friend void tag_invoke(start_t, type& op) noexcept { op.enqueue_(&op); }
+};
+
+inline WorkStealingThreadPool::WorkStealingThreadPool()
+    : WorkStealingThreadPool(std::thread::hardware_concurrency()) {}
+
+inline WorkStealingThreadPool::WorkStealingThreadPool(std::uint32_t thread_count)
+    : thread_count_(thread_count), deques_(thread_count), current_worker_(&CurrentWorker) {
+  assert(thread_count_ > 0);
+
+  threads_.reserve(thread_count_);
+
+  try {
+    for (std::uint32_t i = 0; i < thread_count_; ++i) {
+      threads_.emplace_back([this, i] { Run(i); });
+    }
+  } catch (...) {
+    RequestStop();
+    Join();
+    throw;
+  }
+}
+
+inline WorkStealingThreadPool::~WorkStealingThreadPool() {
+  RequestStop();
+  Join();
+}
+
+inline void WorkStealingThreadPool::RequestStop() noexcept {
+  {
+    std::lock_guard lock{mutex_};
+    stop_requested_ = true;
+  }
+  cv_.notify_all();
+}
+
+inline void WorkStealingThreadPool::Run(std::uint32_t index) noexcept {
+  current_worker_() = {this, index};
+  while (true) {
+    TaskBase* task = nullptr;
+    for (int i = 0; i < kSpinCount && !task; ++i) {
+      if (!(task = TryPop(index))) {
+        std::this_thread::yield();
+      }
+    }
+    if (!task) {
+      std::unique_lock lock{mutex_};
+      // announce before the final check, pairs with the fence in `Notify`
+      num_sleeping_.fetch_add(1, std::memory_order_seq_cst);
+      while (true) {
+        if (!queue_.empty()) {
+          queue_size_.fetch_sub(1, std::memory_order_relaxed);
+          task = queue_.pop_front();
+          break;
+        }
+        if ((task = TrySteal(index)) || stop_requested_) {
+          break;
+        }
+        cv_.wait(lock);
+      }
+      num_sleeping_.fetch_sub(1, std::memory_order_relaxed);
+      if (!task) {
+        break;
+      }
+    }
+    task->execute_(task);
+  }
+  current_worker_() = {};
+}
+
+inline void WorkStealingThreadPool::Join() noexcept {
+  for (auto& t : threads_) {
+    t.join();
+  }
+  threads_.clear();
+}
+
+inline void WorkStealingThreadPool::Enqueue(TaskBase* task) noexcept {
+  auto& worker = current_worker_();
+  if (worker.pool == this) {
+    deques_[worker.index].push(task);
+  } else {
+    std::lock_guard lock{mutex_};
+    queue_.push_back(task);
+    queue_size_.fetch_add(1, std::memory_order_relaxed);
+  }
+  Notify();
+}
+
+inline void WorkStealingThreadPool::Notify() noexcept {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (num_sleeping_.load(std::memory_order_relaxed) > 0) {
+    std::lock_guard lock{mutex_};
+    cv_.notify_one();
+  }
+}
+
+inline TaskBase* WorkStealingThreadPool::TryPop(std::uint32_t index) noexcept {
+  if (auto task = deques_[index].pop()) {
+    return task;
+  }
+  if (auto task = TryPopShared()) {
+    return task;
+  }
+  return TrySteal(index);
+}
+
+inline TaskBase* WorkStealingThreadPool::TryPopShared() noexcept {
+  if (queue_size_.load(std::memory_order_relaxed) == 0) {
+    return nullptr;
+  }
+  std::lock_guard lock{mutex_};
+  if (queue_.empty()) {
+    return nullptr;
+  }
+  queue_size_.fetch_sub(1, std::memory_order_relaxed);
+  return queue_.pop_front();
+}
+
+inline TaskBase* WorkStealingThreadPool::TrySteal(std::uint32_t index) noexcept {
+  for (std::uint32_t i = 1; i < thread_count_; ++i) {
+    auto victim = (index + i) < thread_count_ ? (index + i) : (index + i - thread_count_);
+    if (auto task = deques_[victim].steal()) {
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+namespace __bulk {
+
+template <typename Receiver, typename Shape, typename Func, typename Tuple>
+struct _Receiver {
+  struct type;
+};
+template <typename Receiver, typename Shape, typename Func, typename Tuple>
+using receiver_t = typename _Receiver<remove_cvref_t<Receiver>, Shape, Func, Tuple>::type;
+
+template <typename Receiver, typename Shape, typename Func, typename Tuple>
+struct _Receiver<Receiver, Shape, Func, Tuple>::type {
+  struct State {
+    Receiver receiver_;
+    Shape shape_;
+    Func func_;
+    std::optional<Tuple> values_;
+    Scheduler scheduler_;
+    Shape max_chunks_;
+    std::atomic<Shape> count_{};
+  };
+
+  std::shared_ptr<State> state_;
+
+  type(Receiver&& receiver, Shape shape, Func func, Scheduler scheduler)
+      : state_(new State{(Receiver &&) receiver, shape, (Func &&) func, std::nullopt, scheduler,
+                         static_cast<Shape>(scheduler.pool_->thread_count_ * 4)}) {}
+
+  static void Complete(const std::shared_ptr<State>& state) noexcept {
+    std::apply([&](auto&... vals) { SetValue(std::move(state->receiver_), std::move(vals)...); },
+               state->values_.value());
+  }
+
+  // the index space is split into a few consecutive chunks per worker. When completed on a worker,
+  // the chunks are pushed to its own deque and idle workers steal them from the other end
+  template <typename... As>
+  friend void tag_invoke(set_value_t, type&& self, As&&... as) noexcept {
+    auto& state = self.state_;
+    state->values_.emplace((As &&) as...);
+    const auto shape = state->shape_;
+    if (!(Shape{} < shape)) {
+      return Complete(state);
+    }
+    const auto n_chunks = std::min(shape, state->max_chunks_);
+    const auto grain = static_cast<Shape>(shape / n_chunks);
+    const auto remainder = static_cast<Shape>(shape % n_chunks);
+    state->count_.store(n_chunks, std::memory_order_relaxed);
+    Shape begin{};
+    for (Shape chunk{}; chunk < n_chunks; ++chunk) {
+      const auto end = static_cast<Shape>(begin + grain + (chunk < remainder ? 1 : 0));
+      StartDetached(Then(Schedule(state->scheduler_), [state, begin, end] {
+        std::apply(
+            [&](auto&... vals) {
+              for (auto index = begin; index < end; ++index) {
+                state->func_(index, vals...);
+              }
+            },
+            state->values_.value());
+        if (0 == --state->count_) {
+          Complete(state);
+        }
+        return 0;
+      }));
+      begin = end;
+    }
+  }
+};
+
+template <typename Sender, typename Shape, typename Func>
+struct _Sender {
+  struct type;
+};
+template <typename Sender, typename Shape, typename Func>
+using sender_t = typename _Sender<remove_cvref_t<Sender>, remove_cvref_t<Shape>, Func>::type;
+
+template <typename Sender, typename Shape, typename Func>
+struct _Sender<Sender, Shape, Func>::type {
+  using value_types = completion_signatures_of_t<Sender>;
+  template <typename Receiver>
+  using _receiver_t = receiver_t<Receiver, Shape, Func, value_types>;
+
+  Sender sender_;
+  Scheduler scheduler_;
+  Shape shape_;
+  Func func_;
+
+  template <typename Self, typename Receiver, _decays_to<Self, type, int> = 0>
+  friend auto tag_invoke(connect_t, Self&& self, Receiver&& receiver) {
+    return Connect(((Self &&) self).sender_,
+                   _receiver_t<Receiver>{(Receiver &&) receiver, ((Self &&) self).shape_,
+                                         ((Self &&) self).func_, ((Self &&) self).scheduler_});
+  }
+};
+
+}  // namespace __bulk
+
+template <typename Sender, typename Shape, typename Func>
+__bulk::sender_t<Sender, Shape, Func> tag_invoke(bulk_t, Scheduler scheduler, Sender&& sender,
+                                                 Shape&& shape, Func&& func) {
+  return {(Sender &&) sender, scheduler, (Shape &&) shape, (Func &&) func};
+}
+
+}  // namespace __work_stealing_thread_pool
+
+using __work_stealing_thread_pool::WorkStealingThreadPool;
+
+}  // namespace mmdeploy
+
+#endif  // MMDEPLOY_CSRC_EXECUTION_SCHEDULERS_WORK_STEALING_THREAD_POOL_H_
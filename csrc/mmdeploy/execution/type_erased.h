@@ -3,8 +3,21 @@
 #ifndef MMDEPLOY_CSRC_EXPERIMENTAL_EXECUTION_TYPE_ERASED_H_
 #define MMDEPLOY_CSRC_EXPERIMENTAL_EXECUTION_TYPE_ERASED_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+
 #include "mmdeploy/execution/execution.h"
 
+// capacity in bytes of the inline buffer of type erased senders, the objects that don't fit are
+// allocated on the heap (or the current `TypeErasedArena`). Operations, which hold the type erased
+// receivers, get twice the capacity. It must be the same for all translation units.
+#ifndef MMDEPLOY_TYPE_ERASED_INLINE_SIZE
+#define MMDEPLOY_TYPE_ERASED_INLINE_SIZE 64
+#endif
+
 // ! DO NOT INCLUDE THIS FILE DIRECTLY IF SPECIALIZATION OF `capture_completion_scheduler` IS
 // NEEDED, ALL TRANSLATION UNITS MUST SEE THE SAME SPECIALIZATION
 
@@ -62,6 +75,218 @@ struct _BulkFn<std::tuple<Ts...>> {
 template <typename ValueTypes>
 using _bulk_fn_t = typename _BulkFn<ValueTypes>::type;
 
+///////////////////////////////////////////////////////////////////////////////
+// Storage
+///////////////////////////////////////////////////////////////////////////////
+
+// While alive, counts the heap allocations made by the current thread for the type erased objects,
+// including the arenas and their blocks. Counters may be nested, only the innermost one counts.
+class TypeErasedAllocationCounter {
+ public:
+  TypeErasedAllocationCounter() noexcept : prev_(std::exchange(Current(), this)) {}
+
+  ~TypeErasedAllocationCounter() { Current() = prev_; }
+
+  TypeErasedAllocationCounter(const TypeErasedAllocationCounter&) = delete;
+  TypeErasedAllocationCounter& operator=(const TypeErasedAllocationCounter&) = delete;
+
+  size_t count() const noexcept { return count_; }
+
+  static void _Count() noexcept {
+    if (auto counter = Current()) {
+      ++counter->count_;
+    }
+  }
+
+ private:
+  static TypeErasedAllocationCounter*& Current() noexcept {
+    static thread_local TypeErasedAllocationCounter* counter{};
+    return counter;
+  }
+
+  size_t count_{};
+  TypeErasedAllocationCounter* prev_;
+};
+
+// Bump allocator for the type erased objects that don't fit inline. Memory is never reused, it's
+// released as a whole when the owner and all the objects allocated from it are gone, so the objects
+// may safely outlive the scope of the arena, e.g. when they are destroyed on other threads.
+class _Arena {
+ public:
+  explicit _Arena(size_t block_size) noexcept : block_size_(block_size) {}
+
+  _Arena(const _Arena&) = delete;
+  _Arena& operator=(const _Arena&) = delete;
+
+  // the arena the objects created by the current thread are allocated from
+  static _Arena*& Current() noexcept {
+    static thread_local _Arena* arena{};
+    return arena;
+  }
+
+  // only called from the thread the arena is current on
+  void* Allocate(size_t size, size_t align) {
+    auto space = static_cast<size_t>(end_ - cur_);
+    void* ptr = cur_;
+    if (!cur_ || !std::align(align, size, ptr, space)) {
+      auto capacity = std::max(block_size_, size + align);
+      auto block = static_cast<Block*>(::operator new(sizeof(Block) + capacity));
+      TypeErasedAllocationCounter::_Count();
+      block->next = blocks_;
+      blocks_ = block;
+      cur_ = reinterpret_cast<char*>(block + 1);
+      end_ = cur_ + capacity;
+      ptr = cur_;
+      space = capacity;
+      std::align(align, size, ptr, space);
+    }
+    cur_ = static_cast<char*>(ptr) + size;
+    refs_.fetch_add(1, std::memory_order_relaxed);
+    return ptr;
+  }
+
+  // called by the owner & for each of the allocated objects
+  void Release() noexcept {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+ private:
+  struct alignas(std::max_align_t) Block {
+    Block* next;
+  };
+
+  ~_Arena() {
+    while (blocks_) {
+      ::operator delete(std::exchange(blocks_, blocks_->next));
+    }
+  }
+
+  size_t block_size_;
+  std::atomic<size_t> refs_{1};
+  Block* blocks_{};
+  char* cur_{};
+  char* end_{};
+};
+
+// Owning pointer to an `Interface`, the object is created in the inline buffer if it fits and is
+// nothrow movable, it's relocated when the storage is moved. An `InlineSize` of 0 disables the
+// inline buffer, the object then never moves.
+template <typename Interface, size_t InlineSize>
+class _Storage {
+ public:
+  static constexpr size_t kInlineSize = InlineSize;
+
+  template <typename Impl>
+  static constexpr bool is_inline_v =
+      sizeof(Impl) <= kInlineSize && alignof(Impl) <= alignof(std::max_align_t) &&
+      std::is_nothrow_move_constructible_v<Impl>;
+
+  _Storage() noexcept = default;
+
+  _Storage(_Storage&& other) noexcept { MoveFrom(other); }
+
+  _Storage& operator=(_Storage&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  _Storage(const _Storage&) = delete;
+  _Storage& operator=(const _Storage&) = delete;
+
+  ~_Storage() { Reset(); }
+
+  template <typename Impl, typename... Args>
+  void Emplace(Args&&... args) {
+    Reset();
+    if constexpr (is_inline_v<Impl>) {
+      ptr_ = ::new (static_cast<void*>(buffer_)) Impl((Args &&) args...);
+      relocate_ = &Relocate<Impl>;
+    } else if (auto arena = _Arena::Current()) {
+      auto ptr = arena->Allocate(sizeof(Impl), alignof(Impl));
+      try {
+        ptr_ = ::new (ptr) Impl((Args &&) args...);
+      } catch (...) {
+        arena->Release();
+        throw;
+      }
+      arena_ = arena;
+    } else {
+      ptr_ = new Impl((Args &&) args...);
+      TypeErasedAllocationCounter::_Count();
+    }
+  }
+
+  Interface* operator->() const noexcept { return ptr_; }
+
+ private:
+  void Reset() noexcept {
+    if (!ptr_) {
+      return;
+    }
+    if (relocate_ || arena_) {
+      ptr_->~Interface();
+      if (arena_) {
+        arena_->Release();
+      }
+    } else {
+      delete ptr_;
+    }
+    ptr_ = nullptr;
+    relocate_ = nullptr;
+    arena_ = nullptr;
+  }
+
+  void MoveFrom(_Storage& other) noexcept {
+    ptr_ = other.relocate_ ? other.relocate_(buffer_, other.ptr_) : other.ptr_;
+    relocate_ = std::exchange(other.relocate_, nullptr);
+    arena_ = std::exchange(other.arena_, nullptr);
+    other.ptr_ = nullptr;
+  }
+
+  template <typename Impl>
+  static Interface* Relocate(void* dst, Interface* src) noexcept {
+    auto& impl = static_cast<Impl&>(*src);
+    Interface* ptr = ::new (dst) Impl(std::move(impl));
+    impl.~Impl();
+    return ptr;
+  }
+
+  Interface* ptr_{};
+  // non-null iff the object is inline
+  Interface* (*relocate_)(void*, Interface*) noexcept {};
+  _Arena* arena_{};
+  alignas(std::max_align_t) unsigned char buffer_[kInlineSize ? kInlineSize : 1];
+};
+
+// While alive, the type erased objects created by the current thread that don't fit inline are
+// allocated from a per-request arena instead of the heap. Arenas must be destroyed in the reverse
+// order of creation on the thread that created them. The memory is released when the arena and all
+// the objects allocated from it are destroyed.
+class TypeErasedArena {
+ public:
+  explicit TypeErasedArena(size_t block_size = 4096)
+      : arena_(new _Arena(block_size)), prev_(std::exchange(_Arena::Current(), arena_)) {
+    TypeErasedAllocationCounter::_Count();
+  }
+
+  ~TypeErasedArena() {
+    _Arena::Current() = prev_;
+    arena_->Release();
+  }
+
+  TypeErasedArena(const TypeErasedArena&) = delete;
+  TypeErasedArena& operator=(const TypeErasedArena&) = delete;
+
+ private:
+  _Arena* arena_;
+  _Arena* prev_;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // Operation
 ///////////////////////////////////////////////////////////////////////////////
@@ -81,7 +306,10 @@ class _TypeErasedOperation {
   friend void tag_invoke(start_t, _TypeErasedOperation& op_state) { op_state.impl_->_Start(); }
 
  private:
-  std::unique_ptr<Impl> impl_;
+  // operation states may point into themselves (e.g. a receiver referring back to its state), so
+  // they are never relocated: they live in the arena or on the heap, and moving the operation only
+  // moves the pointer
+  _Storage<Impl, 0> impl_;
 };
 
 template <typename Operation>
@@ -97,7 +325,7 @@ struct _TypeErasedOperationImpl : _TypeErasedOperation::Impl {
 template <typename Fun, typename>
 _TypeErasedOperation::_TypeErasedOperation(Fun&& fun) {
   using _Operation = std::invoke_result_t<Fun>;
-  impl_.reset(new _TypeErasedOperationImpl<_Operation>{(Fun &&) fun});
+  impl_.template Emplace<_TypeErasedOperationImpl<_Operation>>((Fun &&) fun);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -154,16 +382,18 @@ class _TypeErasedSender {
   struct Impl {
     virtual ~Impl() = default;
     virtual _Operation _Connect(_Receiver) = 0;
-    virtual std::unique_ptr<Impl> _Clone() const = 0;
+    virtual void _Clone(_Storage<Impl, MMDEPLOY_TYPE_ERASED_INLINE_SIZE>& storage) const = 0;
     virtual _Scheduler _GetCompletionScheduler() const = 0;
   };
 
   _TypeErasedSender(_TypeErasedSender&& other) noexcept = default;
   _TypeErasedSender& operator=(_TypeErasedSender&& other) noexcept = default;
 
-  _TypeErasedSender(const _TypeErasedSender& other) : impl_(other.impl_->_Clone()) {}
+  _TypeErasedSender(const _TypeErasedSender& other) { other.impl_->_Clone(impl_); }
   _TypeErasedSender& operator=(const _TypeErasedSender& other) {
-    impl_ = other.impl_->_Clone();
+    if (this != &other) {
+      other.impl_->_Clone(impl_);
+    }
     return *this;
   }
 
@@ -192,7 +422,7 @@ class _TypeErasedSender {
   /* implicit */ _TypeErasedSender(Sender&& sender);
 
  private:
-  std::unique_ptr<Impl> impl_;
+  _Storage<Impl, MMDEPLOY_TYPE_ERASED_INLINE_SIZE> impl_;
 };
 
 template <typename... Ts>
@@ -227,14 +457,13 @@ struct _TypeErasedSenderImpl : _TypeErasedSender<ValueTypes>::Impl {
     }
   }
 
-  std::unique_ptr<Base> _Clone() const override {
+  void _Clone(_Storage<Base, MMDEPLOY_TYPE_ERASED_INLINE_SIZE>& storage) const override {
     if constexpr (std::is_copy_constructible_v<Sender>) {
-      return std::make_unique<_TypeErasedSenderImpl>(sender_);
+      storage.template Emplace<_TypeErasedSenderImpl>(sender_);
     } else {
       MMDEPLOY_ERROR("attempt to clone non-copyable sender");
       std::abort();
     }
-    return {};
   }
 
  private:
@@ -250,7 +479,7 @@ template <typename ValueTypes>
 template <typename Sender, typename>
 _TypeErasedSender<ValueTypes>::_TypeErasedSender(Sender&& sender) {
   using _Sender = remove_cvref_t<Sender>;
-  impl_ = std::make_unique<_TypeErasedSenderImpl<_Sender>>((Sender &&) sender);
+  impl_.template Emplace<_TypeErasedSenderImpl<_Sender>>((Sender &&) sender);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -275,7 +504,8 @@ class _TypeErasedReceiver {
   }
 
  private:
-  std::unique_ptr<Impl> impl_;
+  // receivers usually refer to the states of their operations, a couple of pointers at most
+  _Storage<Impl, 4 * sizeof(void*)> impl_;
 };
 
 template <typename Receiver, typename ValueTypes>
@@ -295,7 +525,7 @@ template <typename ValueTypes>
 template <typename Receiver, typename>
 _TypeErasedReceiver<ValueTypes>::_TypeErasedReceiver(Receiver&& receiver) {
   using _Receiver = std::decay_t<Receiver>;
-  impl_ = std::make_unique<_TypeErasedReceiverImpl<_Receiver, ValueTypes>>((Receiver &&) receiver);
+  impl_.template Emplace<_TypeErasedReceiverImpl<_Receiver, ValueTypes>>((Receiver &&) receiver);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -332,6 +562,7 @@ class _TypeErasedScheduler {
         std::abort();
       }
     }
+    virtual std::optional<DynamicBatchStats> _GetDynamicBatchStats() const { return std::nullopt; }
     // virtual SenderType _ScheduleFrom(SenderType) = 0;
     // virtual SenderType _Then(SenderType input, ThenFun fun) = 0;
     // virtual SenderType _LetValue() = 0;
@@ -375,6 +606,11 @@ class _TypeErasedScheduler {
     return self.impl_->_DynamicBatch(SenderAdapterType{std::move(input)}, context, std::move(fun));
   }
 
+  friend std::optional<DynamicBatchStats> tag_invoke(get_dynamic_batch_stats_t,
+                                                     const _TypeErasedScheduler& self) {
+    return self.impl_->_GetDynamicBatchStats();
+  }
+
  private:
   std::shared_ptr<Impl> impl_;
 };
@@ -419,6 +655,10 @@ struct _TypeErasedSchedulerImpl : _TypeErasedScheduler<ValueTypes>::Impl {
     }
   }
 
+  std::optional<DynamicBatchStats> _GetDynamicBatchStats() const override {
+    return GetDynamicBatchStats(scheduler_);
+  }
+
   explicit _TypeErasedSchedulerImpl(Scheduler sched) : scheduler_(std::move(sched)) {}
   Scheduler scheduler_;
 };
@@ -447,6 +687,8 @@ struct type_erase_t {
 using _type_erased::type_erase_t;
 inline constexpr type_erase_t TypeErase{};
 
+using _type_erased::TypeErasedAllocationCounter;
+using _type_erased::TypeErasedArena;
 using _type_erased::TypeErasedOperation;
 using _type_erased::TypeErasedScheduler;
 using _type_erased::TypeErasedSender;
@@ -14,3 +14,57 @@ mmdeploy::graph::BaseNode::BaseNode(const mmdeploy::Value& cfg) {
     throw;
   }
 }
+
+namespace mmdeploy::graph {
+
+Result<Scheduler> CreateThreadPool(int num_threads) {
+  Value config{{"type", "ThreadPool"}};
+  if (num_threads > 0) {
+    config["num_threads"] = num_threads;
+  }
+  return CreateFromRegistry<Scheduler>(config);
+}
+
+Sender<Value> Gate::Admission::Enter(Value value) {
+  return CallbackSender([this, value = std::move(value)](auto&& done) {
+    auto& gate = *gate_;
+    std::unique_lock lock{gate.mutex_};
+    if (gate.count_ > 0) {
+      --gate.count_;
+      admitted_ = true;
+      lock.unlock();
+      done(value);
+    } else {
+      gate.waiting_.emplace_back([this, done, value] {
+        admitted_ = true;
+        done(value);
+      });
+    }
+  });
+}
+
+void Gate::Admission::Leave() {
+  if (admitted_.exchange(false)) {
+    gate_->Release();
+  }
+}
+
+void Gate::Release() {
+  std::unique_lock lock{mutex_};
+  if (waiting_.empty()) {
+    ++count_;
+    return;
+  }
+  // the admission is passed on to the first waiting execution
+  auto start = std::move(waiting_.front());
+  waiting_.pop_front();
+  lock.unlock();
+  start();
+}
+
+Result<Scheduler> GetDefaultThreadPool() {
+  static auto pool = CreateThreadPool(-1);
+  return pool;
+}
+
+}  // namespace mmdeploy::graph
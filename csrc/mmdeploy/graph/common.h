@@ -3,6 +3,11 @@
 #ifndef MMDEPLOY_SRC_GRAPH_COMMON_H_
 #define MMDEPLOY_SRC_GRAPH_COMMON_H_
 
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+
 #include "mmdeploy/core/graph.h"
 #include "mmdeploy/core/module.h"
 #include "mmdeploy/core/registry.h"
@@ -42,6 +47,90 @@ inline Result<RetType> CreateFromRegistry(const Value& config, const char* key =
   return std::move(inst);
 }
 
+// completes with the value passed to the callback of `start_`, on the thread invoking it
+template <typename Start>
+struct _CallbackSender {
+  struct type;
+};
+template <typename Start>
+using callback_sender_t = typename _CallbackSender<std::decay_t<Start>>::type;
+
+template <typename Start, typename Receiver>
+struct _CallbackOperation {
+  struct type;
+};
+template <typename Start, typename Receiver>
+using callback_operation_t = typename _CallbackOperation<Start, remove_cvref_t<Receiver>>::type;
+
+template <typename Start, typename Receiver>
+struct _CallbackOperation<Start, Receiver>::type {
+  Start start_;
+  Receiver receiver_;
+  friend void tag_invoke(start_t, type& op_state) noexcept {
+    op_state.start_([&op_state](Value value) {
+      SetValue(std::move(op_state.receiver_), std::move(value));
+    });
+  }
+};
+
+template <typename Start>
+struct _CallbackSender<Start>::type {
+  using value_types = std::tuple<Value>;
+  Start start_;
+
+  template <typename Self, typename Receiver, _decays_to<Self, type, int> = 0>
+  friend callback_operation_t<Start, Receiver> tag_invoke(connect_t, Self&& self,
+                                                          Receiver&& receiver) {
+    return {((Self &&) self).start_, (Receiver &&) receiver};
+  }
+};
+
+template <typename Start>
+callback_sender_t<Start> CallbackSender(Start&& start) {
+  return {(Start &&) start};
+}
+
+// Admits up to `count` executions of a node at a time, across the requests of the pipeline. The
+// executions over the limit are queued, and started by the completion of the admitted ones.
+class MMDEPLOY_API Gate {
+ public:
+  explicit Gate(int count) : count_(count) {}
+
+  // An execution of the node. Its admission is given back by `Leave` when the node completes, or by
+  // the destructor when the execution is torn down without completing, e.g. by an exception.
+  class MMDEPLOY_API Admission {
+   public:
+    explicit Admission(std::shared_ptr<Gate> gate) : gate_(std::move(gate)) {}
+    ~Admission() { Leave(); }
+
+    Admission(const Admission&) = delete;
+    Admission& operator=(const Admission&) = delete;
+
+    // completes with `value` when the execution is admitted
+    Sender<Value> Enter(Value value);
+
+    void Leave();
+
+   private:
+    std::shared_ptr<Gate> gate_;
+    std::atomic_bool admitted_{false};
+  };
+
+ private:
+  void Release();
+
+  std::mutex mutex_;
+  int count_;
+  std::deque<std::function<void()>> waiting_;
+};
+
+using Scheduler = TypeErasedScheduler<Value>;
+
+Result<Scheduler> CreateThreadPool(int num_threads);
+
+// thread pool shared by the pipelines to run independent nodes concurrently
+Result<Scheduler> GetDefaultThreadPool();
+
 class BaseNode : public Node {
  protected:
   explicit BaseNode(const Value& cfg);
@@ -97,12 +97,50 @@ Pipeline::State::State(vector<int> use_count, Sender<Value> args)
 }
 
 Sender<Value> Pipeline::Process(Sender<Value> args) {
+  std::shared_ptr<Profiler::TimePoint> begin;
+  if (profiler_) {
+    begin = std::make_shared<Profiler::TimePoint>();
+    args = Then(std::move(args), [begin](Value v) {
+      *begin = Profiler::Now();
+      return v;
+    });
+  }
   State state(use_count_, std::move(args));
   for (size_t i = 0; i < nodes_.size(); ++i) {
     auto input = state.Collect(input_coords_[i]);
-    auto output = nodes_[i]->Process(std::move(input));
+    // taken by this request to execute a bounded node
+    std::shared_ptr<Gate::Admission> admission;
+    if (gates_[i]) {
+      admission = std::make_shared<Gate::Admission>(gates_[i]);
+      input = LetValue(std::move(input),
+                       [admission](Value& v) { return admission->Enter(std::move(v)); });
+    }
+    if (schedulers_[i]) {
+      input = Transfer(std::move(input), *schedulers_[i]);
+    }
+    // the nodes depending on a failed node are skipped, the error is passed on to their outputs
+    auto& node = *nodes_[i];
+    Sender<Value> output = LetValue(std::move(input), [&node](Value& v) -> Sender<Value> {
+      if (auto error = FindError(v)) {
+        return Just(Value(Value::Array(node.outputs().size(), Value(*error))));
+      }
+      return node.Process(Just(std::move(v)));
+    });
+    if (admission) {
+      // the node is complete only when its output is, e.g. for nodes completed by a backend
+      output = Then(std::move(output), [admission](Value v) {
+        admission->Leave();
+        return v;
+      });
+    }
     state.Write(static_cast<int>(i), std::move(output));
   }
+  if (profiler_) {
+    return Then(state.Collect(ret_coords_), [this, begin](Value v) {
+      profiler_.Record(name_.empty() ? "pipeline" : name_, "pipeline", *begin, Profiler::Now());
+      return v;
+    });
+  }
   return state.Collect(ret_coords_);
 }
 
@@ -123,7 +161,22 @@ Result<unique_ptr<Pipeline>> PipelineParser::Parse(const Value& config) {
     vector<vector<Pipeline::Coords>> input_coords;
     input_coords.reserve(size);
 
+    // optional per-node bound on the number of concurrent executions
+    vector<int> max_concurrency;
+    max_concurrency.reserve(size);
+
     use_count_.resize(size + 1);
+    levels_.reserve(size);
+
+    // profiling is enabled by {"profiler": {"path": "trace.json"}} or the environment variable
+    // `MMDEPLOY_PROFILER`, nested pipelines share the profiler of the outermost one
+    auto context = config.value("context", Value(ValueType::kObject));
+    if (!context.contains("profiler")) {
+      if (auto profiler = Profiler::FromConfig(config)) {
+        context["profiler"] = profiler;
+      }
+    }
+    pipeline->profiler_ = context.value("profiler", Profiler{});
 
     OUTCOME_TRY(UpdateOutputCoords(static_cast<int>(size), pipeline->inputs()));
     for (auto task_config : task_configs) {
@@ -132,12 +185,14 @@ Result<unique_ptr<Pipeline>> PipelineParser::Parse(const Value& config) {
       auto name = task_config.value<string>("name", "");
       auto type = task_config.value<string>("type", "");
       // propagate context
-      if (config.contains("context")) {
-        task_config["context"].update(config["context"]);
+      if (!context.empty()) {
+        task_config["context"].update(context);
       }
       OUTCOME_TRY(auto node, CreateFromRegistry<Node>(task_config));
       if (node) {
         OUTCOME_TRY(auto coords, GetInputCoords(node->inputs()));
+        levels_.push_back(GetLevel(coords));
+        max_concurrency.push_back(task_config.value("max_concurrency", 0));
         input_coords.push_back(std::move(coords));
         OUTCOME_TRY(UpdateOutputCoords(index, node->outputs()));
         nodes.push_back(std::move(node));
@@ -148,10 +203,32 @@ Result<unique_ptr<Pipeline>> PipelineParser::Parse(const Value& config) {
     }
     OUTCOME_TRY(auto coords, GetInputCoords(pipeline->outputs()));
 
+    // nodes sharing a dependency level are independent of each other, they are started on the
+    // thread pool so that the branches of the graph run concurrently
+    vector<int> level_size(size);
+    for (const auto& level : levels_) {
+      ++level_size[level];
+    }
+    auto parallel = config["pipeline"].value("parallel", true);
+    vector<std::optional<Scheduler>> schedulers(size);
+    vector<std::shared_ptr<Gate>> gates(size);
+    for (size_t i = 0; i < size; ++i) {
+      if (max_concurrency[i] > 0) {
+        // the gate bounds the node's concurrency across requests, including the nodes releasing
+        // the thread before they complete. The node has a dedicated pool of the same size.
+        gates[i] = std::make_shared<Gate>(max_concurrency[i]);
+        OUTCOME_TRY(schedulers[i], CreateThreadPool(max_concurrency[i]));
+      } else if (parallel && level_size[levels_[i]] > 1) {
+        OUTCOME_TRY(schedulers[i], GetDefaultThreadPool());
+      }
+    }
+
     pipeline->nodes_ = std::move(nodes);
     pipeline->use_count_ = std::move(use_count_);
     pipeline->input_coords_ = std::move(input_coords);
     pipeline->ret_coords_ = std::move(coords);
+    pipeline->schedulers_ = std::move(schedulers);
+    pipeline->gates_ = std::move(gates);
 
     return std::move(pipeline);
 
@@ -183,6 +260,17 @@ Result<vector<Pipeline::Coords>> PipelineParser::GetInputCoords(const vector<str
   return ret;
 }
 
+int PipelineParser::GetLevel(const vector<Pipeline::Coords>& coords) const {
+  int level = 0;
+  for (const auto& coord : coords) {
+    // the pipeline's inputs are indexed after the nodes
+    if (coord.index < static_cast<int>(levels_.size())) {
+      level = std::max(level, levels_[coord.index] + 1);
+    }
+  }
+  return level;
+}
+
 Result<void> PipelineParser::UpdateOutputCoords(int index, const vector<string>& names) {
   for (int i = 0; i < names.size(); ++i) {
     const auto& output = names[i];
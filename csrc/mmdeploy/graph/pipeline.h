@@ -8,12 +8,15 @@
 #include "mmdeploy/core/graph.h"
 #include "mmdeploy/core/module.h"
 #include "mmdeploy/core/operator.h"
+#include "mmdeploy/core/profiler.h"
 #include "mmdeploy/core/value.h"
 #include "mmdeploy/execution/schedulers/registry.h"
 #include "mmdeploy/execution/when_all_value.h"
 
 namespace mmdeploy::graph {
 
+class Gate;
+
 class Pipeline : public Node {
   friend class PipelineParser;
 
@@ -34,6 +37,12 @@ class Pipeline : public Node {
   vector<int> use_count_;
   vector<vector<Coords>> input_coords_;
   vector<Coords> ret_coords_;
+  // scheduler a node's input is transferred to before the node is processed, nodes without one
+  // are processed on the thread that completes their inputs
+  vector<std::optional<TypeErasedScheduler<Value>>> schedulers_;
+  // bounds the number of concurrent executions of a node, null for unbounded nodes
+  vector<std::shared_ptr<Gate>> gates_;
+  Profiler profiler_;
 };
 
 class PipelineParser {
@@ -45,8 +54,13 @@ class PipelineParser {
 
   Result<void> UpdateOutputCoords(int index, const vector<string>& names);
 
+  // dependency level of a node, 0 for nodes depending on the pipeline's inputs only
+  int GetLevel(const vector<Pipeline::Coords>& coords) const;
+
   // use count for each node's output
   vector<int> use_count_;
+  // dependency level for each node
+  vector<int> levels_;
   // name -> (node_id, port_id)
   std::map<string, pair<int, int>> output_name_to_coords_;
 };
@@ -2,14 +2,93 @@
 
 #include "mmdeploy/graph/task.h"
 
+#include <atomic>
+#include <thread>
+
 #include "mmdeploy/core/operator.h"
 #include "mmdeploy/graph/common.h"
 
 namespace mmdeploy::graph {
 
+void Task::Record(size_t batch_size, Profiler::TimePoint ready, Profiler::TimePoint begin) {
+  auto end = Profiler::Now();
+  profiler_.Record(name_, "node", begin, end, {{"batch_size", batch_size}});
+  profiler_.Sample(name_ + "/batch_size", static_cast<double>(batch_size));
+  // time the input waited for the scheduler (and for the batch to be formed)
+  profiler_.Sample(name_ + "/wait",
+                   std::chrono::duration<double, std::micro>(begin - ready).count());
+}
+
+Result<Value> Task::Run(const Value& input, Profiler::TimePoint ready) {
+  auto begin = profiler_ ? Profiler::Now() : Profiler::TimePoint{};
+  Result<Value> output = Status(eFail);
+  try {
+    output = module_->Process(input);
+  } catch (const Exception& e) {
+    MMDEPLOY_ERROR("exception caught while running task {}: {}", name_, e.what());
+    output = failure(e.code());
+  }
+  if (profiler_) {
+    Record(input.front().is_array() ? input.front().size() : 1, ready, begin);
+  }
+  return output;
+}
+
+void Task::RunAsync(const Value& input, Profiler::TimePoint ready,
+                    std::function<void(Value)> done) {
+  auto begin = profiler_ ? Profiler::Now() : Profiler::TimePoint{};
+  auto batch_size = input.front().is_array() ? input.front().size() : 1;
+  auto caller = std::this_thread::get_id();
+  auto completed = std::make_shared<std::atomic_bool>(false);
+  auto complete = [this, ready, begin, batch_size, caller, completed,
+                   done = std::move(done)](Result<Value> output) {
+    completed->store(true);
+    if (profiler_) {
+      Record(batch_size, ready, begin);
+    }
+    // failures can't be thrown on the thread completing the module, they are passed as values
+    Value value;
+    if (output) {
+      value = std::move(output).value();
+    } else {
+      value = Value::Array(outputs_.size(), Value(NodeError{output.error().value().ec}));
+    }
+    if (std::this_thread::get_id() == caller) {
+      done(std::move(value));
+    } else {
+      // the downstream nodes are not run on the thread of the backend
+      Execute(GetDefaultThreadPool().value(), [done, value = std::move(value)]() mutable {
+        done(std::move(value));
+      });
+    }
+  };
+  try {
+    module_->ProcessAsync(input, complete);
+  } catch (const Exception& e) {
+    if (completed->load()) {
+      throw;
+    }
+    MMDEPLOY_ERROR("exception caught while starting task {}: {}", name_, e.what());
+    complete(failure(e.code()));
+  } catch (const std::exception& e) {
+    if (completed->load()) {
+      throw;
+    }
+    MMDEPLOY_ERROR("exception caught while starting task {}: {}", name_, e.what());
+    complete(Status(eFail));
+  } catch (...) {
+    if (completed->load()) {
+      throw;
+    }
+    MMDEPLOY_ERROR("unknown exception caught while starting task {}", name_);
+    complete(Status(eFail));
+  }
+}
+
 Sender<Value> Task::Process(Sender<Value> input) {
   return LetValue(std::move(input), [this](Value& v) -> Sender<Value> {
     assert(v.is_array());
+    auto ready = profiler_ ? Profiler::Now() : Profiler::TimePoint{};
     // handle empty input
     if (v.front().empty()) {
       return TransferJust(*sched_, Value(Value::Array(v.size(), Value::kArray)));
@@ -23,18 +102,34 @@ Sender<Value> Task::Process(Sender<Value> input) {
             auto input = graph::DistribAA(v).value();
             return Value{std::move(input), std::move(output)};
           })
-          | Bulk(batch_size, [&](size_t index, Value& in_out) {
+          | Bulk(batch_size, [this, ready](size_t index, Value& in_out) {
             const auto& input = in_out[0];
             auto& output = in_out[1];
-            output[index] = module_->Process(input[index]).value();
+            if (auto r = Run(input[index], ready)) {
+              output[index] = std::move(r).value();
+            } else {
+              output[index] = Value(NodeError{r.error().value().ec});
+            }
           })
-          | Then([](const Value& in_out) {
+          | Then([this](const Value& in_out) {
+            // the bulk may run on threads that can't throw, a failed sample fails the batch
+            for (const auto& output : in_out[1]) {
+              if (auto error = output.get_ptr<const NodeError*>()) {
+                return Value(Value::Array(outputs_.size(), Value(*error)));
+              }
+            }
             return graph::DistribAA(in_out[1]).value();
           });
       // clang-format on
+    } else if (is_async_) {
+      // the calling thread is released as soon as the module is started, e.g. the inference of a
+      // `Net` module is running on its backend, and the task is completed by the module
+      return CallbackSender([this, ready, input = std::move(v)](auto&& done) {
+        RunAsync(input, ready, (decltype(done)&&)done);
+      });
     } else {
       return DynamicBatch(TransferJust(*sched_, std::move(v)), batch_context_,
-                          [&](const Value& u) { return module_->Process(u).value(); });
+                          [this, ready](const Value& u) { return Run(u, ready).value(); });
     }
   });
 }
@@ -59,9 +154,13 @@ Result<unique_ptr<Task>> TaskParser::Parse(const Value& config) {
     if (!sched_set) {
       task->sched_ =
           TypeErasedScheduler<Value>{std::make_shared<TypeErasedScheduler<Value>::Impl>()};
+      task->is_async_ = true;
     }
     task->is_batched_ = config.value("is_batched", false);
     task->is_thread_safe_ = config.value("is_thread_safe", false);
+    if (config["context"].contains("profiler")) {
+      task->profiler_ = config["context"]["profiler"].get<Profiler>();
+    }
     return std::move(task);
   } catch (const std::exception& e) {
     MMDEPLOY_ERROR("error parsing config: {}", config);
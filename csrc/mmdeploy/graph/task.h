@@ -4,6 +4,7 @@
 #define MMDEPLOY_CSRC_GRAPH_TASK_H_
 
 #include "mmdeploy/core/graph.h"
+#include "mmdeploy/core/profiler.h"
 
 namespace mmdeploy::graph {
 
@@ -14,11 +15,24 @@ class Task : public Node {
   Sender<Value> Process(Sender<Value> input) override;
 
  private:
+  // `ready` is when the input became available, for profiling
+  Result<Value> Run(const Value& input, Profiler::TimePoint ready);
+
+  // same as `Run`, but `done` is invoked with the output when the module completes, failures are
+  // passed as `NodeError` outputs. `done` is invoked on the default thread pool when the module is
+  // completed by another thread, e.g. the one of its backend
+  void RunAsync(const Value& input, Profiler::TimePoint ready, std::function<void(Value)> done);
+
+  void Record(size_t batch_size, Profiler::TimePoint ready, Profiler::TimePoint begin);
+
   std::optional<TypeErasedScheduler<Value>> sched_;
   unique_ptr<Module> module_;
   bool is_batched_{false};
   bool is_thread_safe_{false};
+  // no executor is configured, the module is run by `RunAsync`
+  bool is_async_{false};
   dynamic_batch_t::context_t batch_context_;
+  Profiler profiler_;
 };
 
 class TaskParser {
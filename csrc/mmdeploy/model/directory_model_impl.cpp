@@ -38,6 +38,10 @@ class DirectoryModelImpl : public ModelImpl {
     return str;
   }
 
+  Result<FileView> MapFile(const std::string& file_path) const override {
+    return FileView::Map((root_ / fs::path(file_path)).string());
+  }
+
   Result<deploy_meta_info_t> ReadMeta() const override {
     OUTCOME_TRY(auto deploy_json, ReadFile("deploy.json"));
     try {
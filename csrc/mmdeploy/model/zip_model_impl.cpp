@@ -1,7 +1,9 @@
 // Copyright (c) OpenMMLab. All rights reserved.
 
+#include <cstdint>
 #include <fstream>
 #include <map>
+#include <vector>
 
 #include "mmdeploy/archive/json_archive.h"
 #include "mmdeploy/core/logger.h"
@@ -14,6 +16,55 @@ using nlohmann::json;
 
 namespace mmdeploy {
 
+namespace {
+
+// little-endian fields of zip headers
+uint32_t ReadU16(const char* p) {
+  auto q = reinterpret_cast<const uint8_t*>(p);
+  return q[0] | q[1] << 8;
+}
+
+uint32_t ReadU32(const char* p) {
+  auto q = reinterpret_cast<const uint8_t*>(p);
+  return q[0] | q[1] << 8 | q[2] << 16 | (uint32_t)q[3] << 24;
+}
+
+// Returns the offsets of the local file headers in the order of the central directory, which is
+// the order of libzip's indices. An empty vector is returned for archives that are not understood
+// (e.g. zip64), whose entries are always extracted.
+std::vector<size_t> GetLocalHeaderOffsets(const char* data, size_t size) {
+  constexpr size_t kEndRecordSize = 22;
+  constexpr size_t kMaxCommentSize = 0xffff;
+  if (size < kEndRecordSize) {
+    return {};
+  }
+  // search for the end of central directory record backwards, it may be followed by a comment
+  auto end = size - kEndRecordSize;
+  auto begin = end > kMaxCommentSize ? end - kMaxCommentSize : 0;
+  for (auto pos = end + 1; pos-- > begin;) {
+    auto record = data + pos;
+    if (ReadU32(record) != 0x06054b50) {
+      continue;
+    }
+    auto count = ReadU16(record + 10);
+    size_t offset = ReadU32(record + 16);
+    std::vector<size_t> offsets;
+    offsets.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+      if (offset + 46 > size || ReadU32(data + offset) != 0x02014b50) {
+        return {};
+      }
+      auto header = data + offset;
+      offsets.push_back(ReadU32(header + 42));
+      offset += 46 + ReadU16(header + 28) + ReadU16(header + 30) + ReadU16(header + 32);
+    }
+    return offsets;
+  }
+  return {};
+}
+
+}  // namespace
+
 class ZipModelImpl : public ModelImpl {
  public:
   ~ZipModelImpl() override {
@@ -38,6 +89,12 @@ class ZipModelImpl : public ModelImpl {
       return Status(eInvalidArgument);
     }
     MMDEPLOY_INFO("Open model file {} successfully", model_path.c_str());
+#ifndef _WIN32
+    // stored entries are viewed from the mapped archive without extraction
+    if (auto archive = FileView::Map(model_path)) {
+      archive_ = std::move(archive).value();
+    }
+#endif
     return InitZip();
   }
 
@@ -52,6 +109,8 @@ class ZipModelImpl : public ModelImpl {
     if (zip_error_code_zip(&error) != ZIP_ER_OK) {
       return Status(eFail);
     }
+    // the buffer must outlive the model anyway
+    archive_ = FileView({}, static_cast<const char*>(buffer), size);
     return InitZip();
 #else
     return Status(eNotSupported);
@@ -88,6 +147,17 @@ class ZipModelImpl : public ModelImpl {
     return std::string(buf.begin(), buf.end());
   }
 
+  Result<FileView> MapFile(const std::string& file_path) const override {
+    if (auto iter = file_index_.find(file_path); iter != file_index_.end()) {
+      if (auto view = GetStoredEntry(iter->second); !view.empty()) {
+        return view;
+      }
+    }
+    // compressed entries are extracted
+    OUTCOME_TRY(auto content, ReadFile(file_path));
+    return FileView(std::move(content));
+  }
+
   Result<deploy_meta_info_t> ReadMeta() const override {
     OUTCOME_TRY(auto deploy_json, ReadFile("deploy.json"));
     try {
@@ -120,8 +190,33 @@ class ZipModelImpl : public ModelImpl {
         file_index_[file_name] = i;
       }
     }
+    if (!archive_.empty()) {
+      local_header_offsets_ = GetLocalHeaderOffsets(archive_.data(), archive_.size());
+    }
     return success();
   }
+
+  // view of the data of an uncompressed & unencrypted entry in the archive, or an empty view
+  FileView GetStoredEntry(int index) const {
+    if (index >= static_cast<int>(local_header_offsets_.size())) {
+      return {};
+    }
+    struct zip_stat stat {};
+    if (zip_stat_index(zip_, index, 0, &stat) < 0 || stat.comp_method != ZIP_CM_STORE ||
+        stat.encryption_method != ZIP_EM_NONE || stat.comp_size != stat.size || !stat.size) {
+      return {};
+    }
+    auto offset = local_header_offsets_[index];
+    if (offset + 30 > archive_.size() || ReadU32(archive_.data() + offset) != 0x04034b50) {
+      return {};
+    }
+    auto header = archive_.data() + offset;
+    offset += 30 + ReadU16(header + 26) + ReadU16(header + 28);
+    if (offset + stat.size > archive_.size()) {
+      return {};
+    }
+    return archive_.Slice(offset, stat.size);
+  }
 #if LIBZIP_VERSION_MAJOR >= 1
   struct zip_source* source_{};
 #endif
@@ -130,6 +225,9 @@ class ZipModelImpl : public ModelImpl {
   std::string root_dir_;
   // a map between file path and its index in zip file
   std::map<std::string, int> file_index_;
+  // the whole archive, mapped into memory when opened from a file
+  FileView archive_;
+  std::vector<size_t> local_header_offsets_;
 };
 
 class ZipModelImplRegister {
@@ -2,6 +2,8 @@
 
 #include "ncnn_net.h"
 
+#include <algorithm>
+
 #include "mmdeploy/core/logger.h"
 #include "mmdeploy/core/model.h"
 #include "mmdeploy/core/utils/formatter.h"
@@ -23,7 +25,7 @@ Result<void> NCNNNet::Init(const Value& args) {
   device_ = context["device"].get<Device>();
   stream_ = context["stream"].get<Stream>();
   if (args.contains("use_vulkan")) {
-    net_.opt.use_vulkan_compute = args["use_vulkan"].get<bool>();
+    net_->opt.use_vulkan_compute = args["use_vulkan"].get<bool>();
   }
   if (!device_.is_host()) {
     return Status(eNotSupported);
@@ -34,43 +36,68 @@ Result<void> NCNNNet::Init(const Value& args) {
   OUTCOME_TRY(auto config, model.GetModelConfig(name));
   auto precision = config.precision;
   if (precision == "FP16") {
-    net_.opt.use_fp16_packed = true;
-    net_.opt.use_fp16_storage = true;
-    net_.opt.use_fp16_arithmetic = true;
+    net_->opt.use_fp16_packed = true;
+    net_->opt.use_fp16_storage = true;
+    net_->opt.use_fp16_arithmetic = true;
   } else if (precision == "INT8") {
     // in android platform, ncnn will automatically start FP16 accelerate.
     // In INT8 case, we set fp16 as false explicitly.
-    net_.opt.use_int8_packed = true;
-    net_.opt.use_int8_storage = true;
-    net_.opt.use_int8_arithmetic = true;
-    net_.opt.use_fp16_packed = false;
-    net_.opt.use_fp16_storage = false;
-    net_.opt.use_fp16_arithmetic = false;
+    net_->opt.use_int8_packed = true;
+    net_->opt.use_int8_storage = true;
+    net_->opt.use_int8_arithmetic = true;
+    net_->opt.use_fp16_packed = false;
+    net_->opt.use_fp16_storage = false;
+    net_->opt.use_fp16_arithmetic = false;
   } else {
     // in android platform, ncnn will automatically start FP16 accelerate.
     // In FP32 case, we set fp16 as false explicitly.
-    net_.opt.use_fp16_packed = false;
-    net_.opt.use_fp16_storage = false;
-    net_.opt.use_fp16_arithmetic = false;
+    net_->opt.use_fp16_packed = false;
+    net_->opt.use_fp16_storage = false;
+    net_->opt.use_fp16_arithmetic = false;
   }
+  // "normalize": {"mean": [...], "std": [...]}  // normalize the uint8 images by ncnn
+  // "channels_last": true                        // the uint8 images are in (1, H, W, C)
+  if (args.contains("normalize")) {
+    auto& normalize = args["normalize"];
+    for (const auto& v : normalize["mean"]) {
+      mean_.push_back(v.get<float>());
+    }
+    norm_.assign(mean_.size(), 1.f);
+    if (normalize.contains("std")) {
+      norm_.clear();
+      for (const auto& v : normalize["std"]) {
+        norm_.push_back(1.f / v.get<float>());
+      }
+    }
+    if (norm_.size() != mean_.size()) {
+      MMDEPLOY_ERROR("inconsistent sizes of mean & std: {} vs {}", mean_.size(), norm_.size());
+      return Status(eInvalidArgument);
+    }
+    channels_last_ = args.value("channels_last", false);
+  }
+
   OUTCOME_TRY(params_, model.ReadFile(config.net));
-  OUTCOME_TRY(weights_, model.ReadFile(config.weights));
-  register_mmdeploy_custom_layers(net_);
+  OUTCOME_TRY(weights_, model.MapFile(config.weights));
+  if (reinterpret_cast<uintptr_t>(weights_.data()) % 4) {
+    // ncnn requires 32-bit aligned weights, which entries in zip archives may not be
+    weights_ = FileView(weights_.str());
+  }
+  register_mmdeploy_custom_layers(*net_);
 
-  OUTCOME_TRY(ncnn_status(net_.load_param_mem(params_.c_str())));
-  net_.load_model(reinterpret_cast<const unsigned char*>(weights_.data()));
+  OUTCOME_TRY(ncnn_status(net_->load_param_mem(params_.c_str())));
+  net_->load_model(reinterpret_cast<const unsigned char*>(weights_.data()));
 
-  input_indices_ = net_.input_indexes();
-  for (const auto& x : net_.input_names()) {
+  input_indices_ = net_->input_indexes();
+  for (const auto& x : net_->input_names()) {
     input_tensors_.emplace_back(TensorDesc{
         Device("cpu"),
-        DataType::kFLOAT,
+        mean_.empty() ? DataType::kFLOAT : DataType::kINT8,
         {},
         x,
     });
   }
-  output_indices_ = net_.output_indexes();
-  for (const auto& x : net_.output_names()) {
+  output_indices_ = net_->output_indexes();
+  for (const auto& x : net_->output_names()) {
     output_tensors_.emplace_back(TensorDesc{
         Device("cpu"),
         DataType::kFLOAT,
@@ -95,15 +122,103 @@ Result<Span<Tensor>> NCNNNet::GetInputTensors() { return input_tensors_; }
 Result<Span<Tensor>> NCNNNet::GetOutputTensors() { return output_tensors_; }
 
 // TODO: discuss a policy for batch processing
+Result<void> NCNNNet::BindInputs(Span<Tensor> inputs) {
+  if (inputs.size() != input_tensors_.size()) {
+    return Status(eInvalidArgument);
+  }
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const auto& t = input_tensors_[i];
+    if (inputs[i].shape() != t.shape() || inputs[i].data_type() != t.data_type() ||
+        !inputs[i].device().is_host()) {
+      return Status(eNotSupported);
+    }
+  }
+  bound_inputs_.assign(inputs.begin(), inputs.end());
+  return success();
+}
+
+Result<std::unique_ptr<Net>> NCNNNet::CreateExecutionContext(Stream stream) {
+  auto net = std::make_unique<NCNNNet>();
+  net->device_ = device_;
+  net->stream_ = std::move(stream);
+  net->params_ = params_;
+  net->weights_ = weights_;
+  net->input_indices_ = input_indices_;
+  net->output_indices_ = output_indices_;
+  net->mean_ = mean_;
+  net->norm_ = norm_;
+  net->channels_last_ = channels_last_;
+  for (const auto& t : input_tensors_) {
+    net->input_tensors_.emplace_back(t.desc());
+  }
+  for (const auto& t : output_tensors_) {
+    net->output_tensors_.emplace_back(t.desc());
+  }
+  net->net_ = net_;
+  return net;
+}
+
+Result<std::vector<Tensor>> NCNNNet::TakeOutputs() {
+  // output mats are created by a new extractor for each forward
+  return output_tensors_;
+}
+
+Result<ncnn::Mat> NCNNNet::FromPixels(const Tensor& tensor) const {
+  auto& shape = tensor.shape();
+  auto channels = static_cast<int>(channels_last_ ? shape[3] : shape[1]);
+  if (channels != static_cast<int>(mean_.size()) ||
+      (channels_last_ && channels != 1 && channels != 3 && channels != 4)) {
+    MMDEPLOY_ERROR("uint8 input of shape {} doesn't match the {} channels of 'normalize'", shape,
+                   mean_.size());
+    return Status(eInvalidArgument);
+  }
+  auto pixels = tensor.data<uint8_t>();
+  ncnn::Mat mat;
+  if (channels_last_) {
+    auto height = static_cast<int>(shape[1]);
+    auto width = static_cast<int>(shape[2]);
+    // the channels are taken in place, the channel order is up to the preprocessing
+    auto type = channels == 1   ? ncnn::Mat::PIXEL_GRAY
+                : channels == 3 ? ncnn::Mat::PIXEL_BGR
+                                : ncnn::Mat::PIXEL_RGBA;
+    mat = ncnn::Mat::from_pixels(pixels, type, width, height);
+  } else {
+    auto height = static_cast<int>(shape[2]);
+    auto width = static_cast<int>(shape[3]);
+    mat.create(width, height, channels);
+    for (int c = 0; c < channels; ++c) {
+      auto src = pixels + static_cast<size_t>(c) * height * width;
+      std::transform(src, src + height * width, static_cast<float*>(mat.channel(c)),
+                     [](uint8_t v) { return static_cast<float>(v); });
+    }
+  }
+  mat.substract_mean_normalize(mean_.data(), norm_.data());
+  return mat;
+}
+
 Result<void> NCNNNet::Forward() {
-  auto extractor = net_.create_extractor();
+  // the binding only lasts for a single forward
+  auto bound_inputs = std::move(bound_inputs_);
+  bound_inputs_.clear();
+  auto& input_tensors = bound_inputs.empty() ? input_tensors_ : bound_inputs;
+  auto extractor = net_->create_extractor();
   OUTCOME_TRY(stream_.Wait());
   std::vector<ncnn::Mat> inputs(input_indices_.size());
   for (size_t i = 0; i < input_indices_.size(); ++i) {
-    auto& tensor = input_tensors_[i];
+    auto& tensor = input_tensors[i];
     auto shape = tensor.shape();
     assert(shape[0] == 1);
-    inputs[i] = ncnn::Mat(shape[3], shape[2], shape[1], tensor.data());
+    if (tensor.data_type() == DataType::kINT8) {
+      if (!mean_.empty() && shape.size() == 4) {
+        OUTCOME_TRY(inputs[i], FromPixels(tensor));
+      } else {
+        MMDEPLOY_ERROR("unsupported uint8 input of shape {}, which must be normalized by ncnn",
+                       shape);
+        return Status(eNotSupported);
+      }
+    } else {
+      inputs[i] = ncnn::Mat(shape[3], shape[2], shape[1], tensor.data());
+    }
     OUTCOME_TRY(ncnn_status(extractor.input(input_indices_[i], inputs[i])));
   }
   std::vector<ncnn::Mat> outputs(output_indices_.size());
@@ -123,12 +238,13 @@ Result<void> NCNNNet::Forward() {
     }
     // tensor.Reshape({1, shape.c, shape.h, shape.w});
     // ncnn Mat may be padded, flatten to avoid that
-    auto flattened = outputs[i].reshape(shape.c * shape.h * shape.w);
+    auto flattened = std::make_shared<ncnn::Mat>(outputs[i].reshape(shape.c * shape.h * shape.w));
     // if ((shape.c * shape.h * shape.w) > 0)
     if (outputs[i].dims > 0) {
-      OUTCOME_TRY(tensor.CopyFrom(flattened.data, stream_));
+      // share the ref-counted mat instead of copying it
+      std::shared_ptr<void> data(flattened->data, [flattened](void*) {});
+      tensor = Tensor(tensor.desc(), data);
     }
-    OUTCOME_TRY(stream_.Wait());
   }
   return success();
 }
@@ -3,6 +3,9 @@
 #ifndef MMDEPLOY_SRC_NET_NCNN_NCNN_NET_H_
 #define MMDEPLOY_SRC_NET_NCNN_NCNN_NET_H_
 
+#include <memory>
+
+#include "mmdeploy/core/model.h"
 #include "mmdeploy/core/net.h"
 // It's ncnn's net.h
 #include "net.h"
@@ -18,18 +21,32 @@ class NCNNNet : public Net {
   Result<Span<Tensor>> GetOutputTensors() override;
   Result<void> Reshape(Span<TensorShape> input_shapes) override;
   Result<void> Forward() override;
-  Result<void> ForwardAsync(Event* event) override { return success(); };
+  Result<void> BindInputs(Span<Tensor> inputs) override;
+  Result<std::vector<Tensor>> TakeOutputs() override;
+  Result<std::unique_ptr<Net>> CreateExecutionContext(Stream stream) override;
 
  private:
+  // converts an uint8 image to a float mat normalized by `mean_` & `norm_`, the number of channels
+  // must match the size of `mean_`
+  Result<ncnn::Mat> FromPixels(const Tensor& tensor) const;
+
   Device device_;
   Stream stream_;
   std::string params_;
-  std::string weights_;
+  // ncnn refers to the weights in place
+  FileView weights_;
   std::vector<int> input_indices_;
   std::vector<int> output_indices_;
   std::vector<Tensor> input_tensors_;
   std::vector<Tensor> output_tensors_;
-  ncnn::Net net_;
+  std::vector<Tensor> bound_inputs_;
+  // the inputs are uint8 images normalized by ncnn when `mean_` is not empty, in (1, H, W, C) if
+  // `channels_last_` or else (1, C, H, W)
+  std::vector<float> mean_;
+  std::vector<float> norm_;
+  bool channels_last_{};
+  // shared by the execution contexts, extractors are created for each forward
+  std::shared_ptr<ncnn::Net> net_{std::make_shared<ncnn::Net>()};
 };
 
 }  // namespace mmdeploy
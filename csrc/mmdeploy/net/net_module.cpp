@@ -2,6 +2,13 @@
 
 #include "net_module.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <optional>
 #include <thread>
 
 #include "mmdeploy/archive/value_archive.h"
@@ -9,6 +16,8 @@
 #include "mmdeploy/core/model.h"
 #include "mmdeploy/core/module.h"
 #include "mmdeploy/core/net.h"
+#include "mmdeploy/core/net_cache.h"
+#include "mmdeploy/core/profiler.h"
 #include "mmdeploy/core/registry.h"
 #include "mmdeploy/core/utils/formatter.h"
 #include "mmdeploy/core/utils/scope_counter.h"
@@ -22,6 +31,98 @@ namespace mmdeploy {
 struct NetModule::Impl {
   using Input = std::map<std::string, Tensor>;
   using Output = std::map<std::string, Tensor>;
+  using Callback = std::function<void(Result<Value>)>;
+  // puts the context back to the free list
+  using Releaser = std::function<void()>;
+  using Job = std::function<void(int, Releaser)>;
+
+  // Recycled buffers for the outputs copied out of a context. A buffer handed out goes back to the
+  // ring when the last tensor referring to it (slices included) is released, so that forwards in
+  // the steady state allocate nothing for their outputs. The smallest free buffer that fits is
+  // reused, the buffers are sized by the outputs observed. A ring is owned by a single context, the
+  // writes to its buffers are ordered by the stream of the context. Only host buffers are recycled:
+  // the consumer of a device output may release it while its reads are still queued on a stream of
+  // its own, which the writes of the next forward are not ordered with.
+  class OutputRing {
+   public:
+    OutputRing(Allocator allocator, size_t capacity)
+        : allocator_(std::move(allocator)), state_(std::make_shared<State>()) {
+      state_->capacity = capacity;
+    }
+
+    // `bytes_allocated` is increased by the size of the buffer when a new one is allocated
+    Tensor Acquire(const TensorDesc& desc, size_t& bytes_allocated) {
+      auto size = static_cast<size_t>(Tensor(desc, Buffer{}).byte_size());
+      if (!state_->capacity || !desc.device.is_host()) {
+        bytes_allocated += size;
+        return Tensor(desc, allocator_);
+      }
+      Buffer buffer;
+      {
+        std::lock_guard lock{state_->mutex};
+        auto& free = state_->free;
+        auto best = free.end();
+        for (auto it = free.begin(); it != free.end(); ++it) {
+          if (it->GetSize() >= size && (best == free.end() || it->GetSize() < best->GetSize())) {
+            best = it;
+          }
+        }
+        if (best != free.end()) {
+          buffer = std::move(*best);
+          free.erase(best);
+        }
+      }
+      if (!buffer) {
+        buffer = Buffer(desc.device, size, allocator_);
+        bytes_allocated += size;
+      }
+      auto native = buffer.GetNative();
+      std::shared_ptr<void> data(native, [state = state_, buffer](void*) mutable {
+        Put(*state, std::move(buffer));
+      });
+      return Tensor(desc, Buffer(desc.device, size, std::move(data)));
+    }
+
+   private:
+    struct State {
+      std::mutex mutex;
+      std::vector<Buffer> free;
+      size_t capacity{};
+    };
+
+    // the smallest buffer is dropped when the ring is full
+    static void Put(State& state, Buffer buffer) {
+      std::lock_guard lock{state.mutex};
+      state.free.push_back(std::move(buffer));
+      if (state.free.size() > state.capacity) {
+        auto smallest = std::min_element(
+            state.free.begin(), state.free.end(),
+            [](const Buffer& a, const Buffer& b) { return a.GetSize() < b.GetSize(); });
+        state.free.erase(smallest);
+      }
+    }
+
+    Allocator allocator_;
+    // shared with the released tensors, which may outlive the module
+    std::shared_ptr<State> state_;
+  };
+
+  // a net instance with I/O tensors & stream of its own
+  struct Context {
+    std::unique_ptr<Net> net;
+    Span<Tensor> inputs;
+    Span<Tensor> outputs;
+    Stream stream;
+    std::vector<uint8_t> zeros;
+    std::optional<OutputRing> output_ring;
+    // bytes copied in & out by the current forward
+    size_t bytes_copied{};
+    // bytes allocated for the outputs of the current forward
+    size_t bytes_allocated{};
+  };
+
+  // size of the bitmask of free contexts
+  static constexpr int kMaxContexts = 64;
 
   explicit Impl(const Value& args) {
     MMDEPLOY_DEBUG("Net Module cfg: {}", args);
@@ -32,6 +133,10 @@ struct NetModule::Impl {
       OUTCOME_TRY(auto config, model.GetModelConfig(name));
       device_ = context.value("device", Device{"cpu"});
       stream_ = context.value("stream", Stream::GetDefault(device_));
+      allocator_ = context.value("allocator", Allocator{});
+      profiler_ = context.value("profiler", Profiler{});
+      name_ = name;
+      output_buffers_ = std::max(0, args.value("output_buffers", 4));
       auto creator = Registry<Net>::Get().GetCreator(config.backend);
       if (!creator) {
         MMDEPLOY_ERROR("Net backend not found: {}, available backends: {}", config.backend,
@@ -40,25 +145,52 @@ struct NetModule::Impl {
       }
       auto net_cfg = args;
       net_cfg["context"].update({{"device", device_}, {"stream", stream_}});
-      net_ = creator->Create(net_cfg);
-      if (!net_) {
-        MMDEPLOY_ERROR("Failed to create Net backend: {}, config: {}", config.backend, net_cfg);
-        return Status(eFail);
-      }
+      OUTCOME_TRY(auto net, NetCache::Get().Create(*creator, net_cfg, model_));
+      OUTCOME_TRY(AddContext(std::move(net), stream_));
+      OUTCOME_TRY(InitializeContexts(args, *creator, net_cfg));
       OUTCOME_TRY(InitializeInputTensors(args));
       OUTCOME_TRY(InitializeOutputTensors(args));
+      OUTCOME_TRY(InitializeBatchPadding(args));
       return success();
     };
     init().value();
   }
 
+  Result<void> AddContext(std::unique_ptr<Net> net, Stream stream) {
+    Context ctx;
+    ctx.net = std::move(net);
+    ctx.stream = std::move(stream);
+    ctx.output_ring.emplace(allocator_, output_buffers_);
+    OUTCOME_TRY(ctx.inputs, ctx.net->GetInputTensors());
+    OUTCOME_TRY(ctx.outputs, ctx.net->GetOutputTensors());
+    contexts_.push_back(std::move(ctx));
+    free_ |= uint64_t{1} << (contexts_.size() - 1);
+    return success();
+  }
+
+  // "num_contexts": 4    // number of forwards that can run concurrently, 1 by default
+  // "output_buffers": 4  // number of free host output buffers kept by each context, 0 to disable
+  //
+  // The contexts share the model through `NetCache` when the backend supports it, otherwise
+  // independent instances of the net are created. Each of them has a stream of its own.
+  Result<void> InitializeContexts(const Value& args, Creator<Net>& creator, Value net_cfg) {
+    auto num_contexts = std::clamp(args.value("num_contexts", 1), 1, kMaxContexts);
+    for (int i = 1; i < num_contexts; ++i) {
+      Stream stream(device_);
+      net_cfg["context"]["stream"] = stream;
+      std::shared_ptr<Net> model;
+      OUTCOME_TRY(auto net, NetCache::Get().Create(creator, net_cfg, model));
+      OUTCOME_TRY(AddContext(std::move(net), std::move(stream)));
+    }
+    return success();
+  }
+
   Result<void> InitializeInputTensors(const Value& args) {
     auto inputs = args.value<Value>("input_map", ValueType::kObject);
     for (auto it = inputs.begin(); it != inputs.end(); ++it) {
       input_mapping_.insert({(*it).get<std::string>(), it.key()});
     }
-    OUTCOME_TRY(inputs_, net_->GetInputTensors());
-    for (const auto& t : inputs_) {
+    for (const auto& t : contexts_[0].inputs) {
       input_mapping_.insert({t.name(), t.name()});
     }
     return success();
@@ -69,29 +201,84 @@ struct NetModule::Impl {
     for (auto it = outputs.begin(); it != outputs.end(); ++it) {
       output_mapping_.insert({(*it).get<std::string>(), it.key()});
     }
-    OUTCOME_TRY(outputs_, net_->GetOutputTensors());
-    for (const auto& t : outputs_) {
+    for (const auto& t : contexts_[0].outputs) {
       output_mapping_.insert({t.name(), t.name()});
     }
     return success();
   }
 
+  // "batch_padding": {
+  //   "size_divisor": 32,              // round padded height & width up to multiples of 32
+  //   "shapes": [[h0, w0], [h1, w1]],  // optional fixed buckets, the smallest fitting one is used
+  //   "crop_outputs": ["seg_logits"]   // outputs whose last 2 dims are cropped to the valid region
+  // }
+  Result<void> InitializeBatchPadding(const Value& args) {
+    if (!args.contains("batch_padding")) {
+      return success();
+    }
+    auto& cfg = args["batch_padding"];
+    BatchPadding padding;
+    padding.size_divisor = std::max(1, cfg.value("size_divisor", 1));
+    if (cfg.contains("shapes")) {
+      for (const auto& shape : cfg["shapes"]) {
+        padding.shapes.push_back({shape[0].get<int64_t>(), shape[1].get<int64_t>()});
+      }
+      std::sort(padding.shapes.begin(), padding.shapes.end(),
+                [](const auto& a, const auto& b) { return a[0] * a[1] < b[0] * b[1]; });
+    }
+    if (cfg.contains("crop_outputs")) {
+      for (const auto& name : cfg["crop_outputs"]) {
+        padding.crop_outputs.push_back(name.get<std::string>());
+      }
+    }
+    batch_padding_ = std::move(padding);
+    return success();
+  }
+
+  // select the bucket for a batch whose largest sample is `height` x `width`
+  std::array<int64_t, 2> GetPaddedSize(int64_t height, int64_t width) const {
+    for (const auto& shape : batch_padding_->shapes) {
+      if (shape[0] >= height && shape[1] >= width) {
+        return shape;
+      }
+    }
+    auto divisor = batch_padding_->size_divisor;
+    return {(height + divisor - 1) / divisor * divisor, (width + divisor - 1) / divisor * divisor};
+  }
+
   Result<TensorShape> InferInputShape(const vector<Tensor>& input) {
     auto batch_size = input.size();
     auto& exemplar = input.front();
     auto shape = exemplar.shape();
-    if (batch_size == 1) {
+    if (batch_size == 1 && !batch_padding_) {
       return shape;
     }
     if (shape[0] != 1) {
       MMDEPLOY_ERROR("unsupported shape for batch assemble: {}", shape);
       return Status(eNotSupported);
     }
-    for (int i = 1; i < input.size(); ++i) {
-      auto& sample = input[i];
-      if (sample.shape() != shape) {
-        MMDEPLOY_ERROR("shapes are not consistent across the batch");
-        return Status(eNotSupported);
+    if (batch_padding_ && shape.size() >= 3) {
+      // samples may differ in the last 2 dims, which are padded to the selected bucket
+      auto rank = shape.size();
+      for (int i = 1; i < input.size(); ++i) {
+        auto& sample = input[i].shape();
+        if (sample.size() != rank || !std::equal(shape.begin(), shape.end() - 2, sample.begin())) {
+          MMDEPLOY_ERROR("shapes are not consistent across the batch: {} vs {}", shape, sample);
+          return Status(eNotSupported);
+        }
+        shape[rank - 2] = std::max(shape[rank - 2], sample[rank - 2]);
+        shape[rank - 1] = std::max(shape[rank - 1], sample[rank - 1]);
+      }
+      auto size = GetPaddedSize(shape[rank - 2], shape[rank - 1]);
+      shape[rank - 2] = size[0];
+      shape[rank - 1] = size[1];
+    } else {
+      for (int i = 1; i < input.size(); ++i) {
+        auto& sample = input[i];
+        if (sample.shape() != shape) {
+          MMDEPLOY_ERROR("shapes are not consistent across the batch");
+          return Status(eNotSupported);
+        }
       }
     }
     shape[0] = static_cast<int64_t>(batch_size);
@@ -108,14 +295,183 @@ struct NetModule::Impl {
     return shapes;
   }
 
-  Result<std::vector<Output> > Forward(const std::vector<Input>& input) {
-    //    auto t0 = std::chrono::high_resolution_clock::now();
-    //
-    auto batch_size = static_cast<int>(input.size());
+  // copy the top-left `height` x `width` region of the last 2 dims from `src` to `dst`
+  Result<void> CopyRegion(Context& ctx, const Tensor& src, Tensor& dst, int64_t height,
+                          int64_t width) {
+    auto rank = src.shape().size();
+    auto src_h = src.shape(rank - 2);
+    auto src_w = src.shape(rank - 1);
+    auto dst_h = dst.shape(rank - 2);
+    auto dst_w = dst.shape(rank - 1);
+    auto planes = src.size() / (src_h * src_w);
+    auto elem_size = static_cast<size_t>(src.byte_size() / src.size());
+    auto& dst_buffer = dst.buffer();
+    if (src_w == width && dst_w == width) {
+      for (int64_t p = 0; p < planes; ++p) {
+        OUTCOME_TRY(ctx.stream.Copy(src.buffer(), dst_buffer, height * width * elem_size,
+                                    p * src_h * src_w * elem_size, p * dst_h * dst_w * elem_size));
+      }
+      ctx.bytes_copied += planes * height * width * elem_size;
+      return success();
+    }
+    for (int64_t p = 0; p < planes; ++p) {
+      for (int64_t y = 0; y < height; ++y) {
+        OUTCOME_TRY(ctx.stream.Copy(src.buffer(), dst_buffer, width * elem_size,
+                                    (p * src_h + y) * src_w * elem_size,
+                                    (p * dst_h + y) * dst_w * elem_size));
+      }
+    }
+    ctx.bytes_copied += planes * height * width * elem_size;
+    return success();
+  }
+
+  // zero the part of `dst` outside of the top-left `height` x `width` region of the last 2 dims
+  Result<void> ZeroPadding(Context& ctx, Tensor& dst, int64_t height, int64_t width) {
+    auto rank = dst.shape().size();
+    auto dst_h = dst.shape(rank - 2);
+    auto dst_w = dst.shape(rank - 1);
+    auto planes = dst.size() / (dst_h * dst_w);
+    auto elem_size = static_cast<size_t>(dst.byte_size() / dst.size());
+    auto max_size = std::max(dst_w - width, (dst_h - height) * dst_w) * elem_size;
+    if (ctx.zeros.size() < max_size) {
+      // pending copies may still read from the old buffer
+      OUTCOME_TRY(ctx.stream.Wait());
+      ctx.zeros.resize(max_size);
+    }
+    auto& buffer = dst.buffer();
+    for (int64_t p = 0; p < planes; ++p) {
+      if (dst_w > width) {
+        for (int64_t y = 0; y < height; ++y) {
+          OUTCOME_TRY(ctx.stream.Copy(ctx.zeros.data(), buffer, (dst_w - width) * elem_size,
+                                      ((p * dst_h + y) * dst_w + width) * elem_size));
+        }
+      }
+      if (dst_h > height) {
+        OUTCOME_TRY(ctx.stream.Copy(ctx.zeros.data(), buffer,
+                                    (dst_h - height) * dst_w * elem_size,
+                                    (p * dst_h + height) * dst_w * elem_size));
+      }
+    }
+    return success();
+  }
 
+  Result<void> CopyPadded(Context& ctx, const Tensor& src, Tensor& dst) {
+    auto rank = src.shape().size();
+    auto height = src.shape(rank - 2);
+    auto width = src.shape(rank - 1);
+    OUTCOME_TRY(CopyRegion(ctx, src, dst, height, width));
+    return ZeroPadding(ctx, dst, height, width);
+  }
+
+  // crop the last 2 dims of `src` to the region corresponding to the valid input region
+  Result<Tensor> CropOutput(Context& ctx, const Tensor& src, const TensorShape& valid_shape,
+                            const TensorShape& padded_shape) {
+    auto rank = src.shape().size();
+    if (rank < 2 || valid_shape.size() < 2) {
+      return src;
+    }
+    auto scale = [&](int64_t size, int i) {
+      auto valid = valid_shape[valid_shape.size() - i];
+      auto padded = padded_shape[padded_shape.size() - i];
+      return (size * valid + padded - 1) / padded;
+    };
+    auto desc = src.desc();
+    desc.shape[rank - 2] = scale(desc.shape[rank - 2], 2);
+    desc.shape[rank - 1] = scale(desc.shape[rank - 1], 1);
+    if (desc.shape == src.shape()) {
+      return src;
+    }
+    auto dst = ctx.output_ring->Acquire(desc, ctx.bytes_allocated);
+    OUTCOME_TRY(CopyRegion(ctx, src, dst, desc.shape[rank - 2], desc.shape[rank - 1]));
+    return dst;
+  }
+
+  // bind single samples to the backend in place of its input tensors, returns false when any of
+  // them doesn't match the reshaped input tensor or the backend doesn't support binding
+  bool BindInputs(Context& ctx, const vector<vector<Tensor> >& input_samples) {
+    vector<Tensor> samples;
+    samples.reserve(ctx.inputs.size());
+    for (int i = 0; i < ctx.inputs.size(); ++i) {
+      const auto& src = input_samples[i][0];
+      const auto& dst = ctx.inputs[i];
+      if (src.shape() != dst.shape() || src.data_type() != dst.data_type() ||
+          src.device() != dst.device() || !src.data()) {
+        return false;
+      }
+      samples.push_back(src);
+    }
+    return ctx.net->BindInputs(samples).has_value();
+  }
+
+  Result<void> CopyInputs(Context& ctx, const vector<vector<Tensor> >& input_samples,
+                          const vector<TensorShape>& input_shapes) {
+    for (int i = 0; i < ctx.inputs.size(); ++i) {
+      auto& src = input_samples[i];
+      auto& dst = ctx.inputs[i];
+      if (dst.shape() != input_shapes[i]) {
+        MMDEPLOY_ERROR("inconsistent input shape, expect {}, got {}", input_shapes[i], dst.shape());
+        return Status(eFail);
+      }
+      if (src.size() > 1 || src[0].shape() != dst.shape()) {
+        for (int j = 0; j < src.size(); ++j) {
+          auto slice = dst.Slice(j);
+          if (src[j].shape() != slice.shape()) {
+            OUTCOME_TRY(CopyPadded(ctx, src[j], slice));
+          } else {
+            OUTCOME_TRY(src[j].CopyTo(slice, ctx.stream));
+            ctx.bytes_copied += src[j].byte_size();
+          }
+        }
+      } else {
+        OUTCOME_TRY(src[0].CopyTo(dst, ctx.stream));
+        ctx.bytes_copied += src[0].byte_size();
+      }
+    }
+    return success();
+  }
+
+  // the samples of a forward and the shapes they are assembled to, they are kept until the forward
+  // is done since the samples may be bound to the backend
+  struct Batch {
+    bool is_array{};
     std::vector<std::vector<Tensor> > input_samples;
-    input_samples.reserve(inputs_.size());
-    for (const auto& t : inputs_) {
+    std::vector<TensorShape> input_shapes;
+  };
+
+  static Input FilterTensors(const Value& sample) {
+    Input tensors;
+    for (auto it = sample.begin(); it != sample.end(); ++it) {
+      if (it->is_any<Tensor>()) {
+        tensors.insert({it.key(), it->get<Tensor>()});
+      }
+    }
+    return tensors;
+  }
+
+  Result<Batch> PrepareInputs(Context& ctx, const Value& value, ScopeCounter& counter) {
+    counter("start");
+    ctx.bytes_copied = 0;
+    ctx.bytes_allocated = 0;
+
+    std::vector<Input> input;
+    if (value.is_array()) {
+      input.reserve(value.size());
+      for (const auto& sample : value) {
+        input.push_back(FilterTensors(sample));
+      }
+    } else if (value.is_object()) {
+      input.push_back(FilterTensors(value));
+    } else {
+      return Status(eNotSupported);
+    }
+
+    auto batch_size = static_cast<int>(input.size());
+
+    Batch batch;
+    batch.is_array = value.is_array();
+    auto& input_samples = batch.input_samples;
+    input_samples.reserve(ctx.inputs.size());
+    for (const auto& t : ctx.inputs) {
       auto name = input_mapping_.at(t.name());
       std::vector<Tensor> tmp;
       tmp.reserve(input.size());
@@ -132,44 +488,61 @@ struct NetModule::Impl {
     }
 
     // 1. calculate input shape
-    OUTCOME_TRY(auto input_shapes, InferInputShape(input_samples));
+    OUTCOME_TRY(batch.input_shapes, InferInputShape(input_samples));
 
     // 2. call backend's reshape
-    OUTCOME_TRY(net_->Reshape(input_shapes));
+    OUTCOME_TRY(ctx.net->Reshape(batch.input_shapes));
+    counter("reshape");
 
-    // 3. fill input tensor
-    for (int i = 0; i < inputs_.size(); ++i) {
-      auto& src = input_samples[i];
-      auto& dst = inputs_[i];
-      if (dst.shape() != input_shapes[i]) {
-        MMDEPLOY_ERROR("inconsistent input shape, expect {}, got {}", input_shapes[i], dst.shape());
-        return Status(eFail);
-      }
-      if (src.size() > 1) {
-        for (int j = 0; j < src.size(); ++j) {
-          auto slice = dst.Slice(j);
-          OUTCOME_TRY(src[j].CopyTo(slice, stream_));
-        }
-      } else {
-        OUTCOME_TRY(src[0].CopyTo(dst, stream_));
-      }
+    // 3. fill input tensor, single samples are bound directly when the backend supports it
+    if (batch_size == 1 && BindInputs(ctx, input_samples)) {
+      MMDEPLOY_DEBUG("input tensors bound without copy");
+    } else {
+      OUTCOME_TRY(CopyInputs(ctx, input_samples, batch.input_shapes));
     }
+    counter("input");
+    return batch;
+  }
 
-    // 5. forward
-    OUTCOME_TRY(net_->Forward());
+  Result<Value> CollectOutputs(Context& ctx, const Batch& batch, ScopeCounter& counter) {
+    auto& input_samples = batch.input_samples;
+    auto& input_shapes = batch.input_shapes;
+    auto batch_size = input_samples.empty() ? 1 : static_cast<int>(input_samples[0].size());
+
+    // outputs handed out by the backend are not written again and can be passed on without copy
+    std::vector<Tensor> taken_outputs;
+    if (auto taken = ctx.net->TakeOutputs(); taken && taken.value().size() == ctx.outputs.size()) {
+      taken_outputs = std::move(taken).value();
+    }
 
     vector<Output> output(batch_size);
-    for (const auto& t : outputs_) {
+    for (int k = 0; k < ctx.outputs.size(); ++k) {
+      const auto& t = ctx.outputs[k];
       auto name = output_mapping_.at(t.name());
-      auto desc = t.desc();
-      desc.device = device_;
-      Tensor tmp(desc);
-      if (tmp.size()) {
-        OUTCOME_TRY(t.CopyTo(tmp, stream_));
+      Tensor tmp;
+      if (!taken_outputs.empty() && taken_outputs[k].device() == device_) {
+        tmp = std::move(taken_outputs[k]);
       } else {
-        MMDEPLOY_WARN("copy skipped due to zero sized tensor");
+        auto desc = t.desc();
+        desc.device = device_;
+        tmp = ctx.output_ring->Acquire(desc, ctx.bytes_allocated);
+        if (tmp.size()) {
+          OUTCOME_TRY(t.CopyTo(tmp, ctx.stream));
+          ctx.bytes_copied += tmp.byte_size();
+        } else {
+          MMDEPLOY_WARN("copy skipped due to zero sized tensor");
+        }
       }
-      if (output.size() > 1) {
+      if (batch_padding_ && std::count(batch_padding_->crop_outputs.begin(),
+                                       batch_padding_->crop_outputs.end(), name)) {
+        for (int i = 0; i < output.size(); ++i) {
+          OUTCOME_TRY(auto cropped, CropOutput(ctx, tmp.Slice(i), input_samples[0][i].shape(),
+                                               input_shapes[0]));
+          output[i].emplace(name, std::move(cropped));
+        }
+        // `tmp` is released here, the copies from it must be done
+        OUTCOME_TRY(ctx.stream.Wait());
+      } else if (output.size() > 1) {
         for (int i = 0; i < output.size(); ++i) {
           output[i].emplace(name, tmp.Slice(i));
         }
@@ -178,18 +551,168 @@ struct NetModule::Impl {
       }
     }
 
+    auto value = batch.is_array ? to_value(output) : to_value(output.at(0));
+    if (batch_padding_) {
+      // per-sample shapes of the inputs before padding
+      for (int j = 0; j < batch_size; ++j) {
+        auto& valid_shape = batch.is_array ? value[j]["valid_shape"] : value["valid_shape"];
+        valid_shape = ValueType::kObject;
+        for (int i = 0; i < ctx.inputs.size(); ++i) {
+          auto name = input_mapping_.at(ctx.inputs[i].name());
+          valid_shape[name] = to_value(input_samples[i][j].shape());
+        }
+      }
+    }
+    // the outputs are consumed in the order of the stream of the module
+    if (&ctx != &contexts_.front()) {
+      OUTCOME_TRY(ctx.stream.Wait());
+    }
+    counter("output");
+    if (profiler_) {
+      profiler_.Sample(name_ + "/bytes_copied", static_cast<double>(ctx.bytes_copied));
+      profiler_.Sample(name_ + "/bytes_allocated", static_cast<double>(ctx.bytes_allocated));
+    }
+    return value;
+  }
+
+  Result<Value> Forward(Context& ctx, const Value& input) {
+    ScopeCounter counter(profiler_, name_);
+    OUTCOME_TRY(auto batch, PrepareInputs(ctx, input, counter));
+
+    OUTCOME_TRY(ctx.net->Forward());
+    counter("forward");
+
+    return CollectOutputs(ctx, batch, counter);
+  }
+
+  Result<Value> Forward(const Value& input) {
+    std::promise<std::pair<int, Releaser> > promise;
+    auto future = promise.get_future();
+    Submit([&](int slot, Releaser release) { promise.set_value({slot, std::move(release)}); });
+    auto [slot, release] = future.get();
+    auto output = Forward(contexts_[slot], input);
+    release();
     return output;
   }
 
+  void ForwardAsync(Value input, Callback done) {
+    Submit([this, input = std::move(input), done = std::move(done)](int slot,
+                                                                    Releaser release) mutable {
+      StartForward(contexts_[slot], input, std::move(done), std::move(release));
+    });
+  }
+
+  // `release` is invoked when the context is free again, before the output is passed on to `done`
+  void StartForward(Context& ctx, const Value& input, Callback done, Releaser release) {
+    auto counter = std::make_shared<ScopeCounter>(profiler_, name_);
+    auto batch = PrepareInputs(ctx, input, *counter);
+    if (!batch) {
+      release();
+      return done(std::move(batch).as_failure());
+    }
+    std::function<void(Result<void>)> on_forward =
+        [this, &ctx, counter, batch = std::make_shared<Batch>(std::move(batch).value()),
+         done = std::move(done), release = std::move(release)](Result<void> forwarded) mutable {
+          if (forwarded) {
+            (*counter)("forward");
+          }
+          auto output = forwarded ? CollectOutputs(ctx, *batch, *counter)
+                                  : Result<Value>(std::move(forwarded).as_failure());
+          release();
+          done(std::move(output));
+        };
+    if (auto r = ctx.net->ForwardAsync(on_forward); !r) {
+      on_forward(r.error() == eNotSupported ? ctx.net->Forward() : std::move(r));
+    }
+  }
+
+  // Runs `job` with a free context, right away if there is one or else when one is released, in
+  // the order of submission. The free contexts are taken from & put back to `free_` without lock,
+  // `mutex_` is only locked when all the contexts are busy.
+  void Submit(Job job) {
+    // a context just released belongs to the pending jobs, the job goes after them
+    if (int slot = -1; !waiting_.load() && (slot = TryAcquire()) >= 0) {
+      return job(slot, [this, slot] { Release(slot, true); });
+    }
+    {
+      std::lock_guard lock{mutex_};
+      pending_.push_back(std::move(job));
+      ++waiting_;
+    }
+    // pairs with the check of `waiting_` in `Release`, a context released in between is either
+    // seen here or the releasing thread sees the pending job
+    Dispatch();
+  }
+
+  int TryAcquire() {
+    auto mask = free_.load();
+    while (mask) {
+      int slot = 0;
+      while (!(mask >> slot & 1)) {
+        ++slot;
+      }
+      if (free_.compare_exchange_weak(mask, mask & (mask - 1))) {
+        return slot;
+      }
+    }
+    return -1;
+  }
+
+  // `dispatch` is false when the context is released during a job started by `Dispatch`, which
+  // goes on with the pending jobs itself, so that synchronous completions are not nested
+  void Release(int slot, bool dispatch) {
+    free_.fetch_or(uint64_t{1} << slot);
+    if (dispatch && waiting_.load()) {
+      Dispatch();
+    }
+  }
+
+  void Dispatch() {
+    while (true) {
+      Job job;
+      int slot = -1;
+      {
+        std::lock_guard lock{mutex_};
+        if (pending_.empty() || (slot = TryAcquire()) < 0) {
+          return;
+        }
+        job = std::move(pending_.front());
+        pending_.pop_front();
+        --waiting_;
+      }
+      // whoever of this thread and the job comes second dispatches the pending jobs
+      auto handoff = std::make_shared<std::atomic_bool>(false);
+      job(slot, [this, slot, handoff] { Release(slot, handoff->exchange(true)); });
+      handoff->exchange(true);
+    }
+  }
+
+  struct BatchPadding {
+    int size_divisor{1};
+    std::vector<std::array<int64_t, 2> > shapes;
+    std::vector<std::string> crop_outputs;
+  };
+
   Device device_;
   Stream stream_;
-  std::unique_ptr<Net> net_;
-  Span<Tensor> inputs_;
-  Span<Tensor> outputs_;
+  // the model shared with the other users of `NetCache`, null if the backend can't share it
+  std::shared_ptr<Net> model_;
+  Allocator allocator_;
+  int output_buffers_{};
+  std::vector<Context> contexts_;
   // outer scope to model input names
   std::map<std::string, std::string> input_mapping_;
   // outer scope to model output names
   std::map<std::string, std::string> output_mapping_;
+  std::optional<BatchPadding> batch_padding_;
+  Profiler profiler_;
+  std::string name_;
+  // bitmask of the free contexts
+  std::atomic<uint64_t> free_{0};
+  // number of jobs in `pending_`
+  std::atomic<int> waiting_{0};
+  std::mutex mutex_;
+  std::deque<Job> pending_;
 };
 
 NetModule::~NetModule() = default;
@@ -198,41 +721,43 @@ NetModule::NetModule(NetModule&&) noexcept = default;
 
 NetModule::NetModule(const Value& args) : impl_(std::make_unique<Impl>(args)) {}
 
-Result<Value> NetModule::operator()(const Value& input) {
-  auto filter = [](const Value& sample) {
-    Impl::Input tensors;
-    for (auto it = sample.begin(); it != sample.end(); ++it) {
-      if (it->is_any<Tensor>()) {
-        tensors.insert({it.key(), it->get<Tensor>()});
+Result<Value> NetModule::operator()(const Value& input) { return impl_->Forward(input); }
+
+void NetModule::Async(const Value& input, std::function<void(Result<Value>)> done) {
+  impl_->ForwardAsync(input, std::move(done));
+}
+
+namespace {
+
+// `NetModule` adapted to `Module`, which forwards asynchronously for `ProcessAsync`
+class NetModuleTask : public Module {
+ public:
+  explicit NetModuleTask(NetModule net) : net_(std::move(net)) {}
+
+  Result<Value> Process(const Value& args) override { return module_detail::Invoke(net_, args); }
+
+  // same arguments & result as the adapted `operator()`, which are packed in arrays
+  void ProcessAsync(const Value& args, std::function<void(Result<Value>)> done) override {
+    net_.Async(args[0], [done = std::move(done)](Result<Value> output) {
+      if (!output) {
+        return done(std::move(output));
       }
-    }
-    return tensors;
-  };
-  std::vector<Impl::Input> batch;
-  if (input.is_array()) {
-    batch.reserve(input.size());
-    for (const auto& sample : input) {
-      batch.push_back(filter(sample));
-    }
-  } else if (input.is_object()) {
-    batch.push_back(filter(input));
-  } else {
-    return Status(eNotSupported);
-  }
-  OUTCOME_TRY(auto batch_output, impl_->Forward(batch));
-  if (input.is_array()) {
-    return to_value(batch_output);
-  } else {
-    return to_value(batch_output.at(0));
+      done(Value(Value::Array{std::move(output).value()}));
+    });
   }
-}
+
+ private:
+  NetModule net_;
+};
+
+}  // namespace
 
 class NetModuleCreator : public Creator<Module> {
  public:
   const char* GetName() const override { return "Net"; }
   int GetVersion() const override { return 0; }
   std::unique_ptr<Module> Create(const Value& value) override {
-    return CreateTask(NetModule{value});
+    return std::make_unique<NetModuleTask>(NetModule{value});
   }
 };
 
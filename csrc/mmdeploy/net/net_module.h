@@ -3,6 +3,8 @@
 #ifndef MMDEPLOY_SRC_MODULE_NET_MODULE_H_
 #define MMDEPLOY_SRC_MODULE_NET_MODULE_H_
 
+#include <functional>
+
 #include "mmdeploy/core/status_code.h"
 #include "mmdeploy/core/tensor.h"
 #include "mmdeploy/core/value.h"
@@ -17,6 +19,11 @@ class NetModule {
   explicit NetModule(const Value& args);
   Result<Value> operator()(const Value& input);
 
+  // Forwards `input` asynchronously, `done` is invoked with the output when the forward is done,
+  // on a thread of the backend or on the calling thread when the backend has no asynchronous
+  // forward. Forwards are queued while all the execution contexts of the module are busy.
+  void Async(const Value& input, std::function<void(Result<Value>)> done);
+
  private:
   struct Impl;
   std::unique_ptr<Impl> impl_;
@@ -3,11 +3,8 @@
 
 #include <stdio.h>
 
-#include <fstream>
-
 #include "mmdeploy/core/logger.h"
 #include "mmdeploy/core/model.h"
-#include "mmdeploy/core/utils/filesystem.h"
 #include "mmdeploy/core/utils/formatter.h"
 
 namespace mmdeploy {
@@ -27,6 +24,8 @@ static Result<DataType> ConvertElementType(InferenceEngine::Precision prec) {
       return DataType::kFLOAT;
     case InferenceEngine::Precision::ePrecision::FP16:
       return DataType::kHALF;
+    // 8-bit images are `kINT8`, e.g. the uint8 inputs normalized by the inference engine
+    case InferenceEngine::Precision::ePrecision::U8:
     case InferenceEngine::Precision::ePrecision::I8:
       return DataType::kINT8;
     case InferenceEngine::Precision::ePrecision::I32:
@@ -64,6 +63,37 @@ static Result<std::string> ConvertDeviceName(const Device& device) {
   return Status(eNotSupported);
 }
 
+// the weights blob refers to the memory of `weights_`, which is read-only
+InferenceEngine::CNNNetwork OpenVINONet::ReadNetwork() {
+  auto weights = InferenceEngine::make_shared_blob<uint8_t>(
+      {InferenceEngine::Precision::U8, {weights_.size()}, InferenceEngine::Layout::C},
+      reinterpret_cast<uint8_t*>(const_cast<char*>(weights_.data())));
+  auto network = core_.ReadNetwork(xml_, weights);
+  if (!normalize_.mean.empty()) {
+    ConfigureNormalization(network);
+  }
+  return network;
+}
+
+// the 4-D inputs take uint8 images, which are converted & normalized by the inference engine
+void OpenVINONet::ConfigureNormalization(InferenceEngine::CNNNetwork& network) const {
+  for (auto& item : network.getInputsInfo()) {
+    auto& input_info = item.second;
+    auto& dims = input_info->getTensorDesc().getDims();
+    if (dims.size() != 4 || dims[1] != normalize_.mean.size()) {
+      continue;
+    }
+    input_info->setPrecision(InferenceEngine::Precision::U8);
+    auto& preprocess = input_info->getPreProcess();
+    preprocess.init(normalize_.mean.size());
+    for (size_t c = 0; c < normalize_.mean.size(); ++c) {
+      preprocess[c]->meanValue = normalize_.mean[c];
+      preprocess[c]->stdScale = normalize_.std[c];
+    }
+    preprocess.setVariant(InferenceEngine::MEAN_VALUE);
+  }
+}
+
 Result<void> OpenVINONet::Init(const Value& args) {
   auto& context = args["context"];
   device_ = context["device"].get<Device>();
@@ -77,30 +107,31 @@ Result<void> OpenVINONet::Init(const Value& args) {
   auto model = context["model"].get<Model>();
   OUTCOME_TRY(auto config, model.GetModelConfig(name));
 
-  // TODO: read network with stream
-  // save xml and bin to temp file
-  auto tmp_dir = fs::temp_directory_path();
-  std::string tmp_xml = (tmp_dir / fs::path("tmp.xml")).string();
-  std::string tmp_bin = (tmp_dir / fs::path("tmp.bin")).string();
-  OUTCOME_TRY(auto raw_xml, model.ReadFile(config.net));
-  OUTCOME_TRY(auto raw_bin, model.ReadFile(config.weights));
-
-  try {
-    std::ofstream xml_out(tmp_xml, std::ios::binary);
-    xml_out << raw_xml;
-    xml_out.close();
-    std::ofstream bin_out(tmp_bin, std::ios::binary);
-    bin_out << raw_bin;
-    bin_out.close();
-  } catch (const std::exception& e) {
-    MMDEPLOY_ERROR("unhandled exception when creating tmp xml/bin: {}", e.what());
-    return Status(eFail);
+  // "normalize": {"mean": [...], "std": [...]}  // normalize the uint8 images by the engine
+  if (args.contains("normalize")) {
+    for (const auto& v : args["normalize"]["mean"]) {
+      normalize_.mean.push_back(v.get<float>());
+    }
+    normalize_.std.assign(normalize_.mean.size(), 1.f);
+    if (args["normalize"].contains("std")) {
+      normalize_.std.clear();
+      for (const auto& v : args["normalize"]["std"]) {
+        normalize_.std.push_back(v.get<float>());
+      }
+    }
+    if (normalize_.std.size() != normalize_.mean.size()) {
+      MMDEPLOY_ERROR("inconsistent sizes of mean & std: {} vs {}", normalize_.mean.size(),
+                     normalize_.std.size());
+      return Status(eInvalidArgument);
+    }
   }
 
+  OUTCOME_TRY(xml_, model.ReadFile(config.net));
+  OUTCOME_TRY(weights_, model.MapFile(config.weights));
+
   try {
-    // create cnnnetwork
     core_ = InferenceEngine::Core();
-    network_ = core_.ReadNetwork(tmp_xml, tmp_bin);
+    network_ = ReadNetwork();
 
     // set input tensor
     InferenceEngine::InputsDataMap input_info = network_.getInputsInfo();
@@ -129,8 +160,8 @@ Result<void> OpenVINONet::Init(const Value& args) {
         std::map<std::string, std::string>{{InferenceEngine::PluginConfigParams::KEY_PERF_COUNT,
                                             InferenceEngine::PluginConfigParams::YES}};
     OUTCOME_TRY(auto device_str, ConvertDeviceName(device_));
-    auto executable_network = core_.LoadNetwork(network_, device_str, net_config_);
-    request_ = executable_network.CreateInferRequest();
+    executable_network_ = core_.LoadNetwork(network_, device_str, net_config_);
+    request_ = executable_network_.CreateInferRequest();
 
   } catch (const std::exception& e) {
     MMDEPLOY_ERROR("unhandled exception when creating OpenVINO: {}", e.what());
@@ -139,7 +170,32 @@ Result<void> OpenVINONet::Init(const Value& args) {
   return success();
 }
 
-Result<void> OpenVINONet::ForwardAsync(Event* event) { return Status(eNotSupported); }
+Result<std::unique_ptr<Net>> OpenVINONet::CreateExecutionContext(Stream stream) {
+  try {
+    auto net = std::make_unique<OpenVINONet>();
+    net->weights_ = weights_;
+    net->xml_ = xml_;
+    net->core_ = core_;
+    net->normalize_ = normalize_;
+    // a network of its own to be reshaped, which refers to the same weights
+    net->network_ = net->ReadNetwork();
+    net->executable_network_ = executable_network_;
+    net->request_ = executable_network_.CreateInferRequest();
+    net->net_config_ = net_config_;
+    for (const auto& t : input_tensors_) {
+      net->input_tensors_.emplace_back(t.desc());
+    }
+    for (const auto& t : output_tensors_) {
+      net->output_tensors_.emplace_back(t.desc());
+    }
+    net->device_ = device_;
+    net->stream_ = std::move(stream);
+    return net;
+  } catch (const std::exception& e) {
+    MMDEPLOY_ERROR("failed to create OpenVINO execution context: {}", e.what());
+    return Status(eFail);
+  }
+}
 
 Result<void> OpenVINONet::Deinit() { return success(); }
 
@@ -154,13 +210,17 @@ Result<void> OpenVINONet::Reshape(Span<TensorShape> input_shapes) {
   return success();
 }
 
-static Result<void> SetBlob(InferenceEngine::InferRequest& request, Tensor& tensor) {
+// `prec` is the precision of the input, which tells the signedness of `kINT8` tensors
+static Result<void> SetBlob(InferenceEngine::InferRequest& request, Tensor& tensor,
+                            InferenceEngine::Precision prec) {
   const auto& input_name = tensor.desc().name;
 
   const auto& desc = tensor.desc();
   const auto& shape = desc.shape;
   InferenceEngine::SizeVector size_vector{shape.begin(), shape.end()};
-  OUTCOME_TRY(auto prec, ConvertPrecision(desc.data_type));
+  if (auto type = ConvertElementType(prec); !type || type.value() != desc.data_type) {
+    OUTCOME_TRY(prec, ConvertPrecision(desc.data_type));
+  }
   InferenceEngine::TensorDesc ie_desc(prec, size_vector, InferenceEngine::Layout::NCHW);
 
   // TODO: find a better way instead of switch case
@@ -170,8 +230,13 @@ static Result<void> SetBlob(InferenceEngine::InferRequest& request, Tensor& tens
                       InferenceEngine::make_shared_blob<float>(ie_desc, tensor.data<float>()));
       break;
     case DataType::kINT8:
-      request.SetBlob(input_name,
-                      InferenceEngine::make_shared_blob<int8_t>(ie_desc, tensor.data<int8_t>()));
+      if (prec == InferenceEngine::Precision::U8) {
+        request.SetBlob(input_name, InferenceEngine::make_shared_blob<uint8_t>(
+                                        ie_desc, tensor.data<uint8_t>()));
+      } else {
+        request.SetBlob(input_name,
+                        InferenceEngine::make_shared_blob<int8_t>(ie_desc, tensor.data<int8_t>()));
+      }
       break;
     case DataType::kINT32:
       request.SetBlob(input_name,
@@ -211,7 +276,32 @@ static Result<void> GetBlob(InferenceEngine::InferRequest& request, Tensor& tens
   return success();
 }
 
-Result<void> OpenVINONet::Forward() {
+// output blobs are owned by the infer request and reused across inferences, so only the inputs
+// are bound without copy
+Result<void> OpenVINONet::BindInputs(Span<Tensor> inputs) {
+  if (inputs.size() != input_tensors_.size()) {
+    return Status(eInvalidArgument);
+  }
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const auto& t = input_tensors_[i];
+    if (inputs[i].shape() != t.shape() || inputs[i].data_type() != t.data_type() ||
+        !inputs[i].device().is_host()) {
+      return Status(eNotSupported);
+    }
+  }
+  bound_inputs_.clear();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    auto desc = inputs[i].desc();
+    desc.name = input_tensors_[i].name();
+    bound_inputs_.emplace_back(desc, inputs[i].buffer());
+  }
+  return success();
+}
+
+Result<void> OpenVINONet::PrepareRequest() {
+  // the binding only lasts for a single forward
+  auto bound_inputs = std::move(bound_inputs_);
+  bound_inputs_.clear();
   OUTCOME_TRY(stream_.Wait());
 
   // reshape network if shape does not match
@@ -231,24 +321,65 @@ Result<void> OpenVINONet::Forward() {
   if (need_reshape) {
     network_.reshape(input_shapes);
     OUTCOME_TRY(auto device_str, ConvertDeviceName(device_));
-    auto executable_network = core_.LoadNetwork(network_, device_str, net_config_);
-    request_ = executable_network.CreateInferRequest();
+    executable_network_ = core_.LoadNetwork(network_, device_str, net_config_);
+    request_ = executable_network_.CreateInferRequest();
   }
 
   // fill input into request
-  for (auto& tensor : input_tensors_) {
-    OUTCOME_TRY(SetBlob(request_, tensor));
+  auto input_info = network_.getInputsInfo();
+  for (auto& tensor : bound_inputs.empty() ? input_tensors_ : bound_inputs) {
+    OUTCOME_TRY(SetBlob(request_, tensor, input_info[tensor.desc().name]->getPrecision()));
   }
+  return success();
+}
 
-  request_.StartAsync();
-  request_.Wait(InferenceEngine::InferRequest::WaitMode::RESULT_READY);
-
-  // read output from request
+Result<void> OpenVINONet::ReadOutputs() {
   for (auto& tensor : output_tensors_) {
     OUTCOME_TRY(GetBlob(request_, tensor, stream_));
   }
   OUTCOME_TRY(stream_.Wait());
+  return success();
+}
 
+Result<void> OpenVINONet::Forward() {
+  try {
+    OUTCOME_TRY(PrepareRequest());
+    request_.Infer();
+    return ReadOutputs();
+  } catch (const std::exception& e) {
+    MMDEPLOY_ERROR("OpenVINO forward failed: {}", e.what());
+    return Status(eFail);
+  }
+}
+
+// the outputs are read and `done` is invoked by the completion callback of the infer request, on
+// a thread of the inference engine
+Result<void> OpenVINONet::ForwardAsync(std::function<void(Result<void>)> done) {
+  try {
+    OUTCOME_TRY(PrepareRequest());
+    using InferRequest = InferenceEngine::InferRequest;
+    using Callback = std::function<void(InferRequest, InferenceEngine::StatusCode)>;
+    request_.SetCompletionCallback<Callback>(
+        [this, done = std::move(done)](InferRequest, InferenceEngine::StatusCode code) {
+          if (code != InferenceEngine::StatusCode::OK) {
+            MMDEPLOY_ERROR("OpenVINO async forward failed, status code: {}",
+                           static_cast<int>(code));
+            return done(Status(eFail));
+          }
+          Result<void> result = success();
+          try {
+            result = ReadOutputs();
+          } catch (const std::exception& e) {
+            MMDEPLOY_ERROR("failed to read OpenVINO outputs: {}", e.what());
+            result = Status(eFail);
+          }
+          done(std::move(result));
+        });
+    request_.StartAsync();
+  } catch (const std::exception& e) {
+    MMDEPLOY_ERROR("failed to start OpenVINO async forward: {}", e.what());
+    return Status(eFail);
+  }
   return success();
 }
 
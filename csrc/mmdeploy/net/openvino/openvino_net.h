@@ -4,6 +4,7 @@
 #define MMDEPLOY_SRC_NET_OPENVINO_OPENVINO_NET_H_
 
 #include "inference_engine.hpp"
+#include "mmdeploy/core/model.h"
 #include "mmdeploy/core/net.h"
 
 namespace mmdeploy {
@@ -17,15 +18,36 @@ class OpenVINONet : public Net {
   Result<Span<Tensor>> GetOutputTensors() override;
   Result<void> Reshape(Span<TensorShape> input_shapes) override;
   Result<void> Forward() override;
-  Result<void> ForwardAsync(Event* event) override;
+  Result<void> ForwardAsync(std::function<void(Result<void>)> done) override;
+  Result<void> BindInputs(Span<Tensor> inputs) override;
+  Result<std::unique_ptr<Net>> CreateExecutionContext(Stream stream) override;
 
  private:
+  InferenceEngine::CNNNetwork ReadNetwork();
+  void ConfigureNormalization(InferenceEngine::CNNNetwork& network) const;
+  // reshape the network if needed and set the inputs to the infer request
+  Result<void> PrepareRequest();
+  Result<void> ReadOutputs();
+
+  // the network refers to the weights in place
+  FileView weights_;
+  std::string xml_;
+  // applied by the inference engine to the uint8 images, empty if the inputs are normalized
+  struct Normalization {
+    std::vector<float> mean;
+    std::vector<float> std;
+  };
+  Normalization normalize_;
   InferenceEngine::Core core_;
+  // the network is reshaped by each execution context independently, while the executable network
+  // is shared until the input shapes of the context are changed
   InferenceEngine::CNNNetwork network_;
+  InferenceEngine::ExecutableNetwork executable_network_;
   InferenceEngine::InferRequest request_;
   std::map<std::string, std::string> net_config_;
   std::vector<Tensor> input_tensors_;
   std::vector<Tensor> output_tensors_;
+  std::vector<Tensor> bound_inputs_;
   std::string device_str_;
   Device device_;
   Stream stream_;
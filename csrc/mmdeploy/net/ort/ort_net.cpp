@@ -7,6 +7,7 @@
 #include "mmdeploy/core/logger.h"
 #include "mmdeploy/core/model.h"
 #include "mmdeploy/core/utils/formatter.h"
+#include "mmdeploy/execution/execute.h"
 #include "onnxruntime_register.h"
 
 namespace mmdeploy {
@@ -22,6 +23,8 @@ static Result<DataType> ConvertElementType(ONNXTensorElementDataType type) {
       return DataType::kFLOAT;
     case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
       return DataType::kHALF;
+    // 8-bit images are `kINT8`, e.g. the uint8 inputs of models with the normalization folded in
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
     case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
     case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
       return DataType::kINT8;
@@ -35,6 +38,81 @@ static Result<DataType> ConvertElementType(ONNXTensorElementDataType type) {
   }
 }
 
+static Result<ONNXTensorElementDataType> ConvertDataType(DataType type) {
+  switch (type) {
+    case DataType::kFLOAT:
+      return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT;
+    case DataType::kHALF:
+      return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16;
+    case DataType::kINT8:
+      return ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8;
+    case DataType::kINT32:
+      return ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32;
+    case DataType::kINT64:
+      return ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64;
+    default:
+      MMDEPLOY_ERROR("unsupported DataType: {}", static_cast<int>(type));
+      return Status(eNotSupported);
+  }
+}
+
+// "session_options": {
+//   "intra_op_num_threads": 4,
+//   "inter_op_num_threads": 1,
+//   "execution_mode": "sequential" | "parallel",
+//   "graph_optimization_level": "disable_all" | "basic" | "extended" | "all",
+//   "enable_mem_pattern": true,
+//   "enable_cpu_mem_arena": true
+// }
+static Result<void> SetSessionOptions(const Value& cfg, Ort::SessionOptions& options) {
+  if (cfg.contains("intra_op_num_threads")) {
+    options.SetIntraOpNumThreads(cfg["intra_op_num_threads"].get<int>());
+  }
+  if (cfg.contains("inter_op_num_threads")) {
+    options.SetInterOpNumThreads(cfg["inter_op_num_threads"].get<int>());
+  }
+  if (cfg.contains("execution_mode")) {
+    auto mode = cfg["execution_mode"].get<std::string>();
+    if (mode == "sequential") {
+      options.SetExecutionMode(ORT_SEQUENTIAL);
+    } else if (mode == "parallel") {
+      options.SetExecutionMode(ORT_PARALLEL);
+    } else {
+      MMDEPLOY_ERROR("unknown execution mode: {}", mode);
+      return Status(eInvalidArgument);
+    }
+  }
+  if (cfg.contains("graph_optimization_level")) {
+    static const std::map<std::string, GraphOptimizationLevel> levels{
+        {"disable_all", ORT_DISABLE_ALL},
+        {"basic", ORT_ENABLE_BASIC},
+        {"extended", ORT_ENABLE_EXTENDED},
+        {"all", ORT_ENABLE_ALL}};
+    auto level = cfg["graph_optimization_level"].get<std::string>();
+    if (auto it = levels.find(level); it != levels.end()) {
+      options.SetGraphOptimizationLevel(it->second);
+    } else {
+      MMDEPLOY_ERROR("unknown graph optimization level: {}", level);
+      return Status(eInvalidArgument);
+    }
+  }
+  if (cfg.contains("enable_mem_pattern")) {
+    if (cfg["enable_mem_pattern"].get<bool>()) {
+      options.EnableMemPattern();
+    } else {
+      options.DisableMemPattern();
+    }
+  }
+  if (cfg.contains("enable_cpu_mem_arena")) {
+    if (cfg["enable_cpu_mem_arena"].get<bool>()) {
+      options.EnableCpuMemArena();
+    } else {
+      options.DisableCpuMemArena();
+    }
+  }
+  return success();
+}
+
 // TODO: handle datatype
 Result<void> OrtNet::Init(const Value& args) {
   auto& context = args["context"];
@@ -46,10 +124,11 @@ Result<void> OrtNet::Init(const Value& args) {
 
   OUTCOME_TRY(auto config, model.GetModelConfig(name));
 
-  OUTCOME_TRY(auto onnx, model.ReadFile(config.net));
+  OUTCOME_TRY(auto onnx, model.MapFile(config.net));
 
   Ort::SessionOptions options;
   options.SetLogSeverityLevel(3);
+  OUTCOME_TRY(SetSessionOptions(args.value<Value>("session_options", ValueType::kObject), options));
 
   RegisterCustomOps(options, OrtGetApiBase());
 
@@ -59,12 +138,13 @@ Result<void> OrtNet::Init(const Value& args) {
     // TODO set compute stream
     options.AppendExecutionProvider_CUDA(cuda_options);
   }
-  session_ = {env_, onnx.data(), onnx.size(), options};
+  env_ = std::make_shared<Ort::Env>();
+  session_ = std::make_shared<Ort::Session>(*env_, onnx.data(), onnx.size(), options);
 
   auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
-  Ort::Allocator allocator(session_, memory_info);
+  Ort::Allocator allocator(*session_, memory_info);
 
-  auto n_inputs = session_.GetInputCount();
+  auto n_inputs = session_->GetInputCount();
 
   // force negative shape to be empty
   auto filter_shape = [](TensorShape& shape) {
@@ -74,36 +154,43 @@ Result<void> OrtNet::Init(const Value& args) {
   };
 
   for (int i = 0; i < n_inputs; ++i) {
-    auto input_name = session_.GetInputName(i, allocator);
-    auto type_info = session_.GetInputTypeInfo(i);
+    auto input_name = session_->GetInputName(i, allocator);
+    auto type_info = session_->GetInputTypeInfo(i);
     auto shape = to_shape(type_info);
     MMDEPLOY_DEBUG("input {}, shape = {}", i, shape);
     filter_shape(shape);
-    OUTCOME_TRY(auto data_type,
-                ConvertElementType(type_info.GetTensorTypeAndShapeInfo().GetElementType()));
+    auto element_type = type_info.GetTensorTypeAndShapeInfo().GetElementType();
+    OUTCOME_TRY(auto data_type, ConvertElementType(element_type));
     input_tensors_.emplace_back(TensorDesc{device_, data_type, shape, input_name});
+    input_types_.push_back(element_type);
     allocator.Free(input_name);
   }
 
-  auto n_outputs = session_.GetOutputCount();
+  auto n_outputs = session_->GetOutputCount();
 
   for (int i = 0; i < n_outputs; ++i) {
-    auto output_name = session_.GetOutputName(i, allocator);
-    auto type_info = session_.GetOutputTypeInfo(i);
+    auto output_name = session_->GetOutputName(i, allocator);
+    auto type_info = session_->GetOutputTypeInfo(i);
     auto shape = to_shape(type_info);
     MMDEPLOY_DEBUG("output {}, shape = {}", i, shape);
     filter_shape(shape);
-    OUTCOME_TRY(auto data_type,
-                ConvertElementType(type_info.GetTensorTypeAndShapeInfo().GetElementType()));
+    auto element_type = type_info.GetTensorTypeAndShapeInfo().GetElementType();
+    OUTCOME_TRY(auto data_type, ConvertElementType(element_type));
     output_tensors_.emplace_back(TensorDesc{device_, data_type, shape, output_name});
+    output_types_.push_back(element_type);
     allocator.Free(output_name);
   }
 
+  if (std::none_of(output_tensors_.begin(), output_tensors_.end(),
+                   [](const Tensor& t) { return t.shape().empty(); })) {
+    for (const auto& t : output_tensors_) {
+      static_output_shapes_.push_back(t.shape());
+    }
+  }
+
   return success();
 }
 
-Result<void> OrtNet::ForwardAsync(Event* event) { return Status(eNotSupported); }
-
 Result<void> OrtNet::Deinit() { return success(); }
 
 Result<Span<Tensor>> OrtNet::GetInputTensors() { return input_tensors_; }
@@ -124,53 +211,196 @@ static Ort::MemoryInfo MemoryInfo(const TensorDesc& desc) {
   return memory_info;
 }
 
-static Ort::Value AsOrtValue(Tensor& tensor) {
-  auto memory_info = MemoryInfo(tensor.desc());
-  std::vector<int64_t> shape(begin(tensor.shape()), end(tensor.shape()));
-  return Ort::Value::CreateTensor(memory_info, tensor.data<float>(), tensor.size(), shape.data(),
-                                  shape.size());
+// `type` is the element type of the model, which tells the signedness of `kINT8` tensors
+static Ort::Value AsOrtValue(const TensorDesc& desc, void* data, size_t size,
+                             ONNXTensorElementDataType type) {
+  auto memory_info = MemoryInfo(desc);
+  std::vector<int64_t> shape(begin(desc.shape), end(desc.shape));
+  auto model_type = ConvertElementType(type);
+  if (!model_type || model_type.value() != desc.data_type) {
+    type = ConvertDataType(desc.data_type).value();
+  }
+  return Ort::Value::CreateTensor(memory_info, data, size, shape.data(), shape.size(), type);
+}
+
+static Ort::Value AsOrtValue(Tensor& tensor, ONNXTensorElementDataType type) {
+  return AsOrtValue(tensor.desc(), tensor.data(), tensor.byte_size(), type);
 }
 
-static Result<Tensor> AsTensor(Ort::Value& value, const Device& device) {
+// the returned tensor shares the buffer allocated by ORT and keeps it alive
+static Result<Tensor> AsTensor(Ort::Value value, const TensorDesc& ref) {
   auto info = value.GetTensorTypeAndShapeInfo();
   TensorDesc desc;
   desc.shape = info.GetShape();
-  desc.device = device;
+  desc.device = ref.device;
+  desc.name = ref.name;
   OUTCOME_TRY(desc.data_type, ConvertElementType(info.GetElementType()));
-  std::shared_ptr<void> data(const_cast<void*>(value.GetTensorData<void>()), [](void*) {});
+  auto holder = std::make_shared<Ort::Value>(std::move(value));
+  std::shared_ptr<void> data(const_cast<void*>(holder->GetTensorData<void>()),
+                             [holder](void*) {});
   return Tensor(desc, data);
 }
 
+Result<void> OrtNet::BindInputs(Span<Tensor> inputs) {
+  if (inputs.size() != input_tensors_.size()) {
+    return Status(eInvalidArgument);
+  }
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const auto& t = input_tensors_[i];
+    if (inputs[i].shape() != t.shape() || inputs[i].data_type() != t.data_type() ||
+        inputs[i].device() != t.device()) {
+      return Status(eNotSupported);
+    }
+  }
+  bound_inputs_.clear();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    auto desc = inputs[i].desc();
+    desc.name = input_tensors_[i].name();
+    bound_inputs_.emplace_back(desc, inputs[i].buffer());
+  }
+  return success();
+}
+
+Result<std::unique_ptr<Net>> OrtNet::CreateExecutionContext(Stream stream) {
+  auto net = std::make_unique<OrtNet>();
+  net->env_ = env_;
+  net->session_ = session_;
+  for (const auto& t : input_tensors_) {
+    net->input_tensors_.emplace_back(t.desc());
+  }
+  for (const auto& t : output_tensors_) {
+    net->output_tensors_.emplace_back(t.desc());
+  }
+  net->static_output_shapes_ = static_output_shapes_;
+  net->input_types_ = input_types_;
+  net->output_types_ = output_types_;
+  net->device_ = device_;
+  net->stream_ = std::move(stream);
+  return net;
+}
+
+Result<std::vector<Tensor>> OrtNet::TakeOutputs() {
+  // output buffers are allocated by ORT for each run and never written again
+  return output_tensors_;
+}
+
+OrtNet::Binding& OrtNet::GetBinding(const std::vector<Tensor>& input_tensors) {
+  std::vector<TensorShape> input_shapes;
+  input_shapes.reserve(input_tensors.size());
+  for (const auto& t : input_tensors) {
+    input_shapes.push_back(t.shape());
+  }
+  auto it = bindings_.find(input_shapes);
+  if (it == bindings_.end()) {
+    if (bindings_.size() >= kMaxBindings) {
+      bindings_.clear();
+    }
+    it = bindings_.emplace(std::move(input_shapes), Binding{*session_}).first;
+    auto& binding = it->second;
+    binding.input_data.resize(input_tensors.size());
+    binding.output_data.resize(output_tensors_.size());
+    // outputs with static shapes are known without running
+    if (!static_output_shapes_.empty()) {
+      binding.output_shapes = static_output_shapes_;
+      binding.output_shapes_known = true;
+    }
+  }
+  return it->second;
+}
+
+Result<bool> OrtNet::BindOutputs(Binding& binding) {
+  if (binding.dynamic_outputs || !binding.output_shapes_known) {
+    for (auto& t : output_tensors_) {
+      binding.io_binding.BindOutput(t.name(), MemoryInfo(t.desc()));
+    }
+    return false;
+  }
+  for (size_t i = 0; i < output_tensors_.size(); ++i) {
+    auto& data = binding.output_data[i];
+    // reuse the buffer if no output of previous runs refers to it any more, otherwise leave it to
+    // them and bind a new one
+    if (data && data.use_count() == 1) {
+      continue;
+    }
+    auto desc = output_tensors_[i].desc();
+    desc.shape = binding.output_shapes[i];
+    Tensor tensor(desc);
+    data = std::shared_ptr<void>(tensor.data(), [tensor](void*) {});
+    binding.io_binding.BindOutput(desc.name.c_str(),
+                                  AsOrtValue(desc, data.get(), tensor.byte_size(),
+                                             output_types_[i]));
+  }
+  return true;
+}
+
+// output shapes are considered known when two consecutive runs produce the same shapes
+void OrtNet::LearnOutputShapes(Binding& binding) {
+  std::vector<TensorShape> output_shapes;
+  output_shapes.reserve(output_tensors_.size());
+  for (const auto& t : output_tensors_) {
+    output_shapes.push_back(t.shape());
+  }
+  if (output_shapes == binding.output_shapes) {
+    binding.output_shapes_known = true;
+  } else {
+    binding.output_shapes = std::move(output_shapes);
+  }
+}
+
 Result<void> OrtNet::Forward() {
+  // the binding only lasts for a single forward
+  auto bound_inputs = std::move(bound_inputs_);
+  bound_inputs_.clear();
+  auto& input_tensors = bound_inputs.empty() ? input_tensors_ : bound_inputs;
   try {
     OUTCOME_TRY(stream_.Wait());
-    Ort::IoBinding binding(session_);
-    std::vector<Ort::Value> inputs;
-    std::vector<Ort::Value> outputs;
-    Ort::RunOptions options;
-
-    inputs.reserve(input_tensors_.size());
-    for (auto& t : input_tensors_) {
-      inputs.push_back(AsOrtValue(t));
-      binding.BindInput(t.name(), inputs.back());
+    auto& binding = GetBinding(input_tensors);
+
+    // re-bind only the inputs whose buffers changed since the last run
+    for (size_t i = 0; i < input_tensors.size(); ++i) {
+      auto& t = input_tensors[i];
+      if (binding.input_data[i] != t.data()) {
+        binding.io_binding.BindInput(t.name(), AsOrtValue(t, input_types_[i]));
+        binding.input_data[i] = t.data();
+      }
     }
 
-    // TODO: We are in the same situation as PPL.nn, the backend can't infer shapes
-    //  without executing forward
+    // release the outputs of the last run so that their buffers can be reused
     for (auto& t : output_tensors_) {
-      binding.BindOutput(t.name(), MemoryInfo(t.desc()));
+      t = Tensor(t.desc(), Buffer{});
     }
 
-    session_.Run({}, binding);
-
-    outputs = binding.GetOutputValues();
-    for (size_t i = 0; i < output_tensors_.size(); ++i) {
-      OUTCOME_TRY(auto tmp, AsTensor(outputs[i], output_tensors_[i].device()));
-      output_tensors_[i].Reshape(tmp.shape());
-      OUTCOME_TRY(tmp.CopyTo(output_tensors_[i], stream_));
+    OUTCOME_TRY(auto preallocated, BindOutputs(binding));
+    try {
+      session_->Run({}, binding.io_binding);
+    } catch (const Ort::Exception& e) {
+      if (!preallocated) {
+        throw;
+      }
+      // shapes of the outputs depend on the input data, let ORT allocate them from now on
+      MMDEPLOY_WARN("failed to run with pre-allocated outputs, fall back to dynamic outputs: {}",
+                    e.what());
+      binding.dynamic_outputs = true;
+      OUTCOME_TRY(preallocated, BindOutputs(binding));
+      session_->Run({}, binding.io_binding);
     }
 
-    OUTCOME_TRY(stream_.Wait());
+    if (preallocated) {
+      for (size_t i = 0; i < output_tensors_.size(); ++i) {
+        auto desc = output_tensors_[i].desc();
+        desc.shape = binding.output_shapes[i];
+        output_tensors_[i] = Tensor(desc, binding.output_data[i]);
+      }
+    } else {
+      auto outputs = binding.io_binding.GetOutputValues();
+      for (size_t i = 0; i < output_tensors_.size(); ++i) {
+        OUTCOME_TRY(output_tensors_[i],
+                    AsTensor(std::move(outputs[i]), output_tensors_[i].desc()));
+      }
+      if (!binding.dynamic_outputs) {
+        LearnOutputShapes(binding);
+      }
+    }
   } catch (const std::exception& e) {
     MMDEPLOY_ERROR(e.what());
     return Status(eFail);
@@ -178,6 +408,16 @@ Result<void> OrtNet::Forward() {
   return success();
 }
 
+// `Ort::Session::Run` is blocking in the supported versions of ORT, the forward is run on an
+// inference thread of the net instead, so that the caller is not parked while it runs
+Result<void> OrtNet::ForwardAsync(std::function<void(Result<void>)> done) {
+  if (!executor_) {
+    executor_ = std::make_unique<SingleThreadContext>();
+  }
+  Execute(executor_->GetScheduler(), [this, done = std::move(done)] { done(Forward()); });
+  return success();
+}
+
 class OrtNetCreator : public Creator<Net> {
  public:
   const char* GetName() const override { return "onnxruntime"; }
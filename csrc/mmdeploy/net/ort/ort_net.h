@@ -3,7 +3,11 @@
 #ifndef MMDEPLOY_SRC_NET_ORT_ORT_NET_H_
 #define MMDEPLOY_SRC_NET_ORT_ORT_NET_H_
 
+#include <map>
+#include <memory>
+
 #include "mmdeploy/core/net.h"
+#include "mmdeploy/execution/schedulers/single_thread_context.h"
 #include "onnxruntime_c_api.h"
 #include "onnxruntime_cxx_api.h"
 
@@ -18,15 +22,46 @@ class OrtNet : public Net {
   Result<Span<Tensor>> GetOutputTensors() override;
   Result<void> Reshape(Span<TensorShape> input_shapes) override;
   Result<void> Forward() override;
-  Result<void> ForwardAsync(Event* event) override;
+  Result<void> ForwardAsync(std::function<void(Result<void>)> done) override;
+  Result<void> BindInputs(Span<Tensor> inputs) override;
+  Result<std::vector<Tensor>> TakeOutputs() override;
+  Result<std::unique_ptr<Net>> CreateExecutionContext(Stream stream) override;
 
  private:
-  Ort::Env env_;
-  Ort::Session session_{nullptr};
+  // IoBinding cached for a set of input shapes. Output shapes are learned from the runs with these
+  // input shapes, once they are stable the outputs are bound to pre-allocated buffers.
+  struct Binding {
+    explicit Binding(Ort::Session& session) : io_binding(session) {}
+    Ort::IoBinding io_binding;
+    std::vector<const void*> input_data;
+    std::vector<TensorShape> output_shapes;
+    std::vector<std::shared_ptr<void>> output_data;
+    bool output_shapes_known{false};
+    bool dynamic_outputs{false};
+  };
+
+  static constexpr size_t kMaxBindings = 16;
+
+  Binding& GetBinding(const std::vector<Tensor>& input_tensors);
+  Result<bool> BindOutputs(Binding& binding);
+  void LearnOutputShapes(Binding& binding);
+
+  // shared by the execution contexts, `Ort::Session::Run` is thread-safe
+  std::shared_ptr<Ort::Env> env_;
+  std::shared_ptr<Ort::Session> session_;
   std::vector<Tensor> input_tensors_;
   std::vector<Tensor> output_tensors_;
+  std::vector<Tensor> bound_inputs_;
+  std::map<std::vector<TensorShape>, Binding> bindings_;
+  std::vector<TensorShape> static_output_shapes_;
+  // element types of the model, `DataType` doesn't tell uint8 from int8
+  std::vector<ONNXTensorElementDataType> input_types_;
+  std::vector<ONNXTensorElementDataType> output_types_;
   Device device_;
   Stream stream_;
+  // runs the asynchronous forwards, created on first use & declared last so that pending forwards
+  // are finished before the session is destroyed
+  std::unique_ptr<SingleThreadContext> executor_;
 };
 
 }  // namespace mmdeploy
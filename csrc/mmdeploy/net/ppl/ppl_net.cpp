@@ -240,8 +240,6 @@ Result<void> PPLNet::Forward() {
   return success();
 }
 
-Result<void> PPLNet::ForwardAsync(Event* event) { return Status(eNotSupported); }
-
 Result<void> ReshapeLike(PPLTensor& dst, Tensor& src) {
   auto& dst_desc = *dst.GetShape();
   auto& src_desc = src.desc();
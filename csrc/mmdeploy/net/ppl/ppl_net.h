@@ -28,8 +28,6 @@ class PPLNet : public Net {
 
   Result<void> Forward() override;
 
-  Result<void> ForwardAsync(Event* event) override;
-
   static Result<std::vector<TensorShape> > InferOutputShapes(Span<TensorShape> input_shapes,
                                                              Span<TensorShape> prev_in_shapes,
                                                              Span<TensorShape> prev_out_shapes);
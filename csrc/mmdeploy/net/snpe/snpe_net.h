@@ -32,7 +32,6 @@ class SNPENet : public Net {
   Result<Span<Tensor>> GetOutputTensors() override;
   Result<void> Reshape(Span<TensorShape> input_shapes) override;
   Result<void> Forward() override;
-  Result<void> ForwardAsync(Event* event) override { return Status(eNotSupported); };
 
  private:
   void Build(std::unique_ptr<zdl::DlContainer::IDlContainer>& container,
@@ -114,12 +114,12 @@ Result<void> TRTNet::Init(const Value& args) {
   auto model = context["model"].get<Model>();
   OUTCOME_TRY(auto config, model.GetModelConfig(name));
 
-  OUTCOME_TRY(auto plan, model.ReadFile(config.net));
+  OUTCOME_TRY(auto plan, model.MapFile(config.net));
 
   TRTWrapper runtime = nvinfer1::createInferRuntime(TRTLogger::get());
   TRT_TRY(!!runtime, "failed to create TRT infer runtime");
 
-  engine_ = runtime->deserializeCudaEngine(plan.data(), plan.size());
+  engine_ = MakeShared(runtime->deserializeCudaEngine(plan.data(), plan.size()));
   TRT_TRY(!!engine_, "failed to deserialize TRT CUDA engine");
 
   TRT_TRY(engine_->getNbOptimizationProfiles() == 1, "only 1 optimization profile supported",
@@ -147,6 +147,10 @@ Result<void> TRTNet::Init(const Value& args) {
       output_tensors_.emplace_back(desc, Buffer());
     }
   }
+  return CreateContext();
+}
+
+Result<void> TRTNet::CreateContext() {
   context_ = engine_->createExecutionContext();
   TRT_TRY(!!context_, "failed to create TRT execution context");
 
@@ -156,6 +160,26 @@ Result<void> TRTNet::Init(const Value& args) {
   return success();
 }
 
+Result<std::unique_ptr<Net>> TRTNet::CreateExecutionContext(Stream stream) {
+  auto net = std::make_unique<TRTNet>();
+  net->engine_ = engine_;
+  net->input_ids_ = input_ids_;
+  net->output_ids_ = output_ids_;
+  net->input_names_ = input_names_;
+  net->output_names_ = output_names_;
+  for (const auto& t : input_tensors_) {
+    net->input_tensors_.emplace_back(t.desc(), Buffer());
+  }
+  for (const auto& t : output_tensors_) {
+    net->output_tensors_.emplace_back(t.desc(), Buffer());
+  }
+  net->device_ = device_;
+  net->stream_ = std::move(stream);
+  net->event_ = Event(device_);
+  OUTCOME_TRY(net->CreateContext());
+  return net;
+}
+
 Result<void> TRTNet::Deinit() {
   context_.reset();
   engine_.reset();
@@ -208,8 +232,6 @@ Result<void> TRTNet::Forward() {
   return success();
 }
 
-Result<void> TRTNet::ForwardAsync(Event* event) { return Status(eNotSupported); }
-
 class TRTNetCreator : public Creator<Net> {
  public:
   const char* GetName() const override { return "tensorrt"; }
@@ -3,6 +3,8 @@
 #ifndef MMDEPLOY_SRC_NET_TRT_TRT_NET_H_
 #define MMDEPLOY_SRC_NET_TRT_TRT_NET_H_
 
+#include <memory>
+
 #include "NvInferRuntime.h"
 #include "mmdeploy/core/mpl/span.h"
 #include "mmdeploy/core/net.h"
@@ -46,6 +48,12 @@ class TRTWrapper {
 template <typename T>
 explicit TRTWrapper(T*) -> TRTWrapper<T>;
 // clang-format on
+
+// shared ownership of a TRT object, which is released in the same way as by `TRTWrapper`
+template <typename T>
+std::shared_ptr<T> MakeShared(T* ptr) {
+  return std::shared_ptr<T>(ptr, [](T* p) { TRTWrapper<T> wrapper(p); });
+}
 }  // namespace trt_detail
 
 class TRTNet : public Net {
@@ -57,11 +65,13 @@ class TRTNet : public Net {
   Result<Span<Tensor>> GetOutputTensors() override;
   Result<void> Reshape(Span<TensorShape> input_shapes) override;
   Result<void> Forward() override;
-  Result<void> ForwardAsync(Event* event) override;
+  Result<std::unique_ptr<Net>> CreateExecutionContext(Stream stream) override;
 
  private:
- private:
-  trt_detail::TRTWrapper<nvinfer1::ICudaEngine> engine_;
+  Result<void> CreateContext();
+
+  // shared by the execution contexts created from the net
+  std::shared_ptr<nvinfer1::ICudaEngine> engine_;
   trt_detail::TRTWrapper<nvinfer1::IExecutionContext> context_;
   std::vector<int> input_ids_;
   std::vector<int> output_ids_;
@@ -0,0 +1,155 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+#include <algorithm>
+#include <type_traits>
+
+#include "mmdeploy/core/utils/device_utils.h"
+#include "mmdeploy/preprocess/transform/fused_normalize.h"
+#include "opencv2/core/hal/intrin.hpp"
+#include "opencv_utils.h"
+
+namespace mmdeploy {
+namespace cpu {
+
+namespace {
+
+// dst[c][x] = (src[x][order[c]] - mean[c]) * scale[c] for a row of `width` 3-channel pixels
+template <typename T>
+void NormalizeRowC3(const T* src, int width, const int* order, const float* mean,
+                    const float* scale, float* dst0, float* dst1, float* dst2) {
+  float* dst[] = {dst0, dst1, dst2};
+  int x = 0;
+#if CV_SIMD128
+  if constexpr (std::is_same_v<T, uint8_t>) {
+    cv::v_float32x4 v_mean[3];
+    cv::v_float32x4 v_scale[3];
+    for (int c = 0; c < 3; ++c) {
+      v_mean[c] = cv::v_setall_f32(mean[c]);
+      v_scale[c] = cv::v_setall_f32(scale[c]);
+    }
+    for (; x <= width - 16; x += 16) {
+      cv::v_uint8x16 v_src[3];
+      cv::v_load_deinterleave(src + x * 3, v_src[0], v_src[1], v_src[2]);
+      for (int c = 0; c < 3; ++c) {
+        cv::v_uint16x8 w0, w1;
+        cv::v_uint32x4 d[4];
+        cv::v_expand(v_src[order[c]], w0, w1);
+        cv::v_expand(w0, d[0], d[1]);
+        cv::v_expand(w1, d[2], d[3]);
+        for (int k = 0; k < 4; ++k) {
+          auto f = cv::v_cvt_f32(cv::v_reinterpret_as_s32(d[k]));
+          cv::v_store(dst[c] + x + k * 4, (f - v_mean[c]) * v_scale[c]);
+        }
+      }
+    }
+  }
+#endif
+  for (; x < width; ++x) {
+    for (int c = 0; c < 3; ++c) {
+      dst[c][x] = (static_cast<float>(src[x * 3 + order[c]]) - mean[c]) * scale[c];
+    }
+  }
+}
+
+template <typename T>
+void NormalizeRow(const T* src, int width, int channels, const int* order, const float* mean,
+                  const float* scale, float* dst, int64_t plane) {
+  for (int c = 0; c < channels; ++c) {
+    auto p = dst + c * plane;
+    for (int x = 0; x < width; ++x) {
+      p[x] = (static_cast<float>(src[x * channels + order[c]]) - mean[c]) * scale[c];
+    }
+  }
+}
+
+// Normalizes a (H, W, C) image into the top-left corner of a (C, dst_h, dst_w) tensor and fills the
+// rest with `pad_val`, in a single pass over the source image
+template <typename T>
+void NormalizePadToCHW(const T* src, int height, int width, int channels, const int* order,
+                       const float* mean, const float* scale, float pad_val, int dst_h, int dst_w,
+                       float* dst) {
+  const int64_t plane = (int64_t)dst_h * dst_w;
+  for (int y = 0; y < height; ++y) {
+    auto s = src + (int64_t)y * width * channels;
+    auto d = dst + (int64_t)y * dst_w;
+    if (channels == 3) {
+      NormalizeRowC3(s, width, order, mean, scale, d, d + plane, d + 2 * plane);
+    } else {
+      NormalizeRow(s, width, channels, order, mean, scale, d, plane);
+    }
+    for (int c = 0; c < channels; ++c) {
+      std::fill(d + c * plane + width, d + c * plane + dst_w, pad_val);
+    }
+  }
+  for (int c = 0; c < channels; ++c) {
+    std::fill(dst + c * plane + (int64_t)height * dst_w, dst + (c + 1) * plane, pad_val);
+  }
+}
+
+}  // namespace
+
+class FusedNormalizeImpl : public ::mmdeploy::FusedNormalizeImpl {
+ public:
+  explicit FusedNormalizeImpl(const Value& args) : ::mmdeploy::FusedNormalizeImpl(args) {
+    // same as `1.0 / std` applied by `cv::multiply` in `Normalize`
+    for (auto v : arg_.std) {
+      scale_.push_back(static_cast<float>(1.0 / v));
+    }
+    auto channels = static_cast<int>(arg_.mean.size());
+    for (int c = 0; c < channels; ++c) {
+      order_.push_back(arg_.to_rgb && channels == 3 ? 2 - c : c);
+    }
+  }
+
+ protected:
+  Result<Tensor> NormalizePadToTensor(const Tensor& img,
+                                      const std::array<int, 4>& padding) override {
+    OUTCOME_TRY(auto src_tensor, MakeAvailableOnDevice(img, device_, stream_));
+
+    SyncOnScopeExit(stream_, src_tensor.buffer() != img.buffer(), src_tensor);
+
+    auto shape = src_tensor.shape();
+    int height = shape[1];
+    int width = shape[2];
+    int channels = shape[3];
+    int dst_h = height + padding[1] + padding[3];
+    int dst_w = width + padding[0] + padding[2];
+    if (padding[0] || padding[1] || padding[2] < 0 || padding[3] < 0) {
+      MMDEPLOY_ERROR("unsupported padding: {}, {}, {}, {}", padding[0], padding[1], padding[2],
+                     padding[3]);
+      return Status(eNotSupported);
+    }
+
+    Tensor dst_tensor(TensorDesc{device_, DataType::kFLOAT, {1, channels, dst_h, dst_w}, ""},
+                      allocator_);
+    auto dst = dst_tensor.data<float>();
+    if (src_tensor.data_type() == DataType::kINT8) {
+      NormalizePadToCHW(src_tensor.data<uint8_t>(), height, width, channels, order_.data(),
+                        arg_.mean.data(), scale_.data(), arg_.pad_val, dst_h, dst_w, dst);
+    } else {
+      NormalizePadToCHW(src_tensor.data<float>(), height, width, channels, order_.data(),
+                        arg_.mean.data(), scale_.data(), arg_.pad_val, dst_h, dst_w, dst);
+    }
+    return dst_tensor;
+  }
+
+ private:
+  std::vector<float> scale_;
+  std::vector<int> order_;
+};
+
+class FusedNormalizeImplCreator : public Creator<::mmdeploy::FusedNormalizeImpl> {
+ public:
+  const char* GetName() const override { return "cpu"; }
+  int GetVersion() const override { return 1; }
+  ReturnType Create(const Value& args) override {
+    return std::make_unique<FusedNormalizeImpl>(args);
+  }
+};
+
+}  // namespace cpu
+}  // namespace mmdeploy
+
+using mmdeploy::FusedNormalizeImpl;
+using mmdeploy::cpu::FusedNormalizeImplCreator;
+REGISTER_MODULE(FusedNormalizeImpl, FusedNormalizeImplCreator);
@@ -3,6 +3,7 @@
 #include "mmdeploy/core/registry.h"
 #include "mmdeploy/core/utils/device_utils.h"
 #include "mmdeploy/preprocess/transform/normalize.h"
+#include "opencv2/imgproc/imgproc.hpp"
 #include "opencv_utils.h"
 
 using namespace std;
@@ -25,6 +26,16 @@ class NormalizeImpl : public ::mmdeploy::NormalizeImpl {
     auto dst_mat = Normalize(mat, arg_.mean, arg_.std, arg_.to_rgb, true);
     return CVMat2Tensor(dst_mat);
   }
+
+  Result<Tensor> ConvertToRGB(const Tensor& tensor) override {
+    OUTCOME_TRY(auto src_tensor, MakeAvailableOnDevice(tensor, device_, stream_));
+
+    SyncOnScopeExit sync(stream_, src_tensor.buffer() != tensor.buffer(), src_tensor);
+
+    cv::Mat dst_mat;
+    cv::cvtColor(Tensor2CVMat(src_tensor), dst_mat, cv::COLOR_BGR2RGB);
+    return CVMat2Tensor(dst_mat);
+  }
 };
 
 class NormalizeImplCreator : public Creator<::mmdeploy::NormalizeImpl> {
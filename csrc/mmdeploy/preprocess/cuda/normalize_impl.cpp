@@ -5,6 +5,7 @@
 #include "mmdeploy/core/utils/device_utils.h"
 #include "mmdeploy/core/utils/formatter.h"
 #include "mmdeploy/preprocess/transform/normalize.h"
+#include "ppl/cv/cuda/cvtcolor.h"
 
 using namespace std;
 
@@ -66,6 +67,37 @@ class NormalizeImpl : public ::mmdeploy::NormalizeImpl {
     }
     return dst_tensor;
   }
+
+  Result<Tensor> ConvertToRGB(const Tensor& tensor) override {
+    OUTCOME_TRY(auto src_tensor, MakeAvailableOnDevice(tensor, device_, stream_));
+
+    SyncOnScopeExit sync(stream_, src_tensor.buffer() != tensor.buffer(), src_tensor);
+
+    auto src_desc = src_tensor.desc();
+    int h = (int)src_desc.shape[1];
+    int w = (int)src_desc.shape[2];
+    int stride = w * (int)src_desc.shape[3];
+
+    Tensor dst_tensor{TensorDesc{device_, src_desc.data_type, src_desc.shape, src_desc.name}};
+    auto stream = ::mmdeploy::GetNative<cudaStream_t>(stream_);
+
+    ppl::common::RetCode ret = 0;
+    if (DataType::kINT8 == src_desc.data_type) {
+      ret = ppl::cv::cuda::BGR2RGB<uint8_t>(stream, h, w, stride, src_tensor.data<uint8_t>(),
+                                            stride, dst_tensor.data<uint8_t>());
+    } else if (DataType::kFLOAT == src_desc.data_type) {
+      ret = ppl::cv::cuda::BGR2RGB<float>(stream, h, w, stride, src_tensor.data<float>(), stride,
+                                          dst_tensor.data<float>());
+    } else {
+      MMDEPLOY_ERROR("unsupported data type {}", src_desc.data_type);
+      return Status(eNotSupported);
+    }
+    if (ret != 0) {
+      MMDEPLOY_ERROR("color transfer from BGR to RGB failed, ret {}", ret);
+      return Status(eFail);
+    }
+    return dst_tensor;
+  }
 };
 
 class NormalizeImplCreator : public Creator<::mmdeploy::NormalizeImpl> {
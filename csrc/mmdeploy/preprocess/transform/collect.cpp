@@ -26,26 +26,29 @@ CollectImpl::CollectImpl(const Value &args) {
 }
 
 Result<Value> CollectImpl::Process(const Value &input) {
+  static const ValueKey kOriImg{"ori_img"};
+  static const ValueKey kAttribute{"attribute"};
+  static const ValueKey kImgMetas{"img_metas"};
   MMDEPLOY_DEBUG("input: {}", to_json(input).dump(2));
   Value output;
 
   // collect 'ori_img' and 'attribute' from `input`, because those two fields
   // are given by users, not generated by transform ops
-  if (input.contains("ori_img")) {
-    output["ori_img"] = input["ori_img"];
+  if (input.contains(kOriImg)) {
+    output[kOriImg] = input[kOriImg];
   }
-  if (input.contains("attribute")) {
-    output["attribute"] = input["attribute"];
+  if (input.contains(kAttribute)) {
+    output[kAttribute] = input[kAttribute];
   }
 
   for (auto &meta_key : arg_.meta_keys) {
     if (input.contains(meta_key)) {
-      output["img_metas"][meta_key] = input[meta_key];
+      output[kImgMetas][meta_key] = input[meta_key];
     }
   }
   for (auto &key : arg_.keys) {
     if (!input.contains(key)) {
-      MMDEPLOY_INFO("missed key '{}' in input", key);
+      MMDEPLOY_INFO("missed key '{}' in input", key.str());
       return Status(eInvalidArgument);
     } else {
       output[key] = input[key];
@@ -15,8 +15,9 @@ class MMDEPLOY_API CollectImpl : public Module {
 
  protected:
   struct collect_arg_t {
-    std::vector<std::string> keys;
-    std::vector<std::string> meta_keys;
+    // interned once, the lookups of each input compare the addresses of the keys
+    std::vector<ValueKey> keys;
+    std::vector<ValueKey> meta_keys;
   };
   using ArgType = collect_arg_t;
 
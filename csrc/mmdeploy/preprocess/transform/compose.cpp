@@ -2,19 +2,61 @@
 
 #include "compose.h"
 
+#include "fused_normalize.h"
 #include "mmdeploy/archive/json_archive.h"
 #include "mmdeploy/archive/value_archive.h"
 #include "mmdeploy/core/utils/formatter.h"
 
 namespace mmdeploy {
 
+namespace {
+
+// "to_float": false      // keep the images in uint8, for models with the normalization folded in
+// "channels_last": true  // keep the images in (1, H, W, C)
+//
+// The options of `Compose` are passed to the transforms producing the input tensor, unless they are
+// configured by the transforms themselves
+Value ApplyTensorOptions(const Value& args, Value transforms) {
+  for (auto& cfg : transforms) {
+    auto type = cfg.value("type", std::string{});
+    if (args.contains("to_float")) {
+      auto key = type == "Normalize" ? "to_float"
+                 : type == "DefaultFormatBundle" ? "img_to_float"
+                                                 : nullptr;
+      if (key && !cfg.contains(key)) {
+        cfg[key] = args["to_float"];
+      }
+    }
+    if (args.contains("channels_last") && !cfg.contains("channels_last") &&
+        (type == "ImageToTensor" || type == "DefaultFormatBundle")) {
+      cfg["channels_last"] = args["channels_last"];
+    }
+  }
+  return transforms;
+}
+
+}  // namespace
+
 Compose::Compose(const Value& args, int version) : Transform(args) {
   assert(args.contains("context"));
 
   Value context;
   context = args["context"];
   context["stream"].get_to(stream_);
-  for (auto cfg : args["transforms"]) {
+  // fuse transform sequences that have a fused implementation on the platform
+  auto fuse = args.value("fuse_transform", true) &&
+              Registry<FusedNormalizeImpl>::Get().GetCreator(specified_platform_, version);
+  auto transforms = ApplyTensorOptions(args, args["transforms"]);
+  for (int i = 0; i < transforms.size(); ++i) {
+    auto cfg = transforms[i];
+    if (int n = fuse ? FusedNormalizeImpl::Match(transforms, i) : 0) {
+      cfg = {{"type", "FusedNormalize"}, {"normalize", transforms[i]}};
+      if (n == 3) {
+        cfg["pad"] = transforms[i + 1];
+      }
+      cfg["to_tensor"] = transforms[i + n - 1];
+      i += n - 1;
+    }
     cfg["context"] = context;
     auto type = cfg.value("type", std::string{});
     MMDEPLOY_DEBUG("creating transform: {} with cfg: {}", type, mmdeploy::to_json(cfg).dump(2));
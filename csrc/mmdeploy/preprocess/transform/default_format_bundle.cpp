@@ -13,6 +13,7 @@ DefaultFormatBundleImpl::DefaultFormatBundleImpl(const Value& args) : TransformI
   if (args.contains("img_to_float") && args["img_to_float"].is_boolean()) {
     arg_.img_to_float = args["img_to_float"].get<bool>();
   }
+  arg_.channels_last = args.value("channels_last", false);
 }
 
 Result<Value> DefaultFormatBundleImpl::Process(const Value& input) {
@@ -41,7 +42,9 @@ Result<Value> DefaultFormatBundleImpl::Process(const Value& input) {
     }
 
     // transpose
-    OUTCOME_TRY(tensor, HWC2CHW(tensor));
+    if (!arg_.channels_last) {
+      OUTCOME_TRY(tensor, HWC2CHW(tensor));
+    }
     SetTransformData(output, "img", std::move(tensor));
   }
 
@@ -24,6 +24,8 @@ class MMDEPLOY_API DefaultFormatBundleImpl : public TransformImpl {
  protected:
   struct default_format_bundle_arg_t {
     bool img_to_float = true;
+    // keep the (1, H, W, C) layout, for the models taking NHWC inputs
+    bool channels_last = false;
   };
   using ArgType = struct default_format_bundle_arg_t;
 
@@ -0,0 +1,228 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+#include "fused_normalize.h"
+
+#include "mmdeploy/archive/json_archive.h"
+#include "mmdeploy/core/registry.h"
+#include "mmdeploy/core/tensor.h"
+#include "mmdeploy/core/utils/formatter.h"
+
+using namespace std;
+
+namespace mmdeploy {
+
+FusedNormalizeImpl::FusedNormalizeImpl(const Value& args) : TransformImpl(args) {
+  auto& normalize = args["normalize"];
+  if (!normalize.contains("mean") || !normalize.contains("std")) {
+    MMDEPLOY_ERROR("no 'mean' or 'std' is configured");
+    throw std::invalid_argument("no 'mean' or 'std' is configured");
+  }
+  for (auto& v : normalize["mean"]) {
+    arg_.mean.push_back(v.get<float>());
+  }
+  for (auto& v : normalize["std"]) {
+    arg_.std.push_back(v.get<float>());
+  }
+  arg_.to_rgb = normalize.value("to_rgb", true);
+
+  arg_.pad = args.contains("pad");
+  arg_.pad_size = {0, 0};
+  arg_.pad_size_divisor = 1;
+  arg_.pad_val = 0.f;
+  arg_.pad_to_square = false;
+  if (arg_.pad) {
+    auto& pad = args["pad"];
+    if (pad.contains("size") && pad["size"].is_number_integer()) {
+      arg_.pad_size[0] = arg_.pad_size[1] = pad["size"].get<int>();
+    }
+    if (pad.contains("size") && pad["size"].is_array()) {
+      if (pad["size"].size() != 2) {
+        throw std::invalid_argument("the length of size should be 2");
+      }
+      arg_.pad_size[0] = pad["size"][0].get<int>();
+      arg_.pad_size[1] = pad["size"][1].get<int>();
+    }
+    arg_.pad_size_divisor = pad.value("size_divisor", 1);
+    if (pad.contains("pad_val")) {
+      if (pad["pad_val"].is_number()) {
+        arg_.pad_val = pad["pad_val"].get<float>();
+      } else if (pad["pad_val"].contains("img")) {
+        arg_.pad_val = pad["pad_val"]["img"][0].get<float>();
+      } else {
+        throw std::invalid_argument("args must be number or img dict");
+      }
+    }
+    arg_.pad_to_square = pad.value("pad_to_square", false);
+  }
+  arg_.format_bundle = args["to_tensor"].value("type", string{}) == "DefaultFormatBundle";
+}
+
+int FusedNormalizeImpl::Match(const Value& transforms, int index) {
+  auto type = [&](int i) {
+    return i < static_cast<int>(transforms.size()) ? transforms[i].value("type", string{})
+                                                   : string{};
+  };
+  // the fused kernel produces normalized float (1, C, H', W') tensors only
+  if (type(index) != "Normalize" || !transforms[index].value("to_float", true)) {
+    return 0;
+  }
+  int i = index + 1;
+  if (type(i) == "Pad") {
+    if (transforms[i].value("padding_mode", string{"constant"}) != "constant") {
+      return 0;
+    }
+    ++i;
+  }
+  if (i < static_cast<int>(transforms.size()) && transforms[i].value("channels_last", false)) {
+    return 0;
+  }
+  if (type(i) == "ImageToTensor") {
+    auto& keys = transforms[i]["keys"];
+    if (!keys.is_array() || keys.size() != 1 || keys[0].get<string>() != "img") {
+      return 0;
+    }
+  } else if (type(i) != "DefaultFormatBundle") {
+    return 0;
+  }
+  return i - index + 1;
+}
+
+bool FusedNormalizeImpl::IsSupported(const Value& input) {
+  if (GetImageFields(input) != vector<string>{"img"} || !input.contains("img")) {
+    return false;
+  }
+  auto tensor = input["img"].get<Tensor>();
+  auto& desc = tensor.desc();
+  return desc.shape.size() == 4 && desc.shape[0] == 1 &&
+         desc.shape[3] == static_cast<int64_t>(arg_.mean.size()) &&
+         (desc.data_type == DataType::kINT8 || desc.data_type == DataType::kFLOAT);
+}
+
+Result<Value> FusedNormalizeImpl::Process(const Value& input) {
+  MMDEPLOY_DEBUG("input: {}", to_json(input).dump(2));
+  Value output = input;
+
+  auto tensor = input["img"].get<Tensor>();
+  int height = tensor.shape(1);
+  int width = tensor.shape(2);
+
+  // meta data of `Normalize`
+  for (auto& v : arg_.mean) {
+    output["img_norm_cfg"]["mean"].push_back(v);
+  }
+  for (auto v : arg_.std) {
+    output["img_norm_cfg"]["std"].push_back(v);
+  }
+  output["img_norm_cfg"]["to_rgb"] = arg_.to_rgb;
+
+  // meta data of `Pad`
+  std::array<int, 4> padding{0, 0, 0, 0};
+  if (arg_.pad) {
+    if (arg_.pad_to_square) {
+      int max_size = std::max(height, width);
+      padding = {0, 0, max_size - width, max_size - height};
+      output["pad_fixed_size"].push_back(max_size);
+      output["pad_fixed_size"].push_back(max_size);
+    } else if (arg_.pad_size[0] != 0 && arg_.pad_size[1] != 0) {
+      padding = {0, 0, arg_.pad_size[1] - width, arg_.pad_size[0] - height};
+      output["pad_fixed_size"].push_back(arg_.pad_size[0]);
+      output["pad_fixed_size"].push_back(arg_.pad_size[1]);
+    } else if (arg_.pad_size_divisor != 1) {
+      auto pad_h = (height + arg_.pad_size_divisor - 1) / arg_.pad_size_divisor *
+                   arg_.pad_size_divisor;
+      auto pad_w =
+          (width + arg_.pad_size_divisor - 1) / arg_.pad_size_divisor * arg_.pad_size_divisor;
+      padding = {0, 0, pad_w - width, pad_h - height};
+      output["pad_size_divisor"] = arg_.pad_size_divisor;
+      output["pad_fixed_size"].push_back(pad_h);
+      output["pad_fixed_size"].push_back(pad_w);
+    } else {
+      output["pad_fixed_size"].push_back(height);
+      output["pad_fixed_size"].push_back(width);
+    }
+  }
+
+  // meta data of `DefaultFormatBundle`
+  if (arg_.pad || (arg_.format_bundle && !output.contains("pad_shape"))) {
+    for (auto v : {tensor.shape(0), int64_t(height + padding[3]), int64_t(width + padding[2]),
+                   tensor.shape(3)}) {
+      output["pad_shape"].push_back(v);
+    }
+  }
+  if (arg_.format_bundle && !output.contains("scale_factor")) {
+    output["scale_factor"].push_back(1.0);
+  }
+
+  OUTCOME_TRY(auto dst, NormalizePadToTensor(tensor, padding));
+  SetTransformData(output, "img", std::move(dst));
+
+  MMDEPLOY_DEBUG("output: {}", to_json(output).dump(2));
+  return output;
+}
+
+FusedNormalize::FusedNormalize(const Value& args, int version) : Transform(args) {
+  auto impl_creator = Registry<FusedNormalizeImpl>::Get().GetCreator(specified_platform_, version);
+  if (nullptr == impl_creator) {
+    MMDEPLOY_ERROR("'FusedNormalize' is not supported on '{}' platform", specified_platform_);
+    throw std::domain_error("'FusedNormalize' is not supported on specified platform");
+  }
+  impl_ = impl_creator->Create(args);
+
+  // the separate transforms, for inputs the fused kernel can't handle
+  for (auto key : {"normalize", "pad", "to_tensor"}) {
+    if (!args.contains(key)) {
+      continue;
+    }
+    auto cfg = args[key];
+    cfg["context"] = args["context"];
+    auto type = cfg.value("type", string{});
+    auto creator = Registry<Transform>::Get().GetCreator(type, version);
+    if (!creator) {
+      MMDEPLOY_ERROR("Unable to find Transform creator: {}", type);
+      throw_exception(eEntryNotFound);
+    }
+    auto transform = creator->Create(cfg);
+    if (!transform) {
+      MMDEPLOY_ERROR("Failed to create transform: {}, config: {}", type, cfg);
+      throw_exception(eFail);
+    }
+    transforms_.push_back(std::move(transform));
+  }
+}
+
+Result<Value> FusedNormalize::Process(const Value& input) {
+  if (impl_->IsSupported(input)) {
+    return impl_->Process(input);
+  }
+  Value output = input;
+  Value::Array intermediates;
+  for (auto& transform : transforms_) {
+    OUTCOME_TRY(auto t, transform->Process(output));
+    if (auto it = t.find("__data__"); it != t.end()) {
+      std::move(it->begin(), it->end(), std::back_inserter(intermediates));
+      it->array().clear();
+    }
+    output = std::move(t);
+  }
+  // pass the intermediate data on to `Compose`, which keeps them until the stream is synchronized
+  output["__data__"] = std::move(intermediates);
+  return output;
+}
+
+class FusedNormalizeCreator : public Creator<Transform> {
+ public:
+  const char* GetName() const override { return "FusedNormalize"; }
+  int GetVersion() const override { return version_; }
+  ReturnType Create(const Value& args) override {
+    return make_unique<FusedNormalize>(args, version_);
+  }
+
+ private:
+  int version_{1};
+};
+
+REGISTER_MODULE(Transform, FusedNormalizeCreator);
+
+MMDEPLOY_DEFINE_REGISTRY(FusedNormalizeImpl);
+
+}  // namespace mmdeploy
@@ -0,0 +1,74 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+#ifndef MMDEPLOY_FUSED_NORMALIZE_H
+#define MMDEPLOY_FUSED_NORMALIZE_H
+
+#include <array>
+
+#include "mmdeploy/core/tensor.h"
+#include "transform.h"
+
+namespace mmdeploy {
+
+/**
+ * `Normalize` fused with the following `Pad` (optional) and `ImageToTensor` or
+ * `DefaultFormatBundle`. The (1, H, W, C) image is read once and the normalized, padded
+ * (1, C, H', W') float tensor is written directly, without the intermediate images of the
+ * separate transforms.
+ *
+ * `Compose` creates it for matching transform sequences, the config is
+ * {"normalize": {...}, "pad": {...}, "to_tensor": {...}} holding the configs of the fused
+ * transforms.
+ */
+class MMDEPLOY_API FusedNormalizeImpl : public TransformImpl {
+ public:
+  explicit FusedNormalizeImpl(const Value& args);
+  ~FusedNormalizeImpl() override = default;
+
+  // whether the fused kernel can handle the input, otherwise the separate transforms are used
+  bool IsSupported(const Value& input);
+
+  Result<Value> Process(const Value& input) override;
+
+  // whether the transform configs starting at `index` can be fused, returns the number of
+  // transforms to be fused or 0
+  static int Match(const Value& transforms, int index);
+
+ protected:
+  // `padding` is {left, top, right, bottom}
+  virtual Result<Tensor> NormalizePadToTensor(const Tensor& img,
+                                              const std::array<int, 4>& padding) = 0;
+
+ protected:
+  struct fused_normalize_arg_t {
+    std::vector<float> mean;
+    std::vector<float> std;
+    bool to_rgb;
+    bool pad;
+    std::array<int, 2> pad_size;
+    int pad_size_divisor;
+    float pad_val;
+    bool pad_to_square;
+    bool format_bundle;
+  };
+  using ArgType = struct fused_normalize_arg_t;
+  ArgType arg_;
+};
+
+class MMDEPLOY_API FusedNormalize : public Transform {
+ public:
+  explicit FusedNormalize(const Value& args, int version = 0);
+  ~FusedNormalize() override = default;
+
+  Result<Value> Process(const Value& input) override;
+
+ private:
+  std::unique_ptr<FusedNormalizeImpl> impl_;
+  std::vector<std::unique_ptr<Transform>> transforms_;
+};
+
+MMDEPLOY_DECLARE_REGISTRY(FusedNormalizeImpl);
+
+}  // namespace mmdeploy
+
+#endif  // MMDEPLOY_FUSED_NORMALIZE_H
@@ -13,11 +13,15 @@ ImageToTensorImpl::ImageToTensorImpl(const Value& args) : TransformImpl(args) {
   for (auto& key : args["keys"]) {
     arg_.keys.push_back(key.get<std::string>());
   }
+  arg_.channels_last = args.value("channels_last", false);
 }
 
 Result<Value> ImageToTensorImpl::Process(const Value& input) {
   MMDEPLOY_DEBUG("input: {}", to_json(input).dump(2));
   Value output = input;
+  if (arg_.channels_last) {
+    return output;
+  }
   for (auto& key : arg_.keys) {
     assert(input.contains(key));
     Tensor src_tensor = input[key].get<Tensor>();
@@ -11,7 +11,7 @@ namespace mmdeploy {
  * Convert image to `Tensor` by given keys.
  *
  * The dimension order of input image is (1, H, W, C). The pipeline will convert
- * it to (1, C, H, W).
+ * it to (1, C, H, W), unless `channels_last` is true.
  *
  */
 class MMDEPLOY_API ImageToTensorImpl : public TransformImpl {
@@ -26,7 +26,9 @@ class MMDEPLOY_API ImageToTensorImpl : public TransformImpl {
 
  protected:
   struct to_img_tensor_arg_t {
-    std::vector<std::string> keys;
+    std::vector<ValueKey> keys;
+    // keep the (1, H, W, C) layout, for the models taking NHWC inputs
+    bool channels_last{false};
   };
   using ArgType = struct to_img_tensor_arg_t;
 
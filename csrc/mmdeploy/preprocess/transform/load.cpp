@@ -31,26 +31,37 @@ PrepareImageImpl::PrepareImageImpl(const Value& args) : TransformImpl(args) {
    */
 
 Result<Value> PrepareImageImpl::Process(const Value& input) {
+  static const ValueKey kOriImg{"ori_img"};
+  static const ValueKey kImgShape{"img_shape"};
+  static const ValueKey kOriShape{"ori_shape"};
+  static const ValueKey kImgFields{"img_fields"};
+  static const ValueKey kImg{"img"};
   MMDEPLOY_DEBUG("input: {}", to_json(input).dump(2));
-  assert(input.contains("ori_img"));
+  assert(input.contains(kOriImg));
 
   // copy input data, and update its properties later
   Value output = input;
 
-  Mat src_mat = input["ori_img"].get<Mat>();
-  auto res = (arg_.color_type == "color" || arg_.color_type == "color_ignore_orientation"
-                  ? ConvertToBGR(src_mat)
-                  : ConvertToGray(src_mat));
-
-  OUTCOME_TRY(auto tensor, std::move(res));
+  Mat src_mat = input[kOriImg].get<Mat>();
+  auto is_color = arg_.color_type == "color" || arg_.color_type == "color_ignore_orientation";
+  auto format = is_color ? PixelFormat::kBGR : PixelFormat::kGRAYSCALE;
+  Tensor tensor;
+  if (src_mat.pixel_format() == format && src_mat.device() == device_ &&
+      (!arg_.to_float32 || src_mat.type() == DataType::kFLOAT)) {
+    // already in the target format, the image is passed on without conversion or copy
+    TensorShape shape{1, src_mat.height(), src_mat.width(), src_mat.channel()};
+    tensor = Tensor(TensorDesc{src_mat.device(), src_mat.type(), shape, ""}, src_mat.buffer());
+  } else {
+    OUTCOME_TRY(tensor, is_color ? ConvertToBGR(src_mat) : ConvertToGray(src_mat));
+  }
 
   for (auto v : tensor.desc().shape) {
-    output["img_shape"].push_back(v);
+    output[kImgShape].push_back(v);
   }
-  output["ori_shape"] = {1, src_mat.height(), src_mat.width(), src_mat.channel()};
-  output["img_fields"].push_back("img");
+  output[kOriShape] = {1, src_mat.height(), src_mat.width(), src_mat.channel()};
+  output[kImgFields].push_back("img");
 
-  SetTransformData(output, "img", std::move(tensor));
+  SetTransformData(output, kImg, std::move(tensor));
 
   MMDEPLOY_DEBUG("output: {}", to_json(output).dump(2));
 
@@ -24,6 +24,13 @@ NormalizeImpl::NormalizeImpl(const Value& args) : TransformImpl(args) {
     arg_.std.push_back(v.get<float>());
   }
   arg_.to_rgb = args.value("to_rgb", true);
+  arg_.to_float = args.value("to_float", true);
+}
+
+Result<Tensor> NormalizeImpl::ConvertToRGB(const Tensor& img) {
+  MMDEPLOY_ERROR("'Normalize' without converting to float is not supported on '{}' platform",
+                 Platform(device_.platform_id()).GetPlatformName());
+  return Status(eNotSupported);
 }
 
 /**
@@ -46,7 +53,8 @@ NormalizeImpl::NormalizeImpl(const Value& args) : TransformImpl(args) {
     "img_norm_cfg": {
       "mean": [float],
       "std": [float],
-      "to_rgb": true
+      "to_rgb": true,
+      "to_float": false  // present only when `to_float` is false
     }
   }
  */
@@ -65,8 +73,13 @@ Result<Value> NormalizeImpl::Process(const Value& input) {
     assert(desc.shape.size() == 4 /*n, h, w, c*/);
     assert(desc.shape[3] == arg_.mean.size());
 
-    OUTCOME_TRY(auto dst, NormalizeImage(tensor));
-    SetTransformData(output, key, std::move(dst));
+    if (arg_.to_float) {
+      OUTCOME_TRY(auto dst, NormalizeImage(tensor));
+      SetTransformData(output, key, std::move(dst));
+    } else if (arg_.to_rgb && desc.shape[3] == 3) {
+      OUTCOME_TRY(auto dst, ConvertToRGB(tensor));
+      SetTransformData(output, key, std::move(dst));
+    }
 
     for (auto& v : arg_.mean) {
       output["img_norm_cfg"]["mean"].push_back(v);
@@ -75,6 +88,9 @@ Result<Value> NormalizeImpl::Process(const Value& input) {
       output["img_norm_cfg"]["std"].push_back(v);
     }
     output["img_norm_cfg"]["to_rgb"] = arg_.to_rgb;
+    if (!arg_.to_float) {
+      output["img_norm_cfg"]["to_float"] = false;
+    }
   }
   MMDEPLOY_DEBUG("output: {}", to_json(output).dump(2));
   return output;
@@ -18,11 +18,17 @@ class MMDEPLOY_API NormalizeImpl : public TransformImpl {
  protected:
   virtual Result<Tensor> NormalizeImage(const Tensor& img) = 0;
 
+  // swaps the channels of a 3-channel image without converting it, for `to_float` being false
+  virtual Result<Tensor> ConvertToRGB(const Tensor& img);
+
  protected:
   struct normalize_arg_t {
     std::vector<float> mean;
     std::vector<float> std;
     bool to_rgb;
+    // when false, the image keeps its data type and only the channel order is changed. `mean` &
+    // `std` are left to the model, e.g. they are folded into the model or applied by the backend
+    bool to_float;
   };
   using ArgType = struct normalize_arg_t;
   ArgType arg_;
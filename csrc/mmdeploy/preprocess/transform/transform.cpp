@@ -11,17 +11,21 @@ TransformImpl::TransformImpl(const Value &args) {
   if (args.contains("context")) {
     args["context"]["device"].get_to(device_);
     args["context"]["stream"].get_to(stream_);
+    if (args["context"].contains("allocator")) {
+      args["context"]["allocator"].get_to(allocator_);
+    }
   } else {
     throw_exception(eNotSupported);
   }
 }
 std::vector<std::string> TransformImpl::GetImageFields(const Value &input) {
-  if (input.contains("img_fields")) {
-    if (input["img_fields"].is_string()) {
-      return {input["img_fields"].get<std::string>()};
-    } else if (input["img_fields"].is_array()) {
+  static const ValueKey kImgFields{"img_fields"};
+  if (input.contains(kImgFields)) {
+    if (input[kImgFields].is_string()) {
+      return {input[kImgFields].get<std::string>()};
+    } else if (input[kImgFields].is_array()) {
       std::vector<std::string> img_fields;
-      for (auto &v : input["img_fields"]) {
+      for (auto &v : input[kImgFields]) {
         img_fields.push_back(v.get<std::string>());
       }
       return img_fields;
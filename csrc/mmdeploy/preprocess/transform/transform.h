@@ -21,6 +21,8 @@ class MMDEPLOY_API TransformImpl : public Module {
  protected:
   Device device_;
   Stream stream_;
+  // allocator of the pipeline, the platform's default allocator is used when it's empty
+  Allocator allocator_;
 };
 
 class MMDEPLOY_API Transform : public Module {
@@ -67,8 +69,9 @@ class MMDEPLOY_API Transform : public Module {
 
 template <typename Key, typename Val>
 void SetTransformData(Value& dst, Key&& key, Val val) {
+  static const ValueKey kData{"__data__"};
   dst[std::forward<Key>(key)] = val;
-  dst["__data__"].push_back(std::move(val));
+  dst[kData].push_back(std::move(val));
 }
 
 MMDEPLOY_DECLARE_REGISTRY(Transform);
@@ -7,8 +7,9 @@ import mmcv
 
 from mmdeploy.apis import build_task_processor
 from mmdeploy.utils import (Backend, Task, get_backend, get_codebase,
-                            get_common_config, get_ir_config, get_root_logger,
-                            get_task_type, is_dynamic_batch, load_config)
+                            get_codebase_config, get_common_config,
+                            get_ir_config, get_root_logger, get_task_type,
+                            is_dynamic_batch, load_config)
 from mmdeploy.utils.constants import SDK_TASK_MAP as task_map
 
 
@@ -183,6 +184,25 @@ def get_inference_info(deploy_cfg: mmcv.Config, model_cfg: mmcv.Config,
         input_map=input_map)
     if 'use_vulkan' in deploy_cfg['backend_config']:
         return_dict['use_vulkan'] = deploy_cfg['backend_config']['use_vulkan']
+    task = get_task_type(deploy_cfg)
+    codebase_config = get_codebase_config(deploy_cfg)
+    if task == Task.SUPER_RESOLUTION and 'tile' in codebase_config:
+        # e.g. tile=dict(tile_size=256, tile_overlap=16, batch_size=4), the
+        # net runs on overlapping tiles of the input, so the backend model
+        # must accept inputs of the tile size
+        return_dict['module'] = 'TiledRestorer'
+        return_dict.update(codebase_config['tile'])
+    test_cfg = model_cfg.model.get('test_cfg', None) or {}
+    if task == Task.SEGMENTATION and test_cfg.get('mode', None) == 'slide':
+        # the net runs on the windows of the input as in the "slide" test mode
+        # of mmseg, the backend model must accept inputs of the crop size
+        decode_head = model_cfg.model.decode_head
+        if isinstance(decode_head, list):
+            decode_head = decode_head[-1]
+        return_dict['module'] = 'SlidingSegmentor'
+        return_dict['crop_size'] = list(test_cfg['crop_size'])
+        return_dict['stride'] = list(test_cfg['stride'])
+        return_dict['num_classes'] = decode_head['num_classes']
     return return_dict
 
 
@@ -0,0 +1,107 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+// clang-format off
+#include "catch.hpp"
+// clang-format on
+
+#include <vector>
+
+#include "mmdeploy/apis/c/mmdeploy/common.h"
+#include "mmdeploy/apis/c/mmdeploy/common_internal.h"
+
+namespace {
+
+void CountingDeleter(uint8_t* data, void* user_data) {
+  delete[] data;
+  ++*static_cast<int*>(user_data);
+}
+
+std::vector<mmdeploy_mat_t> CreateMats(int count) {
+  std::vector<mmdeploy_mat_t> mats;
+  for (int i = 0; i < count; ++i) {
+    mats.push_back({new uint8_t[4 * 4 * 3]{}, 4, 4, 3, MMDEPLOY_PIXEL_FORMAT_BGR,
+                    MMDEPLOY_DATA_TYPE_UINT8});
+  }
+  return mats;
+}
+
+}  // namespace
+
+TEST_CASE("test input with ownership transferred", "[capi]") {
+  int released = 0;
+
+  SECTION("buffers are released with the last reference") {
+    auto mats = CreateMats(2);
+    mmdeploy_value_t value{};
+    REQUIRE(mmdeploy_common_create_input_v2(mats.data(), 2, CountingDeleter, &released, &value) ==
+            MMDEPLOY_SUCCESS);
+    auto copy = mmdeploy_value_copy(value);
+    mmdeploy_value_destroy(value);
+    REQUIRE(released == 0);
+    mmdeploy_value_destroy(copy);
+    REQUIRE(released == 2);
+  }
+
+  SECTION("buffers are released on failure") {
+    auto mats = CreateMats(2);
+    REQUIRE(mmdeploy_common_create_input_v2(mats.data(), 2, CountingDeleter, &released, nullptr) ==
+            MMDEPLOY_E_INVALID_ARG);
+    REQUIRE(released == 2);
+  }
+}
+
+TEST_CASE("test result arena", "[capi]") {
+  auto fill = [](mmdeploy_result_buffer_t buffer, size_t count) {
+    ResultArena arena;
+    arena.Reserve<double>(count);
+    arena.Reserve<int>(count);
+    arena.Allocate(buffer);
+    auto values = arena.Take<double>(count);
+    auto counts = arena.Take<int>(count);
+    for (size_t i = 0; i < count; ++i) {
+      values[i] = static_cast<double>(i);
+      counts[i] = static_cast<int>(i);
+    }
+    REQUIRE(reinterpret_cast<char*>(counts) >= reinterpret_cast<char*>(values + count));
+    arena.Detach();
+    return values;
+  };
+
+  SECTION("results owning the block") {
+    auto values = fill(nullptr, 5);
+    REQUIRE(values[4] == 4.);
+    ResultArena::Release(values);
+  }
+
+  SECTION("results placed in a buffer") {
+    mmdeploy_result_buffer_t buffer{};
+    REQUIRE(mmdeploy_result_buffer_create(&buffer) == MMDEPLOY_SUCCESS);
+    auto large = fill(buffer, 16);
+    // the block is reused when it's large enough
+    auto small = fill(buffer, 4);
+    REQUIRE(small == large);
+    REQUIRE(small[3] == 3.);
+    mmdeploy_result_buffer_destroy(buffer);
+  }
+}
+
+TEST_CASE("test default allocator stats", "[capi]") {
+  mmdeploy_allocator_stats_t stats{};
+  REQUIRE(mmdeploy_default_allocator_get_stats("cpu", 0, &stats) == MMDEPLOY_SUCCESS);
+  {
+    mmdeploy::Buffer buffer(mmdeploy::Device("cpu"), 4096);
+    mmdeploy_allocator_stats_t current{};
+    REQUIRE(mmdeploy_default_allocator_get_stats("cpu", 0, &current) == MMDEPLOY_SUCCESS);
+    REQUIRE(current.allocation_count > stats.allocation_count);
+    REQUIRE(current.in_use_bytes >= 4096);
+  }
+  REQUIRE(mmdeploy_default_allocator_get_stats("cpu", 0, nullptr) == MMDEPLOY_E_INVALID_ARG);
+}
+
+TEST_CASE("test status of error codes", "[capi]") {
+  REQUIRE(ToStatus(ErrorCode::eSuccess) == MMDEPLOY_SUCCESS);
+  REQUIRE(ToStatus(ErrorCode::eOutOfRange) == MMDEPLOY_E_OUT_OF_RANGE);
+  // the codes unknown to the C API are failures
+  REQUIRE(ToStatus(ErrorCode::eNotReady) == MMDEPLOY_E_FAIL);
+  REQUIRE(ToStatus(ErrorCode::eUnknown) == MMDEPLOY_E_FAIL);
+}
@@ -60,6 +60,58 @@ TEST_CASE("test text recognizer's c api", "[.text-recognizer][resource]") {
   }
 }
 
+// the bboxes are owned by the caller (e.g. the Java binding), only the results of the recognizer
+// are released by the SDK
+TEST_CASE("test text recognizer with caller-owned bboxes", "[.text-recognizer][resource]") {
+  auto test = [](const string& device, const string& model_path, const vector<string>& img_list) {
+    mmdeploy_text_recognizer_t recognizer{nullptr};
+    REQUIRE(mmdeploy_text_recognizer_create_by_path(model_path.c_str(), device.c_str(), 0,
+                                                    &recognizer) == MMDEPLOY_SUCCESS);
+
+    vector<cv::Mat> cv_mats;
+    vector<mmdeploy_mat_t> mats;
+    // a bbox of the whole image for each image
+    vector<mmdeploy_text_detection_t> bboxes;
+    vector<int> bbox_count;
+    for (auto& img_path : img_list) {
+      cv::Mat mat = cv::imread(img_path);
+      REQUIRE(!mat.empty());
+      cv_mats.push_back(mat);
+      mats.push_back({mat.data, mat.rows, mat.cols, mat.channels(), MMDEPLOY_PIXEL_FORMAT_BGR,
+                      MMDEPLOY_DATA_TYPE_UINT8});
+      auto w = static_cast<float>(mat.cols - 1);
+      auto h = static_cast<float>(mat.rows - 1);
+      bboxes.push_back({{{0, 0}, {w, 0}, {w, h}, {0, h}}, 1.f});
+      bbox_count.push_back(1);
+    }
+
+    mmdeploy_text_recognition_t* results{};
+    REQUIRE(mmdeploy_text_recognizer_apply_bbox(recognizer, mats.data(), (int)mats.size(),
+                                                bboxes.data(), bbox_count.data(),
+                                                &results) == MMDEPLOY_SUCCESS);
+    for (auto i = 0; i < bboxes.size(); ++i) {
+      REQUIRE(results[i].length >= 0);
+    }
+
+    mmdeploy_text_recognizer_release_result(results, (int)bboxes.size());
+    mmdeploy_text_recognizer_destroy(recognizer);
+  };
+
+  auto& gResources = MMDeployTestResources::Get();
+  auto img_list = gResources.LocateImageResources(fs::path{"mmocr"} / "images");
+  REQUIRE(!img_list.empty());
+
+  for (auto& backend : gResources.backends()) {
+    DYNAMIC_SECTION("loop backend: " << backend) {
+      auto model_list = gResources.LocateModelResources(fs::path{"mmocr"} / "textreg" / backend);
+      REQUIRE(!model_list.empty());
+      for (auto& device_name : gResources.device_names(backend)) {
+        test(device_name, model_list.front(), img_list);
+      }
+    }
+  }
+}
+
 TEST_CASE("test text detector-recognizer combo", "[.text-detector-recognizer]") {
   auto test = [](const std::string& device, const string& det_model_path,
                  const string& reg_model_path, std::vector<string>& img_list) {
@@ -0,0 +1,215 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+// clang-format off
+#include "catch.hpp"
+// clang-format on
+
+#include <algorithm>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "mmdeploy/codebase/mmedit/tiling.h"
+#include "mmdeploy/core/mat.h"
+#include "mmdeploy/core/module.h"
+#include "mmdeploy/core/registry.h"
+#include "mmdeploy/core/tensor.h"
+
+using namespace mmdeploy;
+using namespace mmdeploy::mmedit;
+
+namespace {
+
+constexpr const Device kHOST{0, 0};
+
+// nearest upsampling of the tiles by "test_scale"
+class TileNet : public Module {
+ public:
+  explicit TileNet(const Value& cfg) : scale_(cfg.value("test_scale", 1)) {}
+
+  Result<Value> Process(const Value& args) override {
+    Value::Array outputs;
+    for (const auto& sample : args[0]) {
+      auto img = sample["img"].get<Tensor>();
+      auto channels = static_cast<int>(img.shape(1));
+      auto height = static_cast<int>(img.shape(2));
+      auto width = static_cast<int>(img.shape(3));
+      Tensor output(TensorDesc{
+          kHOST, DataType::kFLOAT, {1, channels, height * scale_, width * scale_}, "output"});
+      auto src = img.data<float>();
+      auto dst = output.data<float>();
+      for (int c = 0; c < channels; ++c) {
+        for (int y = 0; y < height * scale_; ++y) {
+          for (int x = 0; x < width * scale_; ++x) {
+            *dst++ = src[(c * height + y / scale_) * width + x / scale_];
+          }
+        }
+      }
+      outputs.push_back({{"output", output}});
+      std::lock_guard lock{mutex_};
+      tiles_.emplace_back(height, width);
+    }
+    return Value(Value::Array{Value(std::move(outputs))});
+  }
+
+  static inline std::mutex mutex_;
+  static inline std::vector<std::pair<int, int>> tiles_;
+
+ private:
+  int scale_;
+};
+
+class TileNetCreator : public Creator<Module> {
+ public:
+  const char* GetName() const override { return "test_tile_net"; }
+  int GetVersion() const override { return 0; }
+  std::unique_ptr<Module> Create(const Value& cfg) override {
+    return std::make_unique<TileNet>(cfg);
+  }
+};
+
+REGISTER_MODULE(Module, TileNetCreator);
+
+int Pixel(int c, int y, int x) { return (c * 31 + y * 7 + x * 3) % 256; }
+
+}  // namespace
+
+TEST_CASE("test tile offsets", "[mmedit]") {
+  REQUIRE(GetTileOffsets(10, 10, 2) == std::vector<int>{0});
+  REQUIRE(GetTileOffsets(100, 32, 8) == std::vector<int>{0, 24, 48, 68});
+  for (const auto [length, tile, overlap] :
+       {std::make_tuple(37, 16, 4), std::make_tuple(53, 16, 15), std::make_tuple(17, 16, 0)}) {
+    auto offsets = GetTileOffsets(length, tile, overlap);
+    REQUIRE(offsets.front() == 0);
+    REQUIRE(offsets.back() == length - tile);
+    for (size_t i = 1; i < offsets.size(); ++i) {
+      REQUIRE(offsets[i] > offsets[i - 1]);
+      REQUIRE(offsets[i - 1] + tile - offsets[i] >= overlap);
+    }
+  }
+}
+
+TEST_CASE("test tile feather", "[mmedit]") {
+  REQUIRE(GetFeather(5, 3, false, false) == std::vector<float>(5, 1.f));
+  auto weights = GetFeather(8, 3, true, true);
+  REQUIRE(weights.front() == Approx(.25f));
+  REQUIRE(weights[3] == 1.f);
+  for (size_t i = 0; i < weights.size(); ++i) {
+    REQUIRE(weights[i] == weights[weights.size() - 1 - i]);
+  }
+  auto begin = GetFeather(8, 3, true, false);
+  REQUIRE(begin.front() == Approx(.25f));
+  REQUIRE(begin.back() == 1.f);
+  // tiles smaller than the ramps
+  for (auto w : GetFeather(2, 8, true, true)) {
+    REQUIRE(w > 0.f);
+  }
+}
+
+TEST_CASE("test tile blender", "[mmedit]") {
+  SECTION("overlapping tiles are averaged by their weights") {
+    Blender blender(Mat(4, 6, PixelFormat::kGRAYSCALE, DataType::kINT8, kHOST), 1);
+    std::vector<float> ones(4, 1.f);
+    std::vector<float> left(16, .2f);
+    std::vector<float> right(16, .6f);
+    blender.Blend(left.data(), 4, 4, 0, 0, ones, ones);
+    blender.Blend(right.data(), 4, 4, 0, 2, ones, ones);
+    blender.Flush(2);
+    blender.Flush(4);
+    auto data = blender.image().data<uint8_t>();
+    for (int y = 0; y < 4; ++y) {
+      REQUIRE(std::vector<int>(data + y * 6, data + y * 6 + 6) ==
+              std::vector<int>{51, 51, 102, 102, 153, 153});
+    }
+  }
+  SECTION("tiles in CHW are written to the HWC image by bands") {
+    Blender blender(Mat(4, 2, PixelFormat::kRGB, DataType::kINT8, kHOST), 3);
+    std::vector<float> ones(2, 1.f);
+    for (int top = 0; top < 4; top += 2) {
+      std::vector<float> tile(12);
+      for (int c = 0; c < 3; ++c) {
+        std::fill_n(tile.data() + c * 4, 4, (c + top * 3) / 255.f);
+      }
+      blender.Blend(tile.data(), 2, 2, top, 0, ones, ones);
+      blender.Flush(top + 2);
+    }
+    auto data = blender.image().data<uint8_t>();
+    for (int i = 0; i < 8; ++i) {
+      auto top = i / 4 * 2;
+      for (int c = 0; c < 3; ++c) {
+        REQUIRE(data[i * 3 + c] == c + top * 3);
+      }
+    }
+  }
+}
+
+TEST_CASE("test tiled restorer", "[mmedit]") {
+  auto creator = Registry<Module>::Get().GetCreator("TiledRestorer");
+  REQUIRE(creator);
+  // height, width, tile_size, tile_overlap, batch_size, scale, channels
+  auto [height, width, tile, overlap, batch_size, scale, channels] =
+      GENERATE(std::make_tuple(37, 53, 16, 4, 3, 2, 3), std::make_tuple(10, 12, 16, 4, 2, 1, 3),
+               std::make_tuple(20, 9, 8, 3, 1, 3, 1), std::make_tuple(33, 40, 32, 8, 4, 1, 1));
+  Value cfg{{"context", {{"device", kHOST}, {"stream", Stream::GetDefault(kHOST)}}},
+            {"net", "test_tile_net"},
+            {"tile_size", tile},
+            {"tile_overlap", overlap},
+            {"batch_size", batch_size},
+            {"test_scale", scale}};
+  auto restorer = creator->Create(cfg);
+  REQUIRE(restorer);
+
+  Tensor img(TensorDesc{kHOST, DataType::kFLOAT, {1, channels, height, width}, "img"});
+  for (int c = 0; c < channels; ++c) {
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        img.data<float>()[(c * height + y) * width + x] = Pixel(c, y, x) / 255.f;
+      }
+    }
+  }
+
+  TileNet::tiles_.clear();
+  auto output = restorer->Process(Value::Array{Value{{"img", img}}});
+  REQUIRE(output);
+  auto mat = output.value()[0]["output"].get<Mat>();
+  REQUIRE(mat.height() == height * scale);
+  REQUIRE(mat.width() == width * scale);
+  REQUIRE(mat.channel() == channels);
+  REQUIRE(mat.pixel_format() == (channels == 1 ? PixelFormat::kGRAYSCALE : PixelFormat::kRGB));
+  int mismatches = 0;
+  auto data = mat.data<uint8_t>();
+  for (int y = 0; y < mat.height(); ++y) {
+    for (int x = 0; x < mat.width(); ++x) {
+      for (int c = 0; c < channels; ++c) {
+        mismatches += *data++ != Pixel(c, y / scale, x / scale);
+      }
+    }
+  }
+  REQUIRE(mismatches == 0);
+
+  // inputs smaller than the tiles are forwarded as a whole
+  auto tile_h = std::min(tile, height);
+  auto tile_w = std::min(tile, width);
+  auto count = GetTileOffsets(height, tile_h, overlap).size() *
+               GetTileOffsets(width, tile_w, overlap).size();
+  REQUIRE(TileNet::tiles_.size() == count);
+  for (const auto& t : TileNet::tiles_) {
+    REQUIRE(t == std::make_pair(tile_h, tile_w));
+  }
+}
+
+TEST_CASE("test tiled restorer rejects unsupported outputs", "[mmedit]") {
+  auto creator = Registry<Module>::Get().GetCreator("TiledRestorer");
+  REQUIRE(creator);
+  Value cfg{{"context", {{"device", kHOST}, {"stream", Stream::GetDefault(kHOST)}}},
+            {"net", "test_tile_net"},
+            {"tile_size", 8},
+            {"tile_overlap", 2}};
+  auto restorer = creator->Create(cfg);
+  Tensor img(TensorDesc{kHOST, DataType::kFLOAT, {1, 2, 12, 12}, "img"});
+  std::fill_n(img.data<float>(), img.size(), 0.f);
+  auto output = restorer->Process(Value::Array{Value{{"img", img}}});
+  REQUIRE(output.has_error());
+  REQUIRE(output.error() == eNotSupported);
+}
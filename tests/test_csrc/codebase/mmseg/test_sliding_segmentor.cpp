@@ -0,0 +1,229 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+// clang-format off
+#include "catch.hpp"
+// clang-format on
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "mmdeploy/core/module.h"
+#include "mmdeploy/core/registry.h"
+#include "mmdeploy/core/tensor.h"
+
+using namespace mmdeploy;
+
+namespace {
+
+constexpr const Device kHOST{0, 0};
+constexpr int kClasses = 5;
+
+// Channel 0 of the input is the label of the pixel, channels 1 & 2 are its x & y. The scores are
+// 1 for the label of the pixel, and 0.8 for the last class in the windows of the first column, so
+// that the result depends on the number of windows covering each pixel. With "test_labels" set,
+// the labels are output instead, the windows of the first column vote for the last class.
+//
+// The batches are completed in the reverse order of submission on threads of their own: a batch
+// is held until the next one is submitted, or for a while if there is none.
+class WindowNet : public Module {
+ public:
+  explicit WindowNet(const Value& cfg)
+      : labels_(cfg.value("test_labels", false)), shrink_(cfg.value("test_shrink", false)) {}
+
+  ~WindowNet() override {
+    for (auto& t : threads_) {
+      t.join();
+    }
+  }
+
+  Result<Value> Process(const Value& args) override {
+    Value::Array outputs;
+    for (const auto& sample : args[0]) {
+      auto img = sample["img"].get<Tensor>();
+      auto height = static_cast<int>(img.shape(2));
+      auto width = static_cast<int>(img.shape(3));
+      auto plane = static_cast<size_t>(height) * width;
+      auto src = img.data<float>();
+      bool first_column = src[plane] == 0.f;
+      auto out_h = shrink_ ? height - 1 : height;
+      if (labels_) {
+        Tensor output(TensorDesc{kHOST, DataType::kINT64, {1, 1, out_h, width}, "output"});
+        for (size_t i = 0; i < output.size(); ++i) {
+          output.data<int64_t>()[i] = first_column ? kClasses - 1 : static_cast<int64_t>(src[i]);
+        }
+        outputs.push_back({{"output", output}});
+      } else {
+        Tensor output(TensorDesc{kHOST, DataType::kFLOAT, {1, kClasses, out_h, width}, "output"});
+        auto dst = output.data<float>();
+        auto out_plane = static_cast<size_t>(out_h) * width;
+        std::fill_n(dst, output.size(), 0.f);
+        for (size_t i = 0; i < out_plane; ++i) {
+          dst[static_cast<int>(src[i]) * out_plane + i] += 1.f;
+          if (first_column) {
+            dst[(kClasses - 1) * out_plane + i] += .8f;
+          }
+        }
+        outputs.push_back({{"output", output}});
+      }
+    }
+    std::lock_guard lock{mutex_};
+    windows_ += static_cast<int>(outputs.size());
+    return Value(Value::Array{Value(std::move(outputs))});
+  }
+
+  void ProcessAsync(const Value& args, std::function<void(Result<Value>)> done) override {
+    std::lock_guard lock{mutex_};
+    if (held_) {
+      auto held = std::move(*held_);
+      held_.reset();
+      ++reordered_;
+      threads_.emplace_back([this, args, done = std::move(done), held = std::move(held)] {
+        done(Process(args));
+        held.done(Process(held.args));
+      });
+      return;
+    }
+    auto id = ++submitted_;
+    held_ = Job{id, args, std::move(done)};
+    threads_.emplace_back([this, id] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      std::unique_lock lock{mutex_};
+      if (held_ && held_->id == id) {
+        auto job = std::move(*held_);
+        held_.reset();
+        lock.unlock();
+        job.done(Process(job.args));
+      }
+    });
+  }
+
+  static inline int windows_{};
+  static inline int reordered_{};
+
+ private:
+  struct Job {
+    int id;
+    Value args;
+    std::function<void(Result<Value>)> done;
+  };
+
+  bool labels_;
+  bool shrink_;
+  std::mutex mutex_;
+  std::optional<Job> held_;
+  int submitted_{};
+  std::vector<std::thread> threads_;
+};
+
+class WindowNetCreator : public Creator<Module> {
+ public:
+  const char* GetName() const override { return "test_window_net"; }
+  int GetVersion() const override { return 0; }
+  std::unique_ptr<Module> Create(const Value& cfg) override {
+    return std::make_unique<WindowNet>(cfg);
+  }
+};
+
+REGISTER_MODULE(Module, WindowNetCreator);
+
+int Label(int x, int y) { return (x * 7 + y * 3) % 23 % kClasses; }
+
+// the windows along an axis, as in `slide_inference` of mmseg
+std::vector<int> Windows(int length, int crop, int stride) {
+  std::vector<int> offsets;
+  auto grids = std::max(length - crop + stride - 1, 0) / stride + 1;
+  for (int i = 0; i < grids; ++i) {
+    auto end = std::min(i * stride + crop, length);
+    offsets.push_back(std::max(end - crop, 0));
+  }
+  return offsets;
+}
+
+}  // namespace
+
+TEST_CASE("test sliding segmentor", "[mmseg]") {
+  auto creator = Registry<Module>::Get().GetCreator("SlidingSegmentor");
+  REQUIRE(creator);
+  auto labels = GENERATE(false, true);
+  // height, width, crop, stride, batch_size, max_in_flight
+  auto [height, width, crop, stride, batch_size, max_in_flight] =
+      GENERATE(std::make_tuple(37, 53, 16, 10, 3, 3), std::make_tuple(10, 12, 16, 8, 2, 2),
+               std::make_tuple(33, 17, 16, 16, 1, 1), std::make_tuple(40, 64, 24, 12, 1, 4));
+  Value cfg{{"context", {{"device", kHOST}, {"stream", Stream::GetDefault(kHOST)}}},
+            {"net", "test_window_net"},
+            {"crop_size", {crop, crop}},
+            {"stride", {stride, stride}},
+            {"num_classes", kClasses},
+            {"batch_size", batch_size},
+            {"max_in_flight", max_in_flight},
+            {"test_labels", labels}};
+  auto segmentor = creator->Create(cfg);
+  REQUIRE(segmentor);
+
+  Tensor img(TensorDesc{kHOST, DataType::kFLOAT, {1, 3, height, width}, "img"});
+  auto plane = static_cast<size_t>(height) * width;
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      auto i = static_cast<size_t>(y) * width + x;
+      img.data<float>()[i] = static_cast<float>(Label(x, y));
+      img.data<float>()[plane + i] = static_cast<float>(x);
+      img.data<float>()[2 * plane + i] = static_cast<float>(y);
+    }
+  }
+
+  // the reference scores of the windows
+  auto crop_h = std::min(crop, height);
+  auto crop_w = std::min(crop, width);
+  auto ys = Windows(height, crop_h, stride);
+  auto xs = Windows(width, crop_w, stride);
+  std::vector<float> scores(plane * kClasses);
+  for (auto top : ys) {
+    for (auto left : xs) {
+      for (int y = top; y < top + crop_h; ++y) {
+        for (int x = left; x < left + crop_w; ++x) {
+          auto s = scores.data() + (static_cast<size_t>(y) * width + x) * kClasses;
+          if (labels) {
+            s[left == 0 ? kClasses - 1 : Label(x, y)] += 1.f;
+          } else {
+            s[Label(x, y)] += 1.f;
+            s[kClasses - 1] += left == 0 ? .8f : 0.f;
+          }
+        }
+      }
+    }
+  }
+
+  SECTION("the windows are accumulated to the label map") {
+    WindowNet::windows_ = 0;
+    WindowNet::reordered_ = 0;
+    auto output = segmentor->Process(Value::Array{Value{{"img", img}}});
+    REQUIRE(output);
+    auto mask = output.value()[0]["output"].get<Tensor>();
+    REQUIRE(mask.shape() == TensorShape{1, 1, height, width});
+    REQUIRE(mask.data_type() == DataType::kINT32);
+    int mismatches = 0;
+    for (size_t i = 0; i < plane; ++i) {
+      auto s = scores.data() + i * kClasses;
+      mismatches += mask.data<int32_t>()[i] != std::max_element(s, s + kClasses) - s;
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(WindowNet::windows_ == static_cast<int>(ys.size() * xs.size()));
+    auto batches = (ys.size() * xs.size() + batch_size - 1) / batch_size;
+    if (max_in_flight > 1 && batches > 1) {
+      REQUIRE(WindowNet::reordered_ > 0);
+    }
+  }
+
+  SECTION("outputs of unexpected shapes are rejected") {
+    cfg["test_shrink"] = true;
+    auto shrinking = creator->Create(cfg);
+    auto output = shrinking->Process(Value::Array{Value{{"img", img}}});
+    REQUIRE(output.has_error());
+    REQUIRE(output.error() == eNotSupported);
+  }
+}
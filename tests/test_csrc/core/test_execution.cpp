@@ -1,6 +1,8 @@
 // Copyright (c) OpenMMLab. All rights reserved.
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <numeric>
 
 #include "catch.hpp"
@@ -14,6 +16,7 @@
 #include "mmdeploy/execution/schedulers/single_thread_context.h"
 #include "mmdeploy/execution/schedulers/static_thread_pool.h"
 #include "mmdeploy/execution/schedulers/timed_single_thread_context.h"
+#include "mmdeploy/execution/schedulers/work_stealing_thread_pool.h"
 #include "mmdeploy/execution/type_erased.h"
 #include "mmdeploy/execution/when_all_value.h"
 
@@ -230,8 +233,12 @@ struct _single_thread {
 struct _thread_pool {
   static constexpr const char* value = "ThreadPool";
 };
+struct _work_stealing_thread_pool {
+  static constexpr const char* value = "WorkStealingThreadPool";
+};
 
-using Schedulers = std::tuple<_inlined, _single_thread, _thread_pool>;
+using Schedulers =
+    std::tuple<_inlined, _single_thread, _thread_pool, _work_stealing_thread_pool>;
 
 TEMPLATE_LIST_TEST_CASE("test type erase", "[execution]", Schedulers) { TestFunc(TestType::value); }
 
@@ -315,6 +322,68 @@ TEST_CASE("test generic split", "[execution]") {
   MMDEPLOY_INFO("generic split: {} {} {}", z, y, x);
 }
 
+TEST_CASE("test type erased allocations", "[execution]") {
+  auto count_allocations = [](auto&& fn) {
+    TypeErasedAllocationCounter counter;
+    fn();
+    return counter.count();
+  };
+  int value{};
+  // `outer`, its operation & the receiver connected to `inner` hold type erased objects, which
+  // don't fit inline
+  auto run_nested = [&] {
+    TypeErasedSender<int> inner = Just(1);
+    TypeErasedSender<int> outer = Then(std::move(inner), [](int x) { return x + 1; });
+    std::tie(value) = SyncWait(std::move(outer));
+  };
+
+  SECTION("small senders & receivers are inline") {
+    auto allocations = count_allocations([&] {
+      TypeErasedSender<int> sender = Then(Just(1), [](int x) { return x + 1; });
+      auto copy = sender;
+      std::tie(value) = SyncWait(std::move(copy));
+    });
+    REQUIRE(value == 2);
+    // only the operation state, which is never inline
+    REQUIRE(allocations == 1);
+  }
+
+  SECTION("large states are allocated from the arena") {
+    constexpr int kRequests = 8;
+    auto heap = count_allocations([&] {
+      for (int i = 0; i < kRequests; ++i) {
+        run_nested();
+      }
+    });
+    REQUIRE(value == 2);
+    REQUIRE(heap >= kRequests);
+    auto arena = count_allocations([&] {
+      TypeErasedArena arena(1 << 16);
+      for (int i = 0; i < kRequests; ++i) {
+        run_nested();
+      }
+    });
+    REQUIRE(value == 2);
+    // the arena & a few blocks for all the requests
+    REQUIRE(arena <= 4);
+    REQUIRE(arena < heap);
+  }
+}
+
+TEST_CASE("test type erased operations are not relocated", "[execution]") {
+  // `WhenAll` moves the operations of its children, whose `LetValue` states point into themselves
+  std::vector<TypeErasedSender<Value>> senders;
+  for (int i = 0; i < 8; ++i) {
+    senders.emplace_back(
+        LetValue(Just(Value(i)), [](Value& v) { return Just(Value(v.get<int>() * 2)); }));
+  }
+  auto [values] = SyncWait(WhenAll(std::move(senders)));
+  REQUIRE(values.size() == 8);
+  for (int i = 0; i < 8; ++i) {
+    REQUIRE(values[i].get<int>() == i * 2);
+  }
+}
+
 TEST_CASE("test bulk", "[execution]") {
   //  __static_thread_pool::StaticThreadPool pool;
   _single_thread_context::SingleThreadContext ctx;
@@ -333,6 +402,141 @@ TEST_CASE("test bulk", "[execution]") {
   MMDEPLOY_INFO("{}", z);
 }
 
+TEST_CASE("test work stealing bulk", "[execution]") {
+  WorkStealingThreadPool pool(4);
+  auto scheduler = pool.GetScheduler();
+  constexpr int N = 4096;
+  constexpr int M = 64;
+  std::vector<int> v(N);
+  std::atomic<int> count{N / M};
+  std::mutex mutex;
+  std::condition_variable cv;
+  // inner bulks are started on workers and pushed onto their own deques
+  auto sender = Just() | Transfer(scheduler) | Bulk(N / M, [&](int i) {
+                  StartDetached(Just() | Transfer(scheduler) |
+                                Bulk(M, [&, i](int j) { v[i * M + j] = i * M + j; }) |
+                                Then([&] {
+                                  if (--count == 0) {
+                                    std::lock_guard lock{mutex};
+                                    cv.notify_one();
+                                  }
+                                }));
+                });
+  SyncWait(std::move(sender));
+  {
+    std::unique_lock lock{mutex};
+    cv.wait(lock, [&] { return count == 0; });
+  }
+  std::vector<int> expected(N);
+  std::iota(begin(expected), end(expected), 0);
+  REQUIRE(v == expected);
+}
+
+TEST_CASE("test work stealing bulk of any shape", "[execution]") {
+  WorkStealingThreadPool pool(4);
+  auto scheduler = pool.GetScheduler();
+  for (const auto n : {0, 1, 3, 17, 100, 4096}) {
+    std::vector<std::atomic<int>> visits(n);
+    auto sender = Just(std::vector<int>(n)) | Transfer(scheduler) |
+                  Bulk(n, [&](int i, std::vector<int>& v) {
+                    ++visits[i];
+                    v[i] = i;
+                  });
+    auto [v] = SyncWait(std::move(sender));
+    REQUIRE(v.size() == static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) {
+      REQUIRE(visits[i] == 1);
+      REQUIRE(v[i] == i);
+    }
+  }
+}
+
+TEST_CASE("test static thread pool bulk", "[execution]") {
+  const auto grain_size = GENERATE(0, 1, 7, 1000);
+  StaticThreadPool pool(4, grain_size);
+  auto scheduler = pool.GetScheduler();
+  for (const auto n : {0, 1, 3, 100, 4096}) {
+    std::vector<std::atomic<int>> visits(n);
+    auto sender = Just(std::vector<int>(n)) | Transfer(scheduler) |
+                  Bulk(n, [&](int i, std::vector<int>& v) {
+                    ++visits[i];
+                    v[i] = i;
+                  });
+    auto [v] = SyncWait(std::move(sender));
+    REQUIRE(v.size() == static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) {
+      REQUIRE(visits[i] == 1);
+      REQUIRE(v[i] == i);
+    }
+  }
+}
+
+template <typename Pool>
+void BenchmarkThreadPool(const char* name, Pool& pool, int num_tasks, int fan_out) {
+  using clock = std::chrono::steady_clock;
+  auto scheduler = pool.GetScheduler();
+  std::vector<double> latency(num_tasks * fan_out);
+  std::atomic<int> count{num_tasks * fan_out};
+  std::mutex mutex;
+  std::condition_variable cv;
+  auto t0 = clock::now();
+  for (int i = 0; i < num_tasks; ++i) {
+    auto submit = clock::now();
+    StartDetached(Just() | Transfer(scheduler) | Bulk(fan_out, [&, i, submit](int j) {
+                    latency[i * fan_out + j] =
+                        std::chrono::duration<double, std::micro>(clock::now() - submit).count();
+                    if (--count == 0) {
+                      std::lock_guard lock{mutex};
+                      cv.notify_one();
+                    }
+                  }));
+  }
+  {
+    std::unique_lock lock{mutex};
+    cv.wait(lock, [&] { return count == 0; });
+  }
+  auto dt = std::chrono::duration<double>(clock::now() - t0).count();
+  std::sort(begin(latency), end(latency));
+  auto percentile = [&](double p) { return latency[size_t(p * (latency.size() - 1))]; };
+  MMDEPLOY_INFO("{}: fan-out {}, {:.0f} tasks/s, latency (us) p50 {:.1f}, p99 {:.1f}, max {:.1f}",
+                name, fan_out, latency.size() / dt, percentile(.5), percentile(.99),
+                latency.back());
+}
+
+TEST_CASE("benchmark thread pools", "[.][benchmark][execution]") {
+  const auto num_threads = std::max(1U, std::thread::hardware_concurrency());
+  for (const auto fan_out : {1, 64}) {
+    {
+      StaticThreadPool pool(num_threads);
+      BenchmarkThreadPool("StaticThreadPool", pool, 100000 / fan_out, fan_out);
+    }
+    {
+      WorkStealingThreadPool pool(num_threads);
+      BenchmarkThreadPool("WorkStealingThreadPool", pool, 100000 / fan_out, fan_out);
+    }
+  }
+}
+
+TEST_CASE("benchmark bulk", "[.][benchmark][execution]") {
+  using clock = std::chrono::steady_clock;
+  const auto num_threads = std::max(1U, std::thread::hardware_concurrency());
+  for (const auto grain_size : {0, 1}) {
+    StaticThreadPool pool(num_threads, grain_size);
+    auto scheduler = pool.GetScheduler();
+    for (const auto shape : {64, 1 << 20}) {
+      const auto rounds = std::max(1, (1 << 24) / shape);
+      std::vector<float> v(shape);
+      auto t0 = clock::now();
+      for (int i = 0; i < rounds; ++i) {
+        SyncWait(Just() | Transfer(scheduler) | Bulk(shape, [&](int j) { v[j] += 1.f; }));
+      }
+      auto dt = std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+      MMDEPLOY_INFO("StaticThreadPool bulk: grain size {}, shape {}, {:.2f} ns/element", grain_size,
+                    shape, dt / rounds / shape);
+    }
+  }
+}
+
 TEST_CASE("test schedule_after", "[execution]") {
   TimedSingleThreadContext context;
   auto sched = context.GetScheduler();
@@ -397,8 +601,7 @@ TEST_CASE("test dynamic batch", "[execution]") {
 
   MMDEPLOY_INFO("waiting starts...");
   for (auto& s : senders) {
-    auto [v] = SyncWait(std::move(s));
-    // MMDEPLOY_INFO("val: {}", v);
+    SyncWait(std::move(s));
   }
 }
 
@@ -452,3 +655,103 @@ TEST_CASE("test dynamic batch for Value", "[execution]") {
   mmdeploy_scheduler_destroy(dynamic_batch_sched);
   mmdeploy_scheduler_destroy(exec_sched);
 }
+
+TEST_CASE("test adaptive dynamic batch policy", "[execution]") {
+  using namespace std::chrono;
+  DynamicBatchPolicy policy(8, milliseconds(10), milliseconds(5));
+  REQUIRE(policy.adaptive());
+  // no measurement yet
+  REQUIRE(policy.GetTimeout(1) == milliseconds(10));
+
+  DynamicBatchPolicy::clock_t::time_point t{};
+  for (int i = 1; i <= 4; ++i) {
+    policy.OnRequest(1, t + microseconds(100 * i));
+  }
+  policy.OnExecute(milliseconds(1));
+  // 7 more requests expected in 700us, well within the budget of 5ms - 1ms
+  REQUIRE(policy.GetTimeout(1) == microseconds(700));
+
+  // a request every 10ms, waiting won't help
+  DynamicBatchPolicy slow(8, milliseconds(10), milliseconds(5));
+  slow.OnRequest(1, t + milliseconds(10));
+  slow.OnRequest(1, t + milliseconds(20));
+  REQUIRE(slow.GetTimeout(1) == microseconds(0));
+
+  slow.OnSubmit(1, false, microseconds(0));
+  slow.OnSubmit(8, true, microseconds(300));
+  auto stats = slow.GetStats();
+  REQUIRE(stats.batch_count == 2);
+  REQUIRE(stats.full_submits == 1);
+  REQUIRE(stats.timeouts == 1);
+  REQUIRE(stats.batch_size_histogram[1] == 1);
+  REQUIRE(stats.batch_size_histogram[8] == 1);
+  REQUIRE(stats.wait_time == 300.);
+  REQUIRE(stats.request_interval == 10000.);
+}
+
+TEST_CASE("test dynamic batch policy group", "[execution]") {
+  using namespace std::chrono;
+  auto group = std::make_shared<DynamicBatchPolicyGroup>(8, milliseconds(10), milliseconds(5));
+  auto fast = group->Create();
+  auto slow = group->Create();
+
+  DynamicBatchPolicy::clock_t::time_point t{};
+  for (int i = 1; i <= 4; ++i) {
+    fast->OnRequest(1, t + microseconds(100 * i));
+    slow->OnRequest(1, t + milliseconds(10 * i));
+  }
+  // each context adapts to its own load
+  REQUIRE(fast->GetTimeout(1) == microseconds(700));
+  REQUIRE(slow->GetTimeout(1) == microseconds(0));
+
+  fast->OnSubmit(8, true, microseconds(700));
+  slow->OnSubmit(1, false, microseconds(0));
+  auto stats = group->GetStats();
+  REQUIRE(stats.batch_count == 2);
+  REQUIRE(stats.full_submits == 1);
+  REQUIRE(stats.timeouts == 1);
+  REQUIRE(stats.request_interval == (100. + 10000.) / 2);
+
+  // counters of the destroyed policies are kept
+  fast.reset();
+  stats = group->GetStats();
+  REQUIRE(stats.batch_count == 2);
+  REQUIRE(stats.batch_size_histogram[8] == 1);
+  REQUIRE(stats.request_interval == 10000.);
+}
+
+TEST_CASE("test dynamic batch stats C API", "[execution]") {
+  auto exec_sched = mmdeploy_executor_create_thread();
+  auto dynamic_batch_sched = mmdeploy_executor_adaptive_dynamic_batch(exec_sched, 4, 1000, 500);
+  REQUIRE(dynamic_batch_sched);
+  auto& scheduler = *reinterpret_cast<TypeErasedScheduler<Value>*>(dynamic_batch_sched);
+
+  constexpr const int N = 8;
+  dynamic_batch_t::context_t context;
+  std::vector<TypeErasedSender<Value>> senders;
+  for (int i = 0; i < N; ++i) {
+    auto begin = TransferJust(scheduler, Value{Value::Array{i}});
+    senders.emplace_back(EnsureStarted(
+        DynamicBatch(std::move(begin), context, [](Value x) { return x; })));
+  }
+  for (auto& s : senders) {
+    SyncWait(std::move(s));
+  }
+
+  mmdeploy_value_t stats{};
+  REQUIRE(mmdeploy_executor_dynamic_batch_stats(dynamic_batch_sched, &stats) == 0);
+  auto& value = *reinterpret_cast<Value*>(stats);
+  auto batch_count = value["batch_count"].get<int>();
+  REQUIRE(batch_count == value["full_submits"].get<int>() + value["timeouts"].get<int>());
+  int count = 0;
+  for (int i = 0; i < static_cast<int>(value["batch_size_histogram"].size()); ++i) {
+    count += i * value["batch_size_histogram"][i].get<int>();
+  }
+  REQUIRE(count == N);
+  mmdeploy_value_destroy(stats);
+
+  REQUIRE(mmdeploy_executor_dynamic_batch_stats(exec_sched, &stats) != 0);
+
+  mmdeploy_scheduler_destroy(dynamic_batch_sched);
+  mmdeploy_scheduler_destroy(exec_sched);
+}
@@ -1,5 +1,9 @@
 // Copyright (c) OpenMMLab. All rights reserved.
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "catch.hpp"
 #include "json.hpp"
 #include "mmdeploy/core/logger.h"
@@ -345,6 +349,247 @@ TEST_CASE("test speed of value", "[value]") {
   MMDEPLOY_INFO("time = {}ms", (float)dt);
 }
 
+TEST_CASE("test interned keys of value", "[value]") {
+  ValueKey a("img_metas");
+  ValueKey b(std::string("img_metas"));
+  REQUIRE(a == b);
+  REQUIRE(&a.str() == &b.str());
+  REQUIRE(a != ValueKey("img_shape"));
+  REQUIRE(a == "img_metas");
+  REQUIRE(ValueKey() == "");
+
+  Value v;
+  v["b"] = 1;
+  v[ValueKey("c")] = 2;
+  v[std::string("a")] = 0;
+  REQUIRE(v[a].is_null());
+  REQUIRE(v.size() == 4);
+  // iterated in the order of the keys, as `std::map` does
+  std::string keys;
+  for (auto it = v.begin(); it != v.end(); ++it) {
+    keys += it.key();
+  }
+  REQUIRE(keys == "abcimg_metas");
+
+  // missing keys are not inserted by const access
+  const auto& u = v;
+  REQUIRE(u["x"].is_null());
+  REQUIRE(!v.contains("x"));
+  REQUIRE_THROWS_AS(v.object().at("x"), std::out_of_range);
+  REQUIRE(v.object().erase("a") == 1);
+  REQUIRE(v.value("b", 0) == 1);
+
+  // long keys are not interned and own their strings
+  std::string path(100, 'x');
+  ValueKey c(path);
+  ValueKey d(path);
+  REQUIRE(c == d);
+  REQUIRE(&c.str() != &d.str());
+  REQUIRE(c != ValueKey(path + "y"));
+  REQUIRE(c != a);
+  REQUIRE(!(c < d));
+  REQUIRE(!(d < c));
+  v[c] = 3;
+  v[path + "y"] = 4;
+  REQUIRE(v[d].get<int>() == 3);
+  REQUIRE(u.value(path, 0) == 3);
+  REQUIRE(v.object().erase(path) == 1);
+  REQUIRE(!v.contains(c));
+  REQUIRE(v.contains(path + "y"));
+}
+
+// compares lookups & copies of a typical meta object with the `std::map` based storage
+TEST_CASE("test speed of value object", "[value]") {
+  constexpr auto kCount = 100000;
+  const std::vector<std::string> keys{"ori_img", "img", "img_shape", "ori_shape", "pad_shape",
+                                      "scale_factor", "flip", "flip_direction", "img_norm_cfg",
+                                      "valid_ratio", "filename", "ori_filename"};
+  Value flat;
+  std::map<std::string, Value> tree;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    flat[keys[i]] = i;
+    tree[keys[i]] = i;
+  }
+  auto measure = [](auto&& f) {
+    auto t0 = std::chrono::high_resolution_clock::now();
+    auto ret = f();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    return std::make_pair(std::chrono::duration<double, std::milli>(t1 - t0).count(), ret);
+  };
+
+  // keys of the same length as others (e.g. "img_shape"), whose string compares can't return early
+  auto [flat_lookup, flat_sum] = measure([&] {
+    int64_t sum = 0;
+    for (int i = 0; i < kCount; ++i) {
+      sum += flat["ori_shape"].get<int64_t>() + flat["pad_shape"].get<int64_t>();
+    }
+    return sum;
+  });
+  auto [key_lookup, key_sum] = measure([&] {
+    static const ValueKey kOriShape{"ori_shape"};
+    static const ValueKey kPadShape{"pad_shape"};
+    int64_t sum = 0;
+    for (int i = 0; i < kCount; ++i) {
+      sum += flat[kOriShape].get<int64_t>() + flat[kPadShape].get<int64_t>();
+    }
+    return sum;
+  });
+  auto [tree_lookup, tree_sum] = measure([&] {
+    int64_t sum = 0;
+    for (int i = 0; i < kCount; ++i) {
+      sum += tree["ori_shape"].get<int64_t>() + tree["pad_shape"].get<int64_t>();
+    }
+    return sum;
+  });
+  REQUIRE(flat_sum == tree_sum);
+  REQUIRE(key_sum == tree_sum);
+
+  auto [flat_copy, flat_size] = measure([&] {
+    size_t size = 0;
+    for (int i = 0; i < kCount; ++i) {
+      Value copy = flat;
+      size += copy.size();
+    }
+    return size;
+  });
+  auto [tree_copy, tree_size] = measure([&] {
+    size_t size = 0;
+    for (int i = 0; i < kCount; ++i) {
+      auto copy = tree;
+      size += copy.size();
+    }
+    return size;
+  });
+  REQUIRE(flat_size == tree_size);
+
+  MMDEPLOY_INFO(
+      "lookup: {}ms, {}ms by ValueKey vs {}ms (std::map), copy: {}ms vs {}ms (std::map)",
+      (float)flat_lookup, (float)key_lookup, (float)tree_lookup, (float)flat_copy,
+      (float)tree_copy);
+}
+
+TEST_CASE("test lookups by value key", "[value]") {
+  const std::string long_key(100, 'x');
+  Value v{{"img_shape", 1}, {long_key, 2}};
+  ValueKey img_shape{"img_shape"};
+  ValueKey long_value_key{long_key};
+  REQUIRE(img_shape.interned());
+  // too long to be interned, compared by content
+  REQUIRE_FALSE(long_value_key.interned());
+  REQUIRE(v[img_shape].get<int>() == 1);
+  REQUIRE(v[long_value_key].get<int>() == 2);
+  REQUIRE_FALSE(v.contains(ValueKey{"pad_shape"}));
+}
+
+TEST_CASE("test copies of value are independent", "[value]") {
+  Value v{{"a", 0}, {"b", Value::Array{1, 2, 3}}};
+  SECTION("modifying through a reference obtained after copying") {
+    v["a"] = 1;
+    Value w = v;
+    auto& x = v["a"];
+    x = 2;
+    REQUIRE(v["a"].get<int>() == 2);
+    REQUIRE(w["a"].get<int>() == 1);
+  }
+  SECTION("concurrent non-const access to the elements of a copied value") {
+    Value w = v;
+    auto& array = w["b"];
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; ++i) {
+      threads.emplace_back([&array, i] { array[i] = array[i].get<int>() * 10; });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    REQUIRE(w["b"][2].get<int>() == 30);
+    REQUIRE(v["b"][2].get<int>() == 3);
+  }
+  SECTION("modifying through native references of a copy") {
+    Value w = v;
+    w["b"].get_ref<Value::Array&>().push_back(4);
+    REQUIRE(w["b"].size() == 4);
+    REQUIRE(v["b"].size() == 3);
+  }
+  SECTION("moving out of a copy") {
+    Value w = v;
+    auto b = std::move(w["b"]);
+    REQUIRE(b.size() == 3);
+    REQUIRE(w["b"].is_null());
+    REQUIRE(v["b"].size() == 3);
+  }
+}
+
+TEST_CASE("test copy-on-write of value", "[value]") {
+  Value a{{"img", Value::Array{1, 2, 3}}, {"img_metas", {{"ori_shape", Value::Array{1, 3, 4, 4}}}}};
+  const auto& ca = a;
+  Value b = ca;
+  const auto& cb = b;
+  REQUIRE(&ca.object() == &cb.object());
+
+  SECTION("modifying a copy") {
+    b["img_metas"]["ori_shape"][0] = 2;
+    b.update({{"flip", false}});
+    REQUIRE(&ca.object() != &cb.object());
+    // the untouched sub-trees are still shared
+    REQUIRE(&ca["img"].array() == &cb["img"].array());
+    REQUIRE(ca["img_metas"]["ori_shape"][0].get<int>() == 1);
+    REQUIRE(cb["img_metas"]["ori_shape"][0].get<int>() == 2);
+    REQUIRE(!ca.contains("flip"));
+  }
+
+  SECTION("copies of a modified value") {
+    b["flip"] = false;
+    b["img_metas"]["ori_shape"][0] = 2;
+    Value c = cb;
+    Value d = cb;
+    const auto& cc = c;
+    const auto& cd = d;
+    // the mutable accesses to `b` ended with the copy, the storage is shared again
+    REQUIRE(&cb.object() == &cc.object());
+    REQUIRE(&cb.object() == &cd.object());
+    REQUIRE(&cb["img_metas"].object() == &cc["img_metas"].object());
+    // until one of the copies is modified
+    c["flip"] = true;
+    REQUIRE(&cb.object() != &cc.object());
+    REQUIRE(&cb["img"].array() == &cc["img"].array());
+    REQUIRE_FALSE(cb["flip"].get<bool>());
+    REQUIRE_FALSE(cd["flip"].get<bool>());
+  }
+
+  SECTION("concurrent readers while a copy is modified") {
+    constexpr int kRounds = 1000;
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    std::atomic<int> mismatches{0};
+    for (int i = 0; i < 4; ++i) {
+      readers.emplace_back([&] {
+        while (!done.load()) {
+          Value copy = ca;
+          const auto& shape = copy["img_metas"]["ori_shape"];
+          if (shape[0].get<int>() != 1 || ca["img"].size() != 3) {
+            ++mismatches;
+          }
+        }
+      });
+    }
+    for (int i = 0; i < kRounds; ++i) {
+      Value c = ca;
+      c["img_metas"]["ori_shape"][0] = i + 2;
+      c["img"].push_back(i);
+      b = c;
+      b["img"][0] = i;
+    }
+    done = true;
+    for (auto& t : readers) {
+      t.join();
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(ca["img_metas"]["ori_shape"][0].get<int>() == 1);
+    REQUIRE(cb["img_metas"]["ori_shape"][0].get<int>() == kRounds + 1);
+    REQUIRE(cb["img"].size() == 4);
+  }
+}
+
 TEST_CASE("test ctor of value", "[value]") {
   static_assert(!std::is_constructible<Value, void (*)(int)>::value, "");
   static_assert(!std::is_constructible<Value, int*>::value, "");
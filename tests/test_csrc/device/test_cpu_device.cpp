@@ -6,6 +6,9 @@
 
 #include "catch.hpp"
 #include "mmdeploy/core/device.h"
+#include "mmdeploy/core/device_impl.h"
+#include "mmdeploy/core/value.h"
+#include "mmdeploy/device/device_allocator.h"
 
 using namespace mmdeploy;
 using namespace std::string_literals;
@@ -38,3 +41,98 @@ TEST_CASE("test buffer", "[buffer]") {
     REQUIRE(src == dst);
   }
 }
+
+TEST_CASE("test cpu arena allocator", "[buffer]") {
+  using namespace mmdeploy;
+  Device device{"cpu"};
+  Allocator allocator(device, Value{{"type", "arena"}, {"max_cached_bytes", 1 << 24}});
+  REQUIRE(allocator);
+  auto& arena = dynamic_cast<device_allocator::Arena&>(Access::get<AllocatorImpl>(allocator));
+
+  auto run = [&] {
+    std::vector<Buffer> buffers;
+    for (auto size : {16, 1000, 4096, 70000, 1 << 20, 3 << 20}) {
+      buffers.emplace_back(device, size, allocator);
+      REQUIRE(buffers.back().GetNative());
+      REQUIRE(buffers.back().GetSize() == size);
+      REQUIRE(buffers.back().GetAllocator());
+    }
+  };
+
+  run();
+  auto upstream = arena.upstream();
+  REQUIRE(upstream.allocation_count == 6);
+  // freed blocks are cached & reused, no more allocations in steady state
+  for (int i = 0; i < 3; ++i) {
+    run();
+  }
+  REQUIRE(arena.upstream().allocation_count == upstream.allocation_count);
+  REQUIRE(arena.requested().allocation_count == 24);
+
+  SECTION("stats") {
+    auto stats = allocator.GetStats();
+    REQUIRE(stats);
+    REQUIRE(stats.value().allocation_count == 24);
+    REQUIRE(stats.value().upstream_allocation_count == 6);
+    REQUIRE(stats.value().hit_rate() == Approx(.75));
+    // all the buffers are freed & cached
+    REQUIRE(stats.value().in_use_bytes == 0);
+    REQUIRE(stats.value().cached_bytes >= 16 + 1000 + 4096 + 70000 + (1 << 20) + (3 << 20));
+    REQUIRE(stats.value().peak_bytes >= stats.value().cached_bytes);
+    Buffer buffer(device, 4096, allocator);
+    REQUIRE(allocator.GetStats().value().in_use_bytes >= 4096);
+    REQUIRE(allocator.GetStats().value().cached_bytes < stats.value().cached_bytes);
+    REQUIRE(allocator.GetStats().value().upstream_allocation_count == 6);
+  }
+
+  SECTION("concurrent allocations") {
+    Allocator shared(device, Value{{"type", "arena"}, {"max_cached_bytes", 1 << 26}});
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+      threads.emplace_back([&] {
+        for (int j = 0; j < 100; ++j) {
+          std::vector<Buffer> buffers;
+          for (auto size : {16, 1000, 4096, 70000, 1 << 20, 3 << 20}) {
+            buffers.emplace_back(device, size, shared);
+          }
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    auto stats = shared.GetStats().value();
+    REQUIRE(stats.allocation_count == 4 * 100 * 6);
+    REQUIRE(stats.in_use_bytes == 0);
+    // each thread holds at most one set of the buffers at a time
+    REQUIRE(stats.upstream_allocation_count <= 4 * 6);
+  }
+
+  SECTION("small buffers") {
+    auto in_use = allocator.GetStats().value().in_use_bytes;
+    Buffer buffer(device, 16, allocator);
+    // served by the finest pools instead of being rounded up to a page
+    REQUIRE(allocator.GetStats().value().in_use_bytes - in_use < 64);
+  }
+
+  SECTION("default allocator") {
+    Buffer buffer(device, 1024);
+    REQUIRE(buffer.GetAllocator());
+    // the arena is opt-in, the default allocator doesn't cache
+    auto& impl = Access::get<AllocatorImpl>(buffer.GetAllocator());
+    REQUIRE_FALSE(dynamic_cast<device_allocator::Arena*>(&impl));
+    auto stats = buffer.GetAllocator().GetStats();
+    REQUIRE(stats);
+    REQUIRE(stats.value().in_use_bytes >= 1024);
+    REQUIRE(stats.value().hit_rate() == 0.);
+  }
+
+  SECTION("invalid arena options") {
+    REQUIRE_THROWS(Allocator(device, Value{{"type", "arena"}, {"tiny_step", 100}}));
+    REQUIRE_THROWS(Allocator(device, Value{{"type", "arena"}, {"small_size", 1 << 12}}));
+  }
+
+  SECTION("unsupported allocator") {
+    REQUIRE_THROWS(Allocator(device, Value{{"type", "unknown"}}));
+  }
+}
@@ -0,0 +1,583 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+// clang-format off
+#include "catch.hpp"
+// clang-format on
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "mmdeploy/apis/c/mmdeploy/executor.h"
+#include "mmdeploy/apis/c/mmdeploy/pipeline.h"
+#include "mmdeploy/archive/json_archive.h"
+#include "mmdeploy/core/module.h"
+#include "mmdeploy/core/profiler.h"
+#include "mmdeploy/core/streaming.h"
+#include "mmdeploy/core/utils/filesystem.h"
+#include "mmdeploy/execution/schedulers/registry.h"
+#include "mmdeploy/graph/common.h"
+#include "mmdeploy/graph/pipeline.h"
+
+using namespace mmdeploy;
+
+namespace {
+
+// waits (for a limited time) until 2 instances are running at the same time
+class RendezvousModule : public Module {
+ public:
+  static void Reset(std::thread::id caller) {
+    std::lock_guard lock{mutex_};
+    arrived_ = 0;
+    caller_ = caller;
+  }
+
+  Result<Value> Process(const Value& args) override {
+    std::unique_lock lock{mutex_};
+    ++arrived_;
+    cv_.notify_all();
+    auto met = cv_.wait_for(lock, std::chrono::milliseconds(200), [] { return arrived_ >= 2; });
+    return Value{Value{{"value", args[0]["value"].get<int>() + 1},
+                       {"met", met},
+                       {"off_caller", std::this_thread::get_id() != caller_}}};
+  }
+
+ private:
+  static inline std::mutex mutex_;
+  static inline std::condition_variable cv_;
+  static inline int arrived_{};
+  static inline std::thread::id caller_;
+};
+
+class RendezvousModuleCreator : public Creator<Module> {
+ public:
+  const char* GetName() const override { return "test_rendezvous"; }
+  int GetVersion() const override { return 0; }
+  std::unique_ptr<Module> Create(const Value&) override {
+    return std::make_unique<RendezvousModule>();
+  }
+};
+
+REGISTER_MODULE(Module, RendezvousModuleCreator);
+
+class SumModule : public Module {
+ public:
+  Result<Value> Process(const Value& args) override {
+    return Value{Value{{"value", args[0]["value"].get<int>() + args[1]["value"].get<int>()}}};
+  }
+};
+
+class SumModuleCreator : public Creator<Module> {
+ public:
+  const char* GetName() const override { return "test_sum"; }
+  int GetVersion() const override { return 0; }
+  std::unique_ptr<Module> Create(const Value&) override { return std::make_unique<SumModule>(); }
+};
+
+REGISTER_MODULE(Module, SumModuleCreator);
+
+// fails for negative values
+class FailNegativeModule : public Module {
+ public:
+  Result<Value> Process(const Value& args) override {
+    if (args[0]["value"].get<int>() < 0) {
+      return Status(eInvalidArgument);
+    }
+    return Value{args[0]};
+  }
+};
+
+class FailNegativeModuleCreator : public Creator<Module> {
+ public:
+  const char* GetName() const override { return "test_fail_negative"; }
+  int GetVersion() const override { return 0; }
+  std::unique_ptr<Module> Create(const Value&) override {
+    return std::make_unique<FailNegativeModule>();
+  }
+};
+
+REGISTER_MODULE(Module, FailNegativeModuleCreator);
+
+// sleeps for a while depending on the input, so that the frames of a stream complete out of order
+class DelayModule : public Module {
+ public:
+  Result<Value> Process(const Value& args) override {
+    auto value = args[0]["value"].get<int>();
+    std::this_thread::sleep_for(std::chrono::milliseconds((3 - value % 3) * 5));
+    return Value{Value{{"value", value * 2}}};
+  }
+};
+
+class DelayModuleCreator : public Creator<Module> {
+ public:
+  const char* GetName() const override { return "test_delay"; }
+  int GetVersion() const override { return 0; }
+  std::unique_ptr<Module> Create(const Value&) override { return std::make_unique<DelayModule>(); }
+};
+
+REGISTER_MODULE(Module, DelayModuleCreator);
+
+// fails on a thread of its own, as a backend completing the inference
+class FailAsyncModule : public Module {
+ public:
+  ~FailAsyncModule() override {
+    for (auto& t : threads_) {
+      t.join();
+    }
+  }
+  Result<Value> Process(const Value&) override { return Status(eFail); }
+  void ProcessAsync(const Value&, std::function<void(Result<Value>)> done) override {
+    std::lock_guard lock{mutex_};
+    threads_.emplace_back([done = std::move(done)] { done(Status(eInvalidArgument)); });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::thread> threads_;
+};
+
+class FailAsyncModuleCreator : public Creator<Module> {
+ public:
+  const char* GetName() const override { return "test_fail_async"; }
+  int GetVersion() const override { return 0; }
+  std::unique_ptr<Module> Create(const Value&) override {
+    return std::make_unique<FailAsyncModule>();
+  }
+};
+
+REGISTER_MODULE(Module, FailAsyncModuleCreator);
+
+// throws an exception of the standard library while starting, as a module running out of memory
+class ThrowAsyncModule : public Module {
+ public:
+  Result<Value> Process(const Value&) override { return Status(eFail); }
+  void ProcessAsync(const Value&, std::function<void(Result<Value>)>) override {
+    throw std::runtime_error("out of memory");
+  }
+};
+
+class ThrowAsyncModuleCreator : public Creator<Module> {
+ public:
+  const char* GetName() const override { return "test_throw_async"; }
+  int GetVersion() const override { return 0; }
+  std::unique_ptr<Module> Create(const Value&) override {
+    return std::make_unique<ThrowAsyncModule>();
+  }
+};
+
+REGISTER_MODULE(Module, ThrowAsyncModuleCreator);
+
+// completes on a thread of its own after a while, counting the executions in progress
+class SlowAsyncModule : public Module {
+ public:
+  ~SlowAsyncModule() override {
+    for (auto& t : threads_) {
+      t.join();
+    }
+  }
+  Result<Value> Process(const Value& args) override { return Value{args[0]}; }
+  void ProcessAsync(const Value& args, std::function<void(Result<Value>)> done) override {
+    auto n = ++running;
+    auto m = max_running.load();
+    while (m < n && !max_running.compare_exchange_weak(m, n)) {
+    }
+    std::lock_guard lock{mutex_};
+    threads_.emplace_back([this, args, done = std::move(done)] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      --running;
+      done(Process(args));
+    });
+  }
+
+  static inline std::atomic_int running{0};
+  static inline std::atomic_int max_running{0};
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::thread> threads_;
+};
+
+class SlowAsyncModuleCreator : public Creator<Module> {
+ public:
+  const char* GetName() const override { return "test_slow_async"; }
+  int GetVersion() const override { return 0; }
+  std::unique_ptr<Module> Create(const Value&) override {
+    return std::make_unique<SlowAsyncModule>();
+  }
+};
+
+REGISTER_MODULE(Module, SlowAsyncModuleCreator);
+
+// x -> a, x -> b, (a, b) -> c
+Value CreateDiamondConfig() {
+  auto task = [](const char* name, const char* module, Value::Array inputs) {
+    return Value{{"name", name},
+                 {"type", "Task"},
+                 {"module", module},
+                 {"input", std::move(inputs)},
+                 {"output", Value::Array{name}}};
+  };
+  return Value{{"pipeline",
+                {{"input", Value::Array{"x"}},
+                 {"output", Value::Array{"a", "b", "c"}},
+                 {"tasks", Value::Array{task("a", "test_rendezvous", {"x"}),
+                                        task("b", "test_rendezvous", {"x"}),
+                                        task("c", "test_sum", {"a", "b"})}}}}};
+}
+
+Value Run(graph::Node& pipeline) {
+  RendezvousModule::Reset(std::this_thread::get_id());
+  Value input = Value::Array{Value{{"value", 1}}};
+  auto [output] = SyncWait(pipeline.Process(Just(std::move(input))));
+  return output;
+}
+
+}  // namespace
+
+TEST_CASE("test pipeline dataflow parallelism", "[graph]") {
+  auto creator = Registry<graph::Node>::Get().GetCreator("Pipeline");
+  REQUIRE(creator);
+  auto config = CreateDiamondConfig();
+
+  SECTION("independent nodes are started on the thread pool") {
+    auto pipeline = creator->Create(config);
+    REQUIRE(pipeline);
+    auto output = Run(*pipeline);
+    REQUIRE(output[0]["off_caller"].get<bool>());
+    REQUIRE(output[1]["off_caller"].get<bool>());
+    REQUIRE(output[2]["value"].get<int>() == 4);
+  }
+
+  SECTION("bounded per-node concurrency") {
+    auto& tasks = config["pipeline"]["tasks"];
+    tasks[0]["max_concurrency"] = 1;
+    tasks[1]["max_concurrency"] = 1;
+    auto pipeline = creator->Create(config);
+    REQUIRE(pipeline);
+    auto output = Run(*pipeline);
+    // each branch has a thread of its own, so they meet regardless of the number of cores
+    REQUIRE(output[0]["met"].get<bool>());
+    REQUIRE(output[1]["met"].get<bool>());
+    REQUIRE(output[2]["value"].get<int>() == 4);
+  }
+
+  SECTION("sequential execution") {
+    config["pipeline"]["parallel"] = false;
+    auto pipeline = creator->Create(config);
+    REQUIRE(pipeline);
+    auto output = Run(*pipeline);
+    REQUIRE_FALSE(output[0]["off_caller"].get<bool>());
+    REQUIRE_FALSE(output[0]["met"].get<bool>());
+    REQUIRE(output[2]["value"].get<int>() == 4);
+  }
+}
+
+TEST_CASE("test pipeline bounded concurrency of async node", "[graph]") {
+  auto creator = Registry<graph::Node>::Get().GetCreator("Pipeline");
+  REQUIRE(creator);
+  Value config{{"pipeline",
+                {{"input", Value::Array{"x"}},
+                 {"output", Value::Array{"y"}},
+                 {"tasks", Value::Array{Value{{"name", "slow"},
+                                              {"type", "Task"},
+                                              {"module", "test_slow_async"},
+                                              {"max_concurrency", 2},
+                                              {"input", Value::Array{"x"}},
+                                              {"output", Value::Array{"y"}}}}}}}};
+  auto pipeline = creator->Create(config);
+  REQUIRE(pipeline);
+  SlowAsyncModule::max_running = 0;
+  // the requests are released by the module before they complete
+  std::vector<std::thread> threads;
+  std::atomic_int completed{0};
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&, i] {
+      auto [output] = SyncWait(pipeline->Process(Just(Value(Value::Array{Value{{"value", i}}}))));
+      completed += output[0]["value"].get<int>() == i;
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  REQUIRE(completed == 8);
+  REQUIRE(SlowAsyncModule::max_running <= 2);
+}
+
+TEST_CASE("test pipeline bounded node failing", "[graph]") {
+  auto creator = Registry<graph::Node>::Get().GetCreator("Pipeline");
+  REQUIRE(creator);
+  constexpr int kMaxConcurrency = 2;
+  Value config{{"pipeline",
+                {{"input", Value::Array{"x"}},
+                 {"output", Value::Array{"y"}},
+                 {"tasks", Value::Array{Value{{"name", "fail"},
+                                              {"type", "Task"},
+                                              {"module", "test_fail_negative"},
+                                              {"max_concurrency", kMaxConcurrency},
+                                              {"input", Value::Array{"x"}},
+                                              {"output", Value::Array{"y"}}}}}}}};
+  auto pipeline = creator->Create(config);
+  REQUIRE(pipeline);
+
+  // a batch of samples is run by the bulk of the task, a single sample by the module's callback
+  auto sample = [](int value) { return Value{{"value", value}}; };
+  for (auto batch : {true, false}) {
+    auto input = [&](int value) {
+      return batch ? Value(Value::Array{Value::Array{sample(value)}})
+                   : Value(Value::Array{sample(value)});
+    };
+    for (int i = 0; i < kMaxConcurrency + 1; ++i) {
+      auto [output] = SyncWait(pipeline->Process(Just(input(-1))));
+      auto error = graph::FindError(output);
+      REQUIRE(error);
+      REQUIRE(error->ec == eInvalidArgument);
+    }
+    // the admissions of the failed executions are given back
+    auto [output] = SyncWait(pipeline->Process(Just(input(1))));
+    REQUIRE_FALSE(graph::FindError(output));
+  }
+}
+
+TEST_CASE("test gate admission", "[graph]") {
+  auto gate = std::make_shared<graph::Gate>(1);
+  {
+    graph::Gate::Admission admission(gate);
+    SyncWait(admission.Enter(Value(1)));
+    // torn down without leaving
+  }
+  graph::Gate::Admission admission(gate);
+  auto [value] = SyncWait(admission.Enter(Value(2)));
+  REQUIRE(value.get<int>() == 2);
+  admission.Leave();
+}
+
+TEST_CASE("test pipeline with failing async node", "[graph]") {
+  auto creator = Registry<graph::Node>::Get().GetCreator("Pipeline");
+  REQUIRE(creator);
+  // x -> a, (a, x) -> b
+  Value config{{"pipeline",
+                {{"input", Value::Array{"x"}},
+                 {"output", Value::Array{"b"}},
+                 {"tasks", Value::Array{Value{{"name", "a"},
+                                              {"type", "Task"},
+                                              {"module", "test_fail_async"},
+                                              {"input", Value::Array{"x"}},
+                                              {"output", Value::Array{"a"}}},
+                                        Value{{"name", "b"},
+                                              {"type", "Task"},
+                                              {"module", "test_sum"},
+                                              {"input", Value::Array{"a", "x"}},
+                                              {"output", Value::Array{"b"}}}}}}}};
+  auto pipeline = creator->Create(config);
+  REQUIRE(pipeline);
+  Value input = Value::Array{Value{{"value", 1}}};
+
+  SECTION("the error is passed through the downstream nodes") {
+    auto [output] = SyncWait(pipeline->Process(Just(input)));
+    auto error = graph::FindError(output);
+    REQUIRE(error);
+    REQUIRE(error->ec == eInvalidArgument);
+    REQUIRE_THROWS(graph::ThrowIfError(output));
+  }
+
+  SECTION("the error is reported by the stream") {
+    graph::StreamingPipeline stream(*pipeline, 2);
+    REQUIRE(stream.Push(input));
+    auto output = stream.Pop();
+    REQUIRE(output);
+    REQUIRE(output->has_error());
+    REQUIRE(output->error() == eInvalidArgument);
+  }
+
+  SECTION("the error skips the continuations of the C API") {
+    mmdeploy_pipeline_t handle{};
+    REQUIRE(mmdeploy_pipeline_create((mmdeploy_value_t)&config, "cpu", 0, nullptr, &handle) ==
+            MMDEPLOY_SUCCESS);
+    int count = 0;
+    auto fn = [](mmdeploy_value_t value, void* context) {
+      ++*static_cast<int*>(context);
+      return value;
+    };
+    mmdeploy_sender_t output{};
+    REQUIRE(mmdeploy_pipeline_apply_async(handle, mmdeploy_executor_just((mmdeploy_value_t)&input),
+                                          &output) == MMDEPLOY_SUCCESS);
+    output = mmdeploy_executor_then(output, fn, &count);
+    REQUIRE(output);
+    REQUIRE(mmdeploy_executor_sync_wait_v2(output, nullptr) == MMDEPLOY_E_INVALID_ARG);
+    REQUIRE(count == 0);
+
+    mmdeploy_value_t value{};
+    REQUIRE(mmdeploy_pipeline_apply(handle, (mmdeploy_value_t)&input, &value) ==
+            MMDEPLOY_E_INVALID_ARG);
+    mmdeploy_pipeline_destroy(handle);
+  }
+
+  SECTION("the error is told apart from the end of the stream by the C API") {
+    mmdeploy_pipeline_t handle{};
+    REQUIRE(mmdeploy_pipeline_create((mmdeploy_value_t)&config, "cpu", 0, nullptr, &handle) ==
+            MMDEPLOY_SUCCESS);
+    mmdeploy_pipeline_stream_t stream{};
+    REQUIRE(mmdeploy_pipeline_stream_create(handle, 2, &stream) == MMDEPLOY_SUCCESS);
+    REQUIRE(mmdeploy_pipeline_stream_push(stream, (mmdeploy_value_t)&input) == MMDEPLOY_SUCCESS);
+    REQUIRE(mmdeploy_pipeline_stream_close(stream) == MMDEPLOY_SUCCESS);
+    mmdeploy_value_t output{};
+    int end_of_stream{};
+    REQUIRE(mmdeploy_pipeline_stream_pop(stream, &output, &end_of_stream) ==
+            MMDEPLOY_E_INVALID_ARG);
+    REQUIRE_FALSE(end_of_stream);
+    REQUIRE(mmdeploy_pipeline_stream_pop(stream, &output, &end_of_stream) == MMDEPLOY_SUCCESS);
+    REQUIRE(end_of_stream);
+    REQUIRE_FALSE(output);
+    mmdeploy_pipeline_stream_destroy(stream);
+    mmdeploy_pipeline_destroy(handle);
+  }
+}
+
+TEST_CASE("test pipeline with async node throwing", "[graph]") {
+  auto creator = Registry<graph::Node>::Get().GetCreator("Pipeline");
+  REQUIRE(creator);
+  Value config{{"pipeline",
+                {{"input", Value::Array{"x"}},
+                 {"output", Value::Array{"a"}},
+                 {"tasks", Value::Array{Value{{"name", "a"},
+                                              {"type", "Task"},
+                                              {"module", "test_throw_async"},
+                                              {"input", Value::Array{"x"}},
+                                              {"output", Value::Array{"a"}}}}}}}};
+  auto pipeline = creator->Create(config);
+  REQUIRE(pipeline);
+  Value input = Value::Array{Value{{"value", 1}}};
+  auto [output] = SyncWait(pipeline->Process(Just(input)));
+  auto error = graph::FindError(output);
+  REQUIRE(error);
+  REQUIRE(error->ec == eFail);
+}
+
+TEST_CASE("test pipeline profiling", "[graph]") {
+  auto creator = Registry<graph::Node>::Get().GetCreator("Pipeline");
+  REQUIRE(creator);
+  auto config = CreateDiamondConfig();
+  config["pipeline"]["name"] = "diamond";
+  Profiler profiler(Value::kObject);
+  config["context"]["profiler"] = profiler;
+  auto pipeline = creator->Create(config);
+  REQUIRE(pipeline);
+  Run(*pipeline);
+  Run(*pipeline);
+
+  auto stats = profiler.GetStats();
+  for (const auto& name : {"diamond", "a", "b", "c", "a/wait", "c/batch_size"}) {
+    REQUIRE(stats.contains(name));
+    REQUIRE(stats[name]["count"].get<int>() == 2);
+  }
+  REQUIRE(stats["c/batch_size"]["p50"].get<double>() == 1.);
+  REQUIRE(stats["diamond"]["max"].get<double>() >= stats["c"]["max"].get<double>());
+
+  auto path = fs::temp_directory_path() / "mmdeploy_test_pipeline_trace.json";
+  REQUIRE(profiler.Dump(path.string()));
+  std::ifstream ifs(path);
+  auto trace = nlohmann::json::parse(ifs);
+  // 3 nodes & the pipeline itself for each run
+  REQUIRE(trace["traceEvents"].size() == 8);
+  REQUIRE(trace["traceEvents"][0]["ph"] == "X");
+}
+
+TEST_CASE("test streaming pipeline", "[graph]") {
+  auto creator = Registry<graph::Node>::Get().GetCreator("Pipeline");
+  REQUIRE(creator);
+  Value config{{"pipeline",
+                {{"name", "stream"},
+                 {"input", Value::Array{"x"}},
+                 {"output", Value::Array{"y"}},
+                 {"tasks", Value::Array{Value{{"name", "delay"},
+                                              {"type", "Task"},
+                                              {"module", "test_delay"},
+                                              {"input", Value::Array{"x"}},
+                                              {"output", Value::Array{"y"}}}}}}}};
+  Profiler profiler(Value::kObject);
+  config["context"]["profiler"] = profiler;
+  auto pipeline = creator->Create(config);
+  REQUIRE(pipeline);
+  auto frame = [](int value) -> Value { return Value::Array{Value{{"value", value}}}; };
+
+  SECTION("outputs are in the order of inputs") {
+    graph::StreamingPipeline stream(*pipeline, 4, profiler);
+    constexpr int kFrames = 12;
+    int pushed = 0;
+    std::thread producer([&] {
+      for (int i = 0; i < kFrames; ++i) {
+        pushed += static_cast<bool>(stream.Push(frame(i)));
+      }
+      stream.Close();
+    });
+    for (int i = 0; i < kFrames; ++i) {
+      auto output = stream.Pop();
+      REQUIRE(output);
+      REQUIRE(*output);
+      REQUIRE(output->value()[0]["value"].get<int>() == i * 2);
+    }
+    producer.join();
+    REQUIRE(pushed == kFrames);
+    // the end of the stream
+    REQUIRE_FALSE(stream.Pop());
+    REQUIRE_FALSE(stream.Push(frame(0)));
+
+    auto stats = stream.GetStats();
+    REQUIRE(stats["pushed"].get<int>() == kFrames);
+    REQUIRE(stats["popped"].get<int>() == kFrames);
+    REQUIRE(stats["in_flight"].get<int>() == 0);
+    REQUIRE(stats["fps"].get<double>() > 0);
+    REQUIRE(stats["latency"]["max"].get<double>() >= stats["latency"]["mean"].get<double>());
+    REQUIRE(stats["stages"]["delay"]["count"].get<int>() == kFrames);
+    REQUIRE(stats["stages"]["delay"]["throughput"].get<double>() > 0);
+  }
+
+  SECTION("pushing blocks while the window is full") {
+    graph::StreamingPipeline stream(*pipeline, 2, profiler);
+    REQUIRE(stream.Push(frame(1)));
+    REQUIRE(stream.Push(frame(2)));
+    std::atomic<bool> pushed{false};
+    std::thread producer([&] { pushed = static_cast<bool>(stream.Push(frame(3))); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE_FALSE(pushed);
+    REQUIRE(stream.GetStats()["in_flight"].get<int>() == 2);
+    auto output = stream.Pop();
+    REQUIRE(output);
+    REQUIRE(*output);
+    REQUIRE(output->value()[0]["value"].get<int>() == 2);
+    producer.join();
+    REQUIRE(pushed);
+    for (auto value : {4, 6}) {
+      output = stream.Pop();
+      REQUIRE(output);
+      REQUIRE(*output);
+      REQUIRE(output->value()[0]["value"].get<int>() == value);
+    }
+  }
+
+  SECTION("throughput is counted from the creation of the stream") {
+    // frames processed by the pipeline before the stream is created
+    for (int i = 0; i < 5; ++i) {
+      SyncWait(pipeline->Process(Just(frame(i))));
+    }
+    constexpr int kFrames = 4;
+    graph::StreamingPipeline stream(*pipeline, kFrames, profiler);
+    for (int i = 0; i < kFrames; ++i) {
+      REQUIRE(stream.Push(frame(i)));
+    }
+    stream.Close();
+    while (auto output = stream.Pop()) {
+      REQUIRE(*output);
+    }
+    auto stats = stream.GetStats();
+    auto elapsed = stats["elapsed"].get<double>();
+    REQUIRE(stats["stages"]["delay"]["count"].get<int>() == 5 + kFrames);
+    REQUIRE(stats["stages"]["delay"]["throughput"].get<double>() * elapsed ==
+            Approx(kFrames).epsilon(0.05));
+  }
+}
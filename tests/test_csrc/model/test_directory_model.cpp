@@ -3,6 +3,8 @@
 // clang-format off
 #include "catch.hpp"
 // clang-format on
+#include <fstream>
+
 #include "mmdeploy/core/model.h"
 #include "mmdeploy/core/model_impl.h"
 #include "test_resource.h"
@@ -28,6 +30,9 @@ TEST_CASE("test directory model", "[.model][resource]") {
   REQUIRE(!model_impl->Init(model_path.string()).has_error());
   REQUIRE(!model_impl->ReadFile("deploy.json").has_error());
   REQUIRE(model_impl->ReadFile("not-existing-file").has_error());
+  REQUIRE(model_impl->MapFile("deploy.json").value().str() ==
+          model_impl->ReadFile("deploy.json").value());
+  REQUIRE(model_impl->MapFile("not-existing-file").has_error());
 
   model_dir = "sdk_models/bad_model";
   REQUIRE(gResource.IsDir(model_dir));
@@ -35,3 +40,27 @@ TEST_CASE("test directory model", "[.model][resource]") {
   REQUIRE(!model_impl->Init(model_path.string()).has_error());
   REQUIRE(model_impl->ReadMeta().has_error());
 }
+
+TEST_CASE("test directory model file mapping", "[model]") {
+  auto model_dir = fs::temp_directory_path() / "mmdeploy_test_directory_model";
+  fs::create_directories(model_dir);
+  std::string weights(1 << 20, '\0');
+  for (size_t i = 0; i < weights.size(); ++i) {
+    weights[i] = static_cast<char>(i * 31);
+  }
+  std::ofstream(model_dir / "deploy.json") << R"({"version": "0.7.0", "models": []})";
+  std::ofstream(model_dir / "end2end.bin", std::ios::binary) << weights;
+  std::ofstream(model_dir / "empty.bin", std::ios::binary).close();
+
+  Model model(model_dir.string());
+  auto view = model.MapFile("end2end.bin").value();
+  REQUIRE(view.size() == weights.size());
+  REQUIRE(view.str() == weights);
+  // slices share the mapping, which outlives the view they are taken from
+  auto slice = view.Slice(1000, 24);
+  view = {};
+  REQUIRE(slice.str() == weights.substr(1000, 24));
+
+  REQUIRE(model.MapFile("empty.bin").value().empty());
+  REQUIRE(model.MapFile("not-existing-file").has_error());
+}
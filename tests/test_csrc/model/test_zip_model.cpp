@@ -44,6 +44,9 @@ TEST_CASE("test zip model", "[zip_model]") {
     REQUIRE(!model_impl->ReadFile("deploy.json").has_error());
     REQUIRE(model_impl->ReadFile("not-exist-file").has_error());
     REQUIRE(!model_impl->ReadMeta().has_error());
+    REQUIRE(model_impl->MapFile("deploy.json").value().str() ==
+            model_impl->ReadFile("deploy.json").value());
+    REQUIRE(model_impl->MapFile("not-exist-file").has_error());
 
     ifstream ifs(model_path, std::ios::binary | std::ios::in);
     REQUIRE(ifs.is_open());
@@ -0,0 +1,598 @@
+// Copyright (c) OpenMMLab. All rights reserved.
+
+// clang-format off
+#include "catch.hpp"
+// clang-format on
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "mmdeploy/core/graph.h"
+#include "mmdeploy/core/model.h"
+#include "mmdeploy/core/module.h"
+#include "mmdeploy/core/net.h"
+#include "mmdeploy/core/net_cache.h"
+#include "mmdeploy/core/profiler.h"
+#include "mmdeploy/core/utils/filesystem.h"
+
+using namespace mmdeploy;
+
+namespace {
+
+// copies its only input to its only output
+class IdentityNet : public Net {
+ public:
+  Result<void> Init(const Value& args) override {
+    auto device = args["context"]["device"].get<Device>();
+    stream_ = args["context"]["stream"].get<Stream>();
+    input_tensors_.emplace_back(TensorDesc{device, DataType::kFLOAT, {}, "input"});
+    output_tensors_.emplace_back(TensorDesc{device, DataType::kFLOAT, {}, "output"});
+    return success();
+  }
+  Result<void> Deinit() override { return success(); }
+  Result<Span<Tensor>> GetInputTensors() override { return input_tensors_; }
+  Result<Span<Tensor>> GetOutputTensors() override { return output_tensors_; }
+  Result<void> Reshape(Span<TensorShape> input_shapes) override {
+    input_tensors_[0].Reshape(input_shapes[0]);
+    output_tensors_[0].Reshape(input_shapes[0]);
+    return success();
+  }
+  Result<void> Forward() override {
+    return output_tensors_[0].CopyFrom(input_tensors_[0], stream_);
+  }
+
+ protected:
+  Stream stream_;
+  std::vector<Tensor> input_tensors_;
+  std::vector<Tensor> output_tensors_;
+};
+
+class IdentityNetCreator : public Creator<Net> {
+ public:
+  const char* GetName() const override { return "test_identity"; }
+  int GetVersion() const override { return 0; }
+  std::unique_ptr<Net> Create(const Value& args) override {
+    auto net = std::make_unique<IdentityNet>();
+    net->Init(args).value();
+    return net;
+  }
+};
+
+REGISTER_MODULE(Net, IdentityNetCreator);
+
+// hands the bound input out as its output, a fresh output buffer is created otherwise
+class ZeroCopyIdentityNet : public IdentityNet {
+ public:
+  Result<void> BindInputs(Span<Tensor> inputs) override {
+    bound_input_ = inputs[0];
+    return success();
+  }
+  Result<std::vector<Tensor>> TakeOutputs() override { return output_tensors_; }
+  Result<void> Forward() override {
+    auto desc = output_tensors_[0].desc();
+    if (bound_input_) {
+      output_tensors_[0] = Tensor(desc, bound_input_->buffer());
+      bound_input_.reset();
+      return success();
+    }
+    output_tensors_[0] = Tensor(desc);
+    return output_tensors_[0].CopyFrom(input_tensors_[0]);
+  }
+
+ private:
+  std::optional<Tensor> bound_input_;
+};
+
+class ZeroCopyIdentityNetCreator : public Creator<Net> {
+ public:
+  const char* GetName() const override { return "test_zero_copy_identity"; }
+  int GetVersion() const override { return 0; }
+  std::unique_ptr<Net> Create(const Value& args) override {
+    auto net = std::make_unique<ZeroCopyIdentityNet>();
+    net->Init(args).value();
+    return net;
+  }
+};
+
+REGISTER_MODULE(Net, ZeroCopyIdentityNetCreator);
+
+// lets the threads go in groups of `count`, so that they are known to run at the same time
+class Rendezvous {
+ public:
+  void Reset(int count) {
+    std::lock_guard lock{mutex_};
+    count_ = count;
+    arrived_ = 0;
+  }
+
+  // false if the group is not complete in time
+  bool Arrive() {
+    std::unique_lock lock{mutex_};
+    auto generation = generation_;
+    if (++arrived_ >= count_) {
+      arrived_ = 0;
+      ++generation_;
+      cv_.notify_all();
+      return true;
+    }
+    return cv_.wait_for(lock, std::chrono::seconds(5), [&] { return generation_ != generation; });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  int count_{1};
+  int arrived_{};
+  int generation_{};
+};
+
+// forwards on a new thread, the thread doesn't touch the net after `done`
+class AsyncIdentityNet : public IdentityNet {
+ public:
+  Result<void> ForwardAsync(std::function<void(Result<void>)> done) override {
+    std::thread([this, done = std::move(done)] {
+      // the net would be corrupted by overlapping forwards
+      if (running_.exchange(true)) {
+        overlapped = true;
+      }
+      auto n = ++concurrency;
+      auto m = max_concurrency.load();
+      while (m < n && !max_concurrency.compare_exchange_weak(m, n)) {
+      }
+      if (!rendezvous.Arrive()) {
+        missed = true;
+      }
+      --concurrency;
+      running_ = false;
+      done(Forward());
+    }).detach();
+    return success();
+  }
+
+  Result<std::unique_ptr<Net>> CreateExecutionContext(Stream stream) override {
+    auto net = std::make_unique<AsyncIdentityNet>();
+    net->stream_ = std::move(stream);
+    net->input_tensors_.emplace_back(input_tensors_[0].desc());
+    net->output_tensors_.emplace_back(output_tensors_[0].desc());
+    ++contexts_created;
+    return net;
+  }
+
+  static inline std::atomic_bool overlapped{false};
+  static inline std::atomic_int concurrency{0};
+  static inline std::atomic_int max_concurrency{0};
+  static inline std::atomic_int contexts_created{0};
+  static inline Rendezvous rendezvous;
+  static inline std::atomic_bool missed{false};
+
+ private:
+  std::atomic_bool running_{false};
+};
+
+class AsyncIdentityNetCreator : public Creator<Net> {
+ public:
+  const char* GetName() const override { return "test_async_identity"; }
+  int GetVersion() const override { return 0; }
+  std::unique_ptr<Net> Create(const Value& args) override {
+    auto net = std::make_unique<AsyncIdentityNet>();
+    net->Init(args).value();
+    ++loaded;
+    return net;
+  }
+  static inline std::atomic_int loaded{0};
+};
+
+REGISTER_MODULE(Net, AsyncIdentityNetCreator);
+
+Model CreateIdentityModel() {
+  auto path = fs::temp_directory_path() / "mmdeploy_test_net_module";
+  fs::create_directories(path);
+  std::ofstream ofs(path / "deploy.json");
+  ofs << R"({"version": "0.7.0", "models": [{"name": "identity", "net": "", "weights": "",
+             "backend": "test_identity", "batch_size": 1, "precision": "FP32",
+             "dynamic_shape": true},
+            {"name": "zero_copy_identity", "net": "", "weights": "",
+             "backend": "test_zero_copy_identity", "batch_size": 1, "precision": "FP32",
+             "dynamic_shape": true},
+            {"name": "async_identity", "net": "", "weights": "",
+             "backend": "test_async_identity", "batch_size": 1, "precision": "FP32",
+             "dynamic_shape": true}]})";
+  ofs.close();
+  return Model(path.string());
+}
+
+// a model whose pipeline configures its net with backend options & options of the modules composed
+// of the net module
+Model CreateIdentityPipelineModel() {
+  auto path = fs::temp_directory_path() / "mmdeploy_test_net_cache";
+  fs::create_directories(path);
+  std::ofstream(path / "deploy.json") << R"({"version": "0.7.0", "models": [
+      {"name": "async_identity", "net": "", "weights": "", "backend": "test_async_identity",
+       "batch_size": 1, "precision": "FP32", "dynamic_shape": true}]})";
+  std::ofstream(path / "pipeline.json") << R"({"pipeline": {
+      "input": ["img"], "output": ["out"],
+      "tasks": [{"name": "async_identity", "type": "Task", "module": "Net",
+                 "input": ["img"], "output": ["out"], "input_map": {"img": "input"},
+                 "use_vulkan": false, "tile_size": 64, "tile_overlap": 8, "batch_size": 2,
+                 "crop_size": [32, 32], "stride": [16, 16], "num_classes": 2,
+                 "max_in_flight": 2, "net": "Net"}]}})";
+  return Model(path.string());
+}
+
+Tensor CreateTensor(const TensorShape& shape, float offset) {
+  Tensor tensor(TensorDesc{Device{"cpu"}, DataType::kFLOAT, shape, ""});
+  auto data = tensor.data<float>();
+  for (int64_t i = 0; i < tensor.size(); ++i) {
+    data[i] = offset + static_cast<float>(i);
+  }
+  return tensor;
+}
+
+bool IsEqual(const Tensor& a, const Tensor& b) {
+  return a.shape() == b.shape() &&
+         std::equal(a.data<float>(), a.data<float>() + a.size(), b.data<float>());
+}
+
+}  // namespace
+
+TEST_CASE("test net module batch padding", "[net]") {
+  auto model = CreateIdentityModel();
+  REQUIRE(model);
+  auto creator = Registry<Module>::Get().GetCreator("Net");
+  REQUIRE(creator);
+  Value config{{"name", "identity"},
+               {"context", {{"device", Device{"cpu"}}, {"model", model}}},
+               {"input_map", {{"img", "input"}}}};
+
+  auto a = CreateTensor({1, 3, 20, 30}, 0);
+  auto b = CreateTensor({1, 3, 40, 10}, 1000);
+  Value batch = Value::Array{Value{{"img", a}}, Value{{"img", b}}};
+
+  SECTION("reject inconsistent shapes without padding") {
+    auto net = creator->Create(config);
+    REQUIRE(net);
+    REQUIRE(net->Process(Value::Array{batch}).has_error());
+  }
+
+  SECTION("pad to size divisor") {
+    config["batch_padding"] = {{"size_divisor", 32}, {"crop_outputs", Value::Array{"output"}}};
+    auto net = creator->Create(config);
+    REQUIRE(net);
+    auto output = net->Process(Value::Array{batch}).value()[0];
+    REQUIRE(Stream::GetDefault(Device{"cpu"}).Wait());
+    REQUIRE(output.size() == 2);
+    REQUIRE(IsEqual(output[0]["output"].get<Tensor>(), a));
+    REQUIRE(IsEqual(output[1]["output"].get<Tensor>(), b));
+    REQUIRE(output[1]["valid_shape"]["img"][2].get<int>() == 40);
+  }
+
+  SECTION("pad to fixed buckets") {
+    config["batch_padding"] = {
+        {"shapes", Value::Array{Value::Array{64, 64}, Value::Array{48, 32}}}};
+    auto net = creator->Create(config);
+    REQUIRE(net);
+    auto output = net->Process(Value::Array{batch}).value()[0];
+    REQUIRE(Stream::GetDefault(Device{"cpu"}).Wait());
+    auto padded = output[0]["output"].get<Tensor>();
+    REQUIRE(padded.shape() == TensorShape{1, 3, 48, 32});
+    // padded region is zero-filled
+    REQUIRE(padded.data<float>()[30] == 0.f);
+    REQUIRE(padded.data<float>()[32 + 1] == 31.f);
+    REQUIRE(padded.data<float>()[20 * 32] == 0.f);
+  }
+}
+
+TEST_CASE("test net module zero-copy binding", "[net]") {
+  auto model = CreateIdentityModel();
+  REQUIRE(model);
+  auto creator = Registry<Module>::Get().GetCreator("Net");
+  REQUIRE(creator);
+  Value config{{"name", "zero_copy_identity"},
+               {"context", {{"device", Device{"cpu"}}, {"model", model}}},
+               {"input_map", {{"img", "input"}}}};
+  auto net = creator->Create(config);
+  REQUIRE(net);
+
+  auto a = CreateTensor({1, 3, 20, 30}, 0);
+  auto b = CreateTensor({1, 3, 20, 30}, 1000);
+
+  SECTION("single sample is neither copied in nor out") {
+    Value batch = Value::Array{Value{{"img", a}}};
+    auto output = net->Process(Value::Array{batch}).value()[0];
+    REQUIRE(Stream::GetDefault(Device{"cpu"}).Wait());
+    auto tensor = output[0]["output"].get<Tensor>();
+    REQUIRE(tensor.data<float>() == a.data<float>());
+    REQUIRE(std::string(tensor.name()) == "output");
+  }
+
+  SECTION("batched samples are copied in and sliced out") {
+    Value batch = Value::Array{Value{{"img", a}}, Value{{"img", b}}};
+    auto output = net->Process(Value::Array{batch}).value()[0];
+    REQUIRE(Stream::GetDefault(Device{"cpu"}).Wait());
+    REQUIRE(output.size() == 2);
+    REQUIRE(IsEqual(output[0]["output"].get<Tensor>(), a));
+    REQUIRE(IsEqual(output[1]["output"].get<Tensor>(), b));
+    REQUIRE(output[1]["output"].get<Tensor>().data<float>() != b.data<float>());
+  }
+}
+
+TEST_CASE("test net module output buffers", "[net]") {
+  auto model = CreateIdentityModel();
+  REQUIRE(model);
+  auto creator = Registry<Module>::Get().GetCreator("Net");
+  REQUIRE(creator);
+  Profiler profiler(Value::kObject);
+  Value config{{"name", "identity"},
+               {"context", {{"device", Device{"cpu"}}, {"model", model}, {"profiler", profiler}}},
+               {"input_map", {{"img", "input"}}}};
+  auto a = CreateTensor({1, 3, 20, 30}, 0);
+  auto b = CreateTensor({1, 3, 20, 30}, 1000);
+  auto forward = [&](Module& net, const Tensor& input) {
+    Value batch = Value::Array{Value{{"img", input}}};
+    auto output = net.Process(Value::Array{batch}).value()[0];
+    REQUIRE(Stream::GetDefault(Device{"cpu"}).Wait());
+    return output[0]["output"].get<Tensor>();
+  };
+  auto bytes_allocated = [&] { return profiler.GetStats()["identity/bytes_allocated"]["sum"]; };
+
+  SECTION("released outputs are reused") {
+    auto net = creator->Create(config);
+    REQUIRE(net);
+    const void* data = forward(*net, a).data();
+    auto output = forward(*net, b);
+    REQUIRE(output.data() == data);
+    REQUIRE(IsEqual(output, b));
+    REQUIRE(bytes_allocated().get<int>() == a.byte_size());
+  }
+
+  SECTION("outputs in use are not overwritten") {
+    auto net = creator->Create(config);
+    REQUIRE(net);
+    auto output_a = forward(*net, a);
+    auto output_b = forward(*net, b);
+    REQUIRE(output_a.data() != output_b.data());
+    REQUIRE(IsEqual(output_a, a));
+    REQUIRE(bytes_allocated().get<int>() == 2 * a.byte_size());
+  }
+
+  SECTION("disabled") {
+    config["output_buffers"] = 0;
+    auto net = creator->Create(config);
+    REQUIRE(net);
+    forward(*net, a);
+    forward(*net, b);
+    REQUIRE(bytes_allocated().get<int>() == 2 * a.byte_size());
+  }
+}
+
+TEST_CASE("test net module async forward", "[net]") {
+  auto model = CreateIdentityModel();
+  REQUIRE(model);
+  auto creator = Registry<Module>::Get().GetCreator("Net");
+  REQUIRE(creator);
+  Value config{{"name", "async_identity"},
+               {"context", {{"device", Device{"cpu"}}, {"model", model}}},
+               {"input_map", {{"img", "input"}}}};
+  auto caller = std::this_thread::get_id();
+
+  SECTION("forwards are queued and completed on the backend") {
+    auto net = creator->Create(config);
+    REQUIRE(net);
+    constexpr int kRequests = 4;
+    std::vector<Tensor> inputs;
+    std::vector<Value> outputs(kRequests);
+    std::vector<std::thread::id> threads(kRequests);
+    std::mutex mutex;
+    std::condition_variable cv;
+    int completed = 0;
+    for (int i = 0; i < kRequests; ++i) {
+      inputs.push_back(CreateTensor({1, 3, 8, 8}, 100.f * i));
+      net->ProcessAsync(Value::Array{Value{{"img", inputs[i]}}}, [&, i](Result<Value> output) {
+        std::lock_guard lock{mutex};
+        outputs[i] = std::move(output).value();
+        threads[i] = std::this_thread::get_id();
+        ++completed;
+        cv.notify_one();
+      });
+    }
+    std::unique_lock lock{mutex};
+    cv.wait(lock, [&] { return completed == kRequests; });
+    REQUIRE(Stream::GetDefault(Device{"cpu"}).Wait());
+    for (int i = 0; i < kRequests; ++i) {
+      REQUIRE(IsEqual(outputs[i][0]["output"].get<Tensor>(), inputs[i]));
+      REQUIRE(threads[i] != caller);
+    }
+    REQUIRE_FALSE(AsyncIdentityNet::overlapped);
+  }
+
+  SECTION("forwards run concurrently on execution contexts sharing the model") {
+    config["num_contexts"] = 2;
+    AsyncIdentityNet::contexts_created = 0;
+    AsyncIdentityNet::max_concurrency = 0;
+    AsyncIdentityNet::missed = false;
+    AsyncIdentityNet::rendezvous.Reset(2);
+    auto net = creator->Create(config);
+    REQUIRE(net);
+    REQUIRE(AsyncIdentityNet::contexts_created == 2);
+    constexpr int kRequests = 6;
+    std::vector<Tensor> inputs;
+    std::vector<Value> outputs(kRequests);
+    std::mutex mutex;
+    std::condition_variable cv;
+    int completed = 0;
+    for (int i = 0; i < kRequests; ++i) {
+      inputs.push_back(CreateTensor({1, 3, 8, 8}, 100.f * i));
+      net->ProcessAsync(Value::Array{Value{{"img", inputs[i]}}}, [&, i](Result<Value> output) {
+        std::lock_guard lock{mutex};
+        outputs[i] = std::move(output).value();
+        ++completed;
+        cv.notify_one();
+      });
+    }
+    {
+      std::unique_lock lock{mutex};
+      cv.wait(lock, [&] { return completed == kRequests; });
+    }
+    REQUIRE(Stream::GetDefault(Device{"cpu"}).Wait());
+    for (int i = 0; i < kRequests; ++i) {
+      REQUIRE(IsEqual(outputs[i][0]["output"].get<Tensor>(), inputs[i]));
+    }
+    REQUIRE_FALSE(AsyncIdentityNet::missed);
+    REQUIRE(AsyncIdentityNet::max_concurrency == 2);
+    REQUIRE_FALSE(AsyncIdentityNet::overlapped);
+    AsyncIdentityNet::rendezvous.Reset(1);
+    // synchronous forwards wait for a free context
+    auto a = CreateTensor({1, 3, 8, 8}, 0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; ++i) {
+      threads.emplace_back([&] {
+        auto output = net->Process(Value::Array{Value::Array{Value{{"img", a}}}}).value();
+        std::lock_guard lock{mutex};
+        outputs[0] = std::move(output);
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    REQUIRE(Stream::GetDefault(Device{"cpu"}).Wait());
+    REQUIRE(IsEqual(outputs[0][0][0]["output"].get<Tensor>(), a));
+  }
+
+  SECTION("independent instances for backends that can't share the model") {
+    config["name"] = "identity";
+    config["num_contexts"] = 2;
+    auto net = creator->Create(config);
+    REQUIRE(net);
+    auto a = CreateTensor({1, 3, 8, 8}, 0);
+    auto output = net->Process(Value::Array{Value::Array{Value{{"img", a}}}}).value();
+    REQUIRE(Stream::GetDefault(Device{"cpu"}).Wait());
+    REQUIRE(IsEqual(output[0][0]["output"].get<Tensor>(), a));
+  }
+
+  SECTION("backends without async forward complete on the calling thread") {
+    config["name"] = "identity";
+    auto net = creator->Create(config);
+    REQUIRE(net);
+    auto a = CreateTensor({1, 3, 8, 8}, 0);
+    Value output;
+    std::optional<std::thread::id> thread;
+    net->ProcessAsync(Value::Array{Value{{"img", a}}}, [&](Result<Value> r) {
+      output = std::move(r).value();
+      thread = std::this_thread::get_id();
+    });
+    REQUIRE(thread == caller);
+    REQUIRE(Stream::GetDefault(Device{"cpu"}).Wait());
+    REQUIRE(IsEqual(output[0]["output"].get<Tensor>(), a));
+  }
+
+  SECTION("task completed by the backend") {
+    config["type"] = "Task";
+    config["module"] = "Net";
+    config["input"] = Value::Array{"x"};
+    config["output"] = Value::Array{"y"};
+    auto task = Registry<graph::Node>::Get().GetCreator("Task")->Create(config);
+    REQUIRE(task);
+    auto a = CreateTensor({1, 3, 8, 8}, 0);
+    auto [output] = SyncWait(task->Process(Just(Value(Value::Array{Value{{"img", a}}}))));
+    REQUIRE(Stream::GetDefault(Device{"cpu"}).Wait());
+    REQUIRE(IsEqual(output[0]["output"].get<Tensor>(), a));
+  }
+}
+
+TEST_CASE("test net cache", "[net]") {
+  auto model = CreateIdentityModel();
+  REQUIRE(model);
+  auto creator = Registry<Module>::Get().GetCreator("Net");
+  REQUIRE(creator);
+  Value config{{"name", "async_identity"},
+               {"context", {{"device", Device{"cpu"}}, {"model", model}}},
+               {"input_map", {{"img", "input"}}}};
+  auto& cache = NetCache::Get();
+  auto size = cache.size();
+  AsyncIdentityNetCreator::loaded = 0;
+  AsyncIdentityNet::contexts_created = 0;
+
+  SECTION("modules of the same model share the net") {
+    auto net0 = creator->Create(config);
+    // a model loaded again from the same path is the same model
+    config["context"]["model"] = CreateIdentityModel();
+    auto net1 = creator->Create(config);
+    REQUIRE(net0);
+    REQUIRE(net1);
+    REQUIRE(AsyncIdentityNetCreator::loaded == 1);
+    REQUIRE(AsyncIdentityNet::contexts_created == 2);
+    REQUIRE(cache.size() == size + 1);
+    auto a = CreateTensor({1, 3, 8, 8}, 0);
+    auto output = net1->Process(Value::Array{Value::Array{Value{{"img", a}}}}).value();
+    REQUIRE(Stream::GetDefault(Device{"cpu"}).Wait());
+    REQUIRE(IsEqual(output[0][0]["output"].get<Tensor>(), a));
+    // released with the last user
+    net0.reset();
+    REQUIRE(cache.size() == size + 1);
+    net1.reset();
+    REQUIRE(cache.size() == size);
+    REQUIRE(creator->Create(config));
+    REQUIRE(AsyncIdentityNetCreator::loaded == 2);
+  }
+
+  SECTION("nets of different backend options are not shared") {
+    auto net0 = creator->Create(config);
+    // options of the net module & the modules composed of it don't matter
+    config["num_contexts"] = 1;
+    config["tile_size"] = 64;
+    auto net1 = creator->Create(config);
+    config["intra_op_num_threads"] = 2;
+    auto net2 = creator->Create(config);
+    REQUIRE(net0);
+    REQUIRE(net1);
+    REQUIRE(net2);
+    REQUIRE(AsyncIdentityNetCreator::loaded == 2);
+    REQUIRE(cache.size() == size + 2);
+    net2.reset();
+    REQUIRE(cache.size() == size + 1);
+  }
+
+  SECTION("warmed up nets are kept until evicted") {
+    REQUIRE(cache.Warmup(model, Device{"cpu"}));
+    REQUIRE(AsyncIdentityNetCreator::loaded == 1);
+    REQUIRE(creator->Create(config));
+    REQUIRE(creator->Create(config));
+    REQUIRE(AsyncIdentityNetCreator::loaded == 1);
+    REQUIRE(AsyncIdentityNet::contexts_created == 2);
+    cache.Evict(model);
+    REQUIRE(cache.size() == size);
+    REQUIRE(creator->Create(config));
+    REQUIRE(AsyncIdentityNetCreator::loaded == 2);
+  }
+
+  SECTION("warmed up nets are configured by the pipeline of the model") {
+    auto pipeline_model = CreateIdentityPipelineModel();
+    REQUIRE(pipeline_model);
+    REQUIRE(cache.Warmup(pipeline_model, Device{"cpu"}));
+    REQUIRE(cache.size() == size + 1);
+    Value inference_config{
+        {"type", "Inference"},
+        {"params", {{"model", pipeline_model}}},
+        {"input", Value::Array{"img"}},
+        {"output", Value::Array{"out"}},
+        {"context", {{"device", Device{"cpu"}}, {"stream", Stream::GetDefault(Device{"cpu"})}}}};
+    auto inference = Registry<graph::Node>::Get().GetCreator("Inference")->Create(inference_config);
+    REQUIRE(inference);
+    REQUIRE(AsyncIdentityNetCreator::loaded == 1);
+    REQUIRE(cache.size() == size + 1);
+    cache.Evict(pipeline_model);
+  }
+
+  SECTION("backends that can't share the model bypass the cache") {
+    config["name"] = "identity";
+    auto net0 = creator->Create(config);
+    auto net1 = creator->Create(config);
+    REQUIRE(net0);
+    REQUIRE(net1);
+    REQUIRE(cache.size() == size);
+  }
+}
@@ -99,3 +99,105 @@ TEST_CASE("transform Compose", "[compose]") {
   auto res = transform->Process({{"ori_img", src_mat}});
   REQUIRE(!res.has_error());
 }
+
+TEST_CASE("transform Compose with fused transforms", "[compose]") {
+  auto gResource = MMDeployTestResources::Get();
+  auto img_list = gResource.LocateImageResources("transform");
+  REQUIRE(!img_list.empty());
+
+  cv::Mat bgr_mat = cv::imread(img_list.front(), cv::IMREAD_COLOR);
+  auto src_mat = cpu::CVMat2Mat(bgr_mat, PixelFormat::kBGR);
+
+  Value normalize{{"type", "Normalize"},
+                  {"mean", Value::Array{123.675, 116.28, 103.53}},
+                  {"std", Value::Array{58.395, 57.12, 57.375}},
+                  {"to_rgb", true}};
+  Value load{{"type", "LoadImageFromFile"}};
+  Value cfg;
+  SECTION("Normalize, Pad & DefaultFormatBundle") {
+    cfg = Value::Array{
+        load,
+        Value{{"type", "Resize"}, {"size", Value::Array{800, 1333}}, {"keep_ratio", true}},
+        normalize,
+        Value{{"type", "Pad"}, {"size_divisor", 32}},
+        Value{{"type", "DefaultFormatBundle"}}};
+  }
+  SECTION("Normalize & ImageToTensor") {
+    normalize["to_rgb"] = false;
+    cfg = Value::Array{load,
+                       Value{{"type", "Resize"}, {"size", Value::Array{224, 224}}},
+                       normalize,
+                       Value{{"type", "ImageToTensor"}, {"keys", Value::Array{"img"}}}};
+  }
+
+  const Device kHost{"cpu"};
+  Stream stream{kHost};
+  Value compose_cfg{{"type", "Compose"}, {"transforms", cfg}};
+  auto fused = CreateTransform(compose_cfg, kHost, stream);
+  REQUIRE(fused != nullptr);
+  compose_cfg["fuse_transform"] = false;
+  auto separate = CreateTransform(compose_cfg, kHost, stream);
+  REQUIRE(separate != nullptr);
+
+  auto res_fused = fused->Process({{"ori_img", src_mat}}).value();
+  auto res_separate = separate->Process({{"ori_img", src_mat}}).value();
+
+  auto img_fused = res_fused["img"].get<Tensor>();
+  auto img_separate = res_separate["img"].get<Tensor>();
+  REQUIRE(img_fused.shape() == img_separate.shape());
+  REQUIRE(std::equal(img_fused.data<float>(), img_fused.data<float>() + img_fused.size(),
+                     img_separate.data<float>()));
+  for (auto key : {"img_norm_cfg", "pad_shape", "pad_fixed_size", "pad_size_divisor",
+                   "scale_factor", "img_shape"}) {
+    REQUIRE(res_fused.contains(key) == res_separate.contains(key));
+    if (res_fused.contains(key)) {
+      REQUIRE(to_json(res_fused[key]) == to_json(res_separate[key]));
+    }
+  }
+}
+
+TEST_CASE("transform Compose with uint8 output", "[compose]") {
+  auto gResource = MMDeployTestResources::Get();
+  auto img_list = gResource.LocateImageResources("transform");
+  REQUIRE(!img_list.empty());
+
+  cv::Mat bgr_mat = cv::imread(img_list.front(), cv::IMREAD_COLOR);
+  auto src_mat = cpu::CVMat2Mat(bgr_mat, PixelFormat::kBGR);
+
+  auto cfg = Value::Array{Value{{"type", "LoadImageFromFile"}},
+                          Value{{"type", "Resize"}, {"size", Value::Array{224, 224}}},
+                          Value{{"type", "Normalize"},
+                                {"mean", Value::Array{123.675, 116.28, 103.53}},
+                                {"std", Value::Array{58.395, 57.12, 57.375}},
+                                {"to_rgb", true}},
+                          Value{{"type", "ImageToTensor"}, {"keys", Value::Array{"img"}}}};
+  Value compose_cfg{{"type", "Compose"}, {"transforms", cfg}, {"to_float", false}};
+
+  const Device kHost{"cpu"};
+  Stream stream{kHost};
+  SECTION("NCHW") {
+    auto transform = CreateTransform(compose_cfg, kHost, stream);
+    REQUIRE(transform != nullptr);
+    auto res = transform->Process({{"ori_img", src_mat}}).value();
+    auto img = res["img"].get<Tensor>();
+    REQUIRE(img.data_type() == DataType::kINT8);
+    REQUIRE(img.shape() == TensorShape{1, 3, 224, 224});
+    REQUIRE_FALSE(res["img_norm_cfg"]["to_float"].get<bool>());
+  }
+
+  SECTION("NHWC") {
+    compose_cfg["channels_last"] = true;
+    auto transform = CreateTransform(compose_cfg, kHost, stream);
+    REQUIRE(transform != nullptr);
+    auto res = transform->Process({{"ori_img", src_mat}}).value();
+    auto img = res["img"].get<Tensor>();
+    REQUIRE(img.data_type() == DataType::kINT8);
+    REQUIRE(img.shape() == TensorShape{1, 224, 224, 3});
+    // converted to RGB without normalization
+    compose_cfg["transforms"][2]["to_rgb"] = false;
+    auto bgr = CreateTransform(compose_cfg, kHost, stream)->Process({{"ori_img", src_mat}});
+    auto bgr_img = bgr.value()["img"].get<Tensor>();
+    REQUIRE(img.data<uint8_t>()[0] == bgr_img.data<uint8_t>()[2]);
+    REQUIRE(img.data<uint8_t>()[2] == bgr_img.data<uint8_t>()[0]);
+  }
+}